@@ -0,0 +1,184 @@
+#include "BSphereCollection.h"
+#include "CollisionVolumeBSphere.h"
+#include <algorithm>
+#include <cassert>
+
+void BSphereCollection::clear()
+{
+	_centersX.clear();
+	_centersY.clear();
+	_centersZ.clear();
+	_radii.clear();
+	_collidables.clear();
+	_lastActiveFrames.clear();
+	_staticStates.clear();
+	_restingStates.clear();
+}
+
+void BSphereCollection::reserve(size_t size)
+{
+	_centersX.reserve(size);
+	_centersY.reserve(size);
+	_centersZ.reserve(size);
+	_radii.reserve(size);
+	_collidables.reserve(size);
+	_lastActiveFrames.reserve(size);
+	_staticStates.reserve(size);
+	_restingStates.reserve(size);
+}
+
+int BSphereCollection::add(const CollisionVolumeBSphere& BSphere, Collidable* pCollidable)
+{
+	_centersX.push_back(0.0f);
+	_centersY.push_back(0.0f);
+	_centersZ.push_back(0.0f);
+	_radii.push_back(0.0f);
+	_collidables.push_back(pCollidable);
+	_lastActiveFrames.push_back(0);
+	_staticStates.push_back(false);
+	_restingStates.push_back(false);
+
+	const int index = static_cast<int>(_collidables.size()) - 1;
+	set(index, BSphere);
+	return index;
+}
+
+void BSphereCollection::set(int index, const CollisionVolumeBSphere& BSphere)
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _collidables.size());
+	const Vect& center = BSphere.getCenter();
+
+	_centersX[index] = center[x];
+	_centersY[index] = center[y];
+	_centersZ[index] = center[z];
+	_radii[index] = BSphere.getRadius();
+}
+
+Collidable* BSphereCollection::removeAt(int index)
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _collidables.size());
+	const size_t last = _collidables.size() - 1;
+
+	_centersX[index] = _centersX[last];
+	_centersY[index] = _centersY[last];
+	_centersZ[index] = _centersZ[last];
+	_radii[index] = _radii[last];
+	_collidables[index] = _collidables[last];
+	_lastActiveFrames[index] = _lastActiveFrames[last];
+	_staticStates[index] = _staticStates[last];
+	_restingStates[index] = _restingStates[last];
+
+	_centersX.pop_back();
+	_centersY.pop_back();
+	_centersZ.pop_back();
+	_radii.pop_back();
+	_collidables.pop_back();
+	_lastActiveFrames.pop_back();
+	_staticStates.pop_back();
+	_restingStates.pop_back();
+
+	return static_cast<size_t>(index) < last ? _collidables[index] : nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Resting
+//-----------------------------------------------------------------------------------------------------------------------------
+void BSphereCollection::setActivity(int index, FrameCount lastActiveFrame, bool isStatic)
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _collidables.size());
+	_lastActiveFrames[index] = lastActiveFrame;
+	_staticStates[index] = isStatic;
+}
+
+int BSphereCollection::updateRestingStates(FrameCount currentFrame, FrameCount sleepFrameCount, FrameCount& nextSleepFrame)
+{
+	const size_t count = _collidables.size();
+	int numberOfAwake = 0;
+	bool hasSleepFrame = false;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const bool isAsleep = currentFrame - _lastActiveFrames[i] > sleepFrameCount;
+		_restingStates[i] = _staticStates[i] | isAsleep;
+
+		if (!_restingStates[i])
+		{
+			const FrameCount sleepFrame = _lastActiveFrames[i] + sleepFrameCount + 1;
+			nextSleepFrame = hasSleepFrame ? std::min(nextSleepFrame, sleepFrame) : sleepFrame;
+			hasSleepFrame = true;
+			numberOfAwake++;
+		}
+	}
+
+	return numberOfAwake;
+}
+
+bool BSphereCollection::isAtRestAt(int index) const
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _collidables.size());
+	return _restingStates[index] != 0;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Getters
+//-----------------------------------------------------------------------------------------------------------------------------
+size_t BSphereCollection::getSize() const
+{
+	return _collidables.size();
+}
+
+bool BSphereCollection::isEmpty() const
+{
+	return _collidables.empty();
+}
+
+const float* BSphereCollection::getCentersX() const
+{
+	return _centersX.data();
+}
+
+const float* BSphereCollection::getCentersY() const
+{
+	return _centersY.data();
+}
+
+const float* BSphereCollection::getCentersZ() const
+{
+	return _centersZ.data();
+}
+
+const float* BSphereCollection::getRadii() const
+{
+	return _radii.data();
+}
+
+Vect BSphereCollection::getCenterAt(int index) const
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _collidables.size());
+	return Vect(_centersX[index], _centersY[index], _centersZ[index]);
+}
+
+float BSphereCollection::getRadiusAt(int index) const
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _collidables.size());
+	return _radii[index];
+}
+
+void BSphereCollection::getBoundsAt(int index, Vect& minVertex, Vect& maxVertex) const
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _collidables.size());
+	const float radius = _radii[index];
+	minVertex = Vect(_centersX[index] - radius, _centersY[index] - radius, _centersZ[index] - radius);
+	maxVertex = Vect(_centersX[index] + radius, _centersY[index] + radius, _centersZ[index] + radius);
+}
+
+const BSphereCollection::CollidableCollection& BSphereCollection::getCollidables() const
+{
+	return _collidables;
+}
+
+Collidable* BSphereCollection::getCollidableAt(int index) const
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _collidables.size());
+	return _collidables[index];
+}
\ No newline at end of file
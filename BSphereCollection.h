@@ -0,0 +1,131 @@
+#ifndef _BSphereCollection
+#define _BSphereCollection
+
+#include <vector>
+#include <cstddef>
+
+class Vect;
+class Collidable;
+class CollisionVolumeBSphere;
+
+/**********************************************************************************************//**
+ * <summary> Structure-of-arrays copy of the BSpheres of a collidable group.
+ *			 Center x, y, z and radius are stored in separate contiguous arrays so they
+ *			 can be tested in batches by BatchTools. </summary>
+ *
+ * <remarks> Index i of every array refers to the same collidable. Indices are stable until
+ *			 removeAt() swaps the last BSphere into the removed index. </remarks>
+ **************************************************************************************************/
+class BSphereCollection
+{
+	typedef std::vector<float> FloatCollection;
+	typedef std::vector<unsigned int> FrameCollection;
+	typedef std::vector<unsigned char> StateCollection;
+
+public:
+	typedef unsigned int FrameCount;
+	typedef std::vector<Collidable*> CollidableCollection;
+
+public:
+	BSphereCollection() = default;
+	BSphereCollection(const BSphereCollection&) = default;
+	BSphereCollection& operator=(const BSphereCollection&) = default;
+	BSphereCollection(BSphereCollection&&) = default;
+	BSphereCollection& operator=(BSphereCollection&&) = default;
+	~BSphereCollection() = default;
+
+	void clear();
+	void reserve(size_t size);
+
+	/**********************************************************************************************//**
+	 * <summary> Appends a copy of the BSphere of a collidable.</summary>
+	 *
+	 * <remarks> The new BSphere starts awake and not static. </remarks>
+	 *
+	 * <param name="BSphere"> The BSphere to copy.</param>
+	 * <param name="pCollidable"> The collidable owning the BSphere.</param>
+	 *
+	 * <returns> The index of the BSphere.</returns>
+	 **************************************************************************************************/
+	int add(const CollisionVolumeBSphere& BSphere, Collidable* pCollidable);
+
+	/**********************************************************************************************//**
+	 * <summary> Overwrites the copy of the BSphere at index.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="index"> The index.</param>
+	 * <param name="BSphere"> The BSphere to copy.</param>
+	 **************************************************************************************************/
+	void set(int index, const CollisionVolumeBSphere& BSphere);
+
+	/**********************************************************************************************//**
+	 * <summary> Removes the BSphere at index by swapping the last BSphere into it.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="index"> The index.</param>
+	 *
+	 * <returns> The collidable now at index, nullptr if the last BSphere was removed.</returns>
+	 **************************************************************************************************/
+	Collidable* removeAt(int index);
+
+	size_t getSize() const;
+	bool isEmpty() const;
+
+	// Resting
+
+	/**********************************************************************************************//**
+	 * <summary> Sets the activity of the BSphere at index.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="index"> The index.</param>
+	 * <param name="lastActiveFrame"> The last frame the collidable moved or was woken.</param>
+	 * <param name="isStatic"> True if the collidable never moves.</param>
+	 **************************************************************************************************/
+	void setActivity(int index, FrameCount lastActiveFrame, bool isStatic);
+
+	/**********************************************************************************************//**
+	 * <summary> Recomputes which BSpheres are at rest (static, or asleep).</summary>
+	 *
+	 * <remarks> A BSphere is asleep when it has not been active for more than sleepFrameCount frames. </remarks>
+	 *
+	 * <param name="currentFrame"> The current frame.</param>
+	 * <param name="sleepFrameCount"> The number of inactive frames before falling asleep.</param>
+	 * <param name="nextSleepFrame"> Output of the first frame at which an awake BSphere falls asleep
+	 *								 (unchanged if none are awake).</param>
+	 *
+	 * <returns> The number of BSpheres that are not at rest.</returns>
+	 **************************************************************************************************/
+	int updateRestingStates(FrameCount currentFrame, FrameCount sleepFrameCount, FrameCount& nextSleepFrame);
+
+	bool isAtRestAt(int index) const;
+
+	const float* getCentersX() const;
+	const float* getCentersY() const;
+	const float* getCentersZ() const;
+	const float* getRadii() const;
+
+	Vect getCenterAt(int index) const;
+	float getRadiusAt(int index) const;
+	void getBoundsAt(int index, Vect& minVertex, Vect& maxVertex) const;
+	Collidable* getCollidableAt(int index) const;
+	const CollidableCollection& getCollidables() const;
+
+private:
+	FloatCollection _centersX;
+	FloatCollection _centersY;
+	FloatCollection _centersZ;
+	FloatCollection _radii;
+	CollidableCollection _collidables;
+
+	FrameCollection _lastActiveFrames;
+	StateCollection _staticStates;
+	StateCollection _restingStates;
+};
+#endif // !_BSphereCollection
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// BSphereCollection Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "BSphereTransformBatch.h"
+#include "Vect.h"
+#include "Matrix.h"
+#include <cassert>
+
+void BSphereTransformBatch::clear()
+{
+	_localCentersX.clear();
+	_localCentersY.clear();
+	_localCentersZ.clear();
+	_localRadii.clear();
+	for (FloatCollection& elements : _matrixElements)
+	{
+		elements.clear();
+	}
+
+	_worldCentersX.clear();
+	_worldCentersY.clear();
+	_worldCentersZ.clear();
+	_worldRadii.clear();
+}
+
+void BSphereTransformBatch::reserve(size_t size)
+{
+	_localCentersX.reserve(size);
+	_localCentersY.reserve(size);
+	_localCentersZ.reserve(size);
+	_localRadii.reserve(size);
+	for (FloatCollection& elements : _matrixElements)
+	{
+		elements.reserve(size);
+	}
+
+	_worldCentersX.reserve(size);
+	_worldCentersY.reserve(size);
+	_worldCentersZ.reserve(size);
+	_worldRadii.reserve(size);
+}
+
+void BSphereTransformBatch::add(const Vect& localCenter, float localRadius, const Matrix& worldMatrix)
+{
+	_localCentersX.push_back(localCenter[x]);
+	_localCentersY.push_back(localCenter[y]);
+	_localCentersZ.push_back(localCenter[z]);
+	_localRadii.push_back(localRadius);
+
+	const MatrixRowType rows[] = { ROW_0, ROW_1, ROW_2, ROW_3 };
+	for (int row = 0; row < 4; row++)
+	{
+		const Vect rowVect = worldMatrix.get(rows[row]);
+		_matrixElements[row * 3 + 0].push_back(rowVect[x]);
+		_matrixElements[row * 3 + 1].push_back(rowVect[y]);
+		_matrixElements[row * 3 + 2].push_back(rowVect[z]);
+	}
+
+	_worldCentersX.push_back(0.0f);
+	_worldCentersY.push_back(0.0f);
+	_worldCentersZ.push_back(0.0f);
+	_worldRadii.push_back(0.0f);
+}
+
+size_t BSphereTransformBatch::getSize() const
+{
+	return _localRadii.size();
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Input
+//-----------------------------------------------------------------------------------------------------------------------------
+const float* BSphereTransformBatch::getLocalCentersX() const
+{
+	return _localCentersX.data();
+}
+
+const float* BSphereTransformBatch::getLocalCentersY() const
+{
+	return _localCentersY.data();
+}
+
+const float* BSphereTransformBatch::getLocalCentersZ() const
+{
+	return _localCentersZ.data();
+}
+
+const float* BSphereTransformBatch::getLocalRadii() const
+{
+	return _localRadii.data();
+}
+
+const float* BSphereTransformBatch::getMatrixElements(int element) const
+{
+	assert(element >= 0 && element < NUMBER_OF_MATRIX_ELEMENTS);
+	return _matrixElements[element].data();
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Output
+//-----------------------------------------------------------------------------------------------------------------------------
+float* BSphereTransformBatch::getWorldCentersX()
+{
+	return _worldCentersX.data();
+}
+
+float* BSphereTransformBatch::getWorldCentersY()
+{
+	return _worldCentersY.data();
+}
+
+float* BSphereTransformBatch::getWorldCentersZ()
+{
+	return _worldCentersZ.data();
+}
+
+float* BSphereTransformBatch::getWorldRadii()
+{
+	return _worldRadii.data();
+}
+
+Vect BSphereTransformBatch::getWorldCenterAt(int index) const
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _worldRadii.size());
+	return Vect(_worldCentersX[index], _worldCentersY[index], _worldCentersZ[index]);
+}
+
+float BSphereTransformBatch::getWorldRadiusAt(int index) const
+{
+	assert(index >= 0 && static_cast<size_t>(index) < _worldRadii.size());
+	return _worldRadii[index];
+}
\ No newline at end of file
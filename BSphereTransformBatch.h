@@ -0,0 +1,80 @@
+#ifndef _BSphereTransformBatch
+#define _BSphereTransformBatch
+
+#include <vector>
+#include <cstddef>
+
+class Vect;
+class Matrix;
+
+/**********************************************************************************************//**
+ * <summary> Structure-of-arrays batch of local BSpheres and world matrices to be moved into
+ *			 world space at once by BatchTools::TransformBSpheres(). </summary>
+ *
+ * <remarks> Only the first three columns of each world matrix are kept, stored element by element
+ *			 (row * 3 + column) so a kernel can load the same element of several matrices at once. </remarks>
+ **************************************************************************************************/
+class BSphereTransformBatch
+{
+	typedef std::vector<float> FloatCollection;
+
+public:
+	static const int NUMBER_OF_MATRIX_ELEMENTS = 12;
+
+public:
+	BSphereTransformBatch() = default;
+	BSphereTransformBatch(const BSphereTransformBatch&) = default;
+	BSphereTransformBatch& operator=(const BSphereTransformBatch&) = default;
+	BSphereTransformBatch(BSphereTransformBatch&&) = default;
+	BSphereTransformBatch& operator=(BSphereTransformBatch&&) = default;
+	~BSphereTransformBatch() = default;
+
+	void clear();
+	void reserve(size_t size);
+
+	/**********************************************************************************************//**
+	 * <summary> Appends a local BSphere and the world matrix to move it with.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="localCenter"> The center in local space.</param>
+	 * <param name="localRadius"> The radius in local space.</param>
+	 * <param name="worldMatrix"> The world matrix.</param>
+	 **************************************************************************************************/
+	void add(const Vect& localCenter, float localRadius, const Matrix& worldMatrix);
+
+	size_t getSize() const;
+
+	// Input
+	const float* getLocalCentersX() const;
+	const float* getLocalCentersY() const;
+	const float* getLocalCentersZ() const;
+	const float* getLocalRadii() const;
+	const float* getMatrixElements(int element) const;
+
+	// Output
+	float* getWorldCentersX();
+	float* getWorldCentersY();
+	float* getWorldCentersZ();
+	float* getWorldRadii();
+
+	Vect getWorldCenterAt(int index) const;
+	float getWorldRadiusAt(int index) const;
+
+private:
+	FloatCollection _localCentersX;
+	FloatCollection _localCentersY;
+	FloatCollection _localCentersZ;
+	FloatCollection _localRadii;
+	FloatCollection _matrixElements[NUMBER_OF_MATRIX_ELEMENTS];
+
+	FloatCollection _worldCentersX;
+	FloatCollection _worldCentersY;
+	FloatCollection _worldCentersZ;
+	FloatCollection _worldRadii;
+};
+#endif // !_BSphereTransformBatch
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// BSphereTransformBatch Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
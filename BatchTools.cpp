@@ -0,0 +1,492 @@
+#include "BatchTools.h"
+#include "BSphereCollection.h"
+#include "BSphereTransformBatch.h"
+#include "TriangleBatch.h"
+#include "Triangle.h"
+#include "MathTools.h"
+#include "Vect.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cassert>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#endif // __AVX__
+
+namespace
+{
+	const int LANE_COUNT = 8;
+
+#if defined(__AVX__)
+	void AppendLanes(int mask, int baseIndex, BatchTools::IndexCollection& candidates)
+	{
+		for (int lane = 0; lane < LANE_COUNT; lane++)
+		{
+			if (mask & (1 << lane))
+			{
+				candidates.push_back(baseIndex + lane);
+			}
+		}
+	}
+
+	__m256 Abs(__m256 value)
+	{
+		return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), value);
+	}
+
+	// Lanes whose projections of the three vertices [min, max] miss [low, high]
+	__m256 IsOutside(__m256 p0, __m256 p1, __m256 p2, __m256 low, __m256 high)
+	{
+		const __m256 minP = _mm256_min_ps(p0, _mm256_min_ps(p1, p2));
+		const __m256 maxP = _mm256_max_ps(p0, _mm256_max_ps(p1, p2));
+		return _mm256_or_ps(_mm256_cmp_ps(minP, high, _CMP_GT_OQ), _mm256_cmp_ps(maxP, low, _CMP_LT_OQ));
+	}
+
+	// Lanes whose projections of the three vertices miss [-r, r]
+	__m256 IsSeparated(__m256 p0, __m256 p1, __m256 p2, __m256 r)
+	{
+		return IsOutside(p0, p1, p2, _mm256_sub_ps(_mm256_setzero_ps(), r), r);
+	}
+
+	// Lanes separated by the cross products of the box axes with an edge (see MathTools::IntersectBoxTriangle())
+	__m256 IsSeparatedOnEdgeAxes(__m256 edgeX, __m256 edgeY, __m256 edgeZ, const __m256* vertexX, const __m256* vertexY, const __m256* vertexZ,
+		__m256 halfX, __m256 halfY, __m256 halfZ)
+	{
+		const __m256 absoluteX = Abs(edgeX);
+		const __m256 absoluteY = Abs(edgeY);
+		const __m256 absoluteZ = Abs(edgeZ);
+
+		__m256 p[3];
+
+		// x cross edge = (0, -edge z, edge y)
+		for (int vertex = 0; vertex < 3; vertex++)
+		{
+			p[vertex] = _mm256_sub_ps(_mm256_mul_ps(edgeY, vertexZ[vertex]), _mm256_mul_ps(edgeZ, vertexY[vertex]));
+		}
+		__m256 isSeparated = IsSeparated(p[0], p[1], p[2], _mm256_add_ps(_mm256_mul_ps(halfY, absoluteZ), _mm256_mul_ps(halfZ, absoluteY)));
+
+		// y cross edge = (edge z, 0, -edge x)
+		for (int vertex = 0; vertex < 3; vertex++)
+		{
+			p[vertex] = _mm256_sub_ps(_mm256_mul_ps(edgeZ, vertexX[vertex]), _mm256_mul_ps(edgeX, vertexZ[vertex]));
+		}
+		isSeparated = _mm256_or_ps(isSeparated, IsSeparated(p[0], p[1], p[2], _mm256_add_ps(_mm256_mul_ps(halfX, absoluteZ), _mm256_mul_ps(halfZ, absoluteX))));
+
+		// z cross edge = (-edge y, edge x, 0)
+		for (int vertex = 0; vertex < 3; vertex++)
+		{
+			p[vertex] = _mm256_sub_ps(_mm256_mul_ps(edgeX, vertexY[vertex]), _mm256_mul_ps(edgeY, vertexX[vertex]));
+		}
+		return _mm256_or_ps(isSeparated, IsSeparated(p[0], p[1], p[2], _mm256_add_ps(_mm256_mul_ps(halfX, absoluteY), _mm256_mul_ps(halfY, absoluteX))));
+	}
+#endif // __AVX__
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// BSphere culling
+//-----------------------------------------------------------------------------------------------------------------------------
+void BatchTools::CullBSpheres(const BSphereCollection& BSpheres, const Vect& minVertex, const Vect& maxVertex, IndexCollection& candidates)
+{
+	const float* centersX = BSpheres.getCentersX();
+	const float* centersY = BSpheres.getCentersY();
+	const float* centersZ = BSpheres.getCentersZ();
+	const float* radii = BSpheres.getRadii();
+	const int count = static_cast<int>(BSpheres.getSize());
+
+	int i = 0;
+
+#if defined(__AVX__)
+	const __m256 minX = _mm256_set1_ps(minVertex[x]);
+	const __m256 minY = _mm256_set1_ps(minVertex[y]);
+	const __m256 minZ = _mm256_set1_ps(minVertex[z]);
+	const __m256 maxX = _mm256_set1_ps(maxVertex[x]);
+	const __m256 maxY = _mm256_set1_ps(maxVertex[y]);
+	const __m256 maxZ = _mm256_set1_ps(maxVertex[z]);
+
+	for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+	{
+		const __m256 centerX = _mm256_loadu_ps(centersX + i);
+		const __m256 centerY = _mm256_loadu_ps(centersY + i);
+		const __m256 centerZ = _mm256_loadu_ps(centersZ + i);
+		const __m256 radius = _mm256_loadu_ps(radii + i);
+
+		// Distance from the center to its clamped point inside the AABB
+		const __m256 dX = _mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(centerX, minX), maxX), centerX);
+		const __m256 dY = _mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(centerY, minY), maxY), centerY);
+		const __m256 dZ = _mm256_sub_ps(_mm256_min_ps(_mm256_max_ps(centerZ, minZ), maxZ), centerZ);
+
+		__m256 distanceSquared = _mm256_mul_ps(dX, dX);
+		distanceSquared = _mm256_add_ps(distanceSquared, _mm256_mul_ps(dY, dY));
+		distanceSquared = _mm256_add_ps(distanceSquared, _mm256_mul_ps(dZ, dZ));
+
+		const __m256 doesIntersect = _mm256_cmp_ps(distanceSquared, _mm256_mul_ps(radius, radius), _CMP_LT_OQ);
+		AppendLanes(_mm256_movemask_ps(doesIntersect), i, candidates);
+	}
+#endif // __AVX__
+
+	for (; i < count; i++)
+	{
+		const float dX = std::min(std::max(centersX[i], minVertex[x]), maxVertex[x]) - centersX[i];
+		const float dY = std::min(std::max(centersY[i], minVertex[y]), maxVertex[y]) - centersY[i];
+		const float dZ = std::min(std::max(centersZ[i], minVertex[z]), maxVertex[z]) - centersZ[i];
+
+		if (dX * dX + dY * dY + dZ * dZ < radii[i] * radii[i])
+		{
+			candidates.push_back(i);
+		}
+	}
+}
+
+void BatchTools::CullBSpheres(const BSphereCollection& BSpheres, int startIndex, const Vect& center, float radius, IndexCollection& candidates)
+{
+	const float* centersX = BSpheres.getCentersX();
+	const float* centersY = BSpheres.getCentersY();
+	const float* centersZ = BSpheres.getCentersZ();
+	const float* radii = BSpheres.getRadii();
+	const int count = static_cast<int>(BSpheres.getSize());
+
+	assert(startIndex >= 0);
+	int i = startIndex;
+
+#if defined(__AVX__)
+	const __m256 otherCenterX = _mm256_set1_ps(center[x]);
+	const __m256 otherCenterY = _mm256_set1_ps(center[y]);
+	const __m256 otherCenterZ = _mm256_set1_ps(center[z]);
+	const __m256 otherRadius = _mm256_set1_ps(radius);
+
+	for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+	{
+		const __m256 dX = _mm256_sub_ps(_mm256_loadu_ps(centersX + i), otherCenterX);
+		const __m256 dY = _mm256_sub_ps(_mm256_loadu_ps(centersY + i), otherCenterY);
+		const __m256 dZ = _mm256_sub_ps(_mm256_loadu_ps(centersZ + i), otherCenterZ);
+		const __m256 radiusSum = _mm256_add_ps(_mm256_loadu_ps(radii + i), otherRadius);
+
+		__m256 centerDistanceSquared = _mm256_mul_ps(dX, dX);
+		centerDistanceSquared = _mm256_add_ps(centerDistanceSquared, _mm256_mul_ps(dY, dY));
+		centerDistanceSquared = _mm256_add_ps(centerDistanceSquared, _mm256_mul_ps(dZ, dZ));
+
+		const __m256 doesIntersect = _mm256_cmp_ps(centerDistanceSquared, _mm256_mul_ps(radiusSum, radiusSum), _CMP_LT_OQ);
+		AppendLanes(_mm256_movemask_ps(doesIntersect), i, candidates);
+	}
+#endif // __AVX__
+
+	for (; i < count; i++)
+	{
+		const float dX = centersX[i] - center[x];
+		const float dY = centersY[i] - center[y];
+		const float dZ = centersZ[i] - center[z];
+		const float radiusSum = radii[i] + radius;
+
+		if (dX * dX + dY * dY + dZ * dZ < radiusSum * radiusSum)
+		{
+			candidates.push_back(i);
+		}
+	}
+}
+
+void BatchTools::IntersectBSpherePairs(const BSphereCollection& BSpheres_1, const BSphereCollection& BSpheres_2, IndexCollection& hits)
+{
+	const float* centersX_1 = BSpheres_1.getCentersX();
+	const float* centersY_1 = BSpheres_1.getCentersY();
+	const float* centersZ_1 = BSpheres_1.getCentersZ();
+	const float* radii_1 = BSpheres_1.getRadii();
+
+	const float* centersX_2 = BSpheres_2.getCentersX();
+	const float* centersY_2 = BSpheres_2.getCentersY();
+	const float* centersZ_2 = BSpheres_2.getCentersZ();
+	const float* radii_2 = BSpheres_2.getRadii();
+
+	assert(BSpheres_1.getSize() == BSpheres_2.getSize());
+	const int count = static_cast<int>(BSpheres_1.getSize());
+
+	int i = 0;
+
+#if defined(__AVX__)
+	for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+	{
+		const __m256 dX = _mm256_sub_ps(_mm256_loadu_ps(centersX_1 + i), _mm256_loadu_ps(centersX_2 + i));
+		const __m256 dY = _mm256_sub_ps(_mm256_loadu_ps(centersY_1 + i), _mm256_loadu_ps(centersY_2 + i));
+		const __m256 dZ = _mm256_sub_ps(_mm256_loadu_ps(centersZ_1 + i), _mm256_loadu_ps(centersZ_2 + i));
+		const __m256 radiusSum = _mm256_add_ps(_mm256_loadu_ps(radii_1 + i), _mm256_loadu_ps(radii_2 + i));
+
+		__m256 centerDistanceSquared = _mm256_mul_ps(dX, dX);
+		centerDistanceSquared = _mm256_add_ps(centerDistanceSquared, _mm256_mul_ps(dY, dY));
+		centerDistanceSquared = _mm256_add_ps(centerDistanceSquared, _mm256_mul_ps(dZ, dZ));
+
+		const __m256 doesIntersect = _mm256_cmp_ps(centerDistanceSquared, _mm256_mul_ps(radiusSum, radiusSum), _CMP_LT_OQ);
+		AppendLanes(_mm256_movemask_ps(doesIntersect), i, hits);
+	}
+#endif // __AVX__
+
+	for (; i < count; i++)
+	{
+		const float dX = centersX_1[i] - centersX_2[i];
+		const float dY = centersY_1[i] - centersY_2[i];
+		const float dZ = centersZ_1[i] - centersZ_2[i];
+		const float radiusSum = radii_1[i] + radii_2[i];
+
+		if (dX * dX + dY * dY + dZ * dZ < radiusSum * radiusSum)
+		{
+			hits.push_back(i);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Bounds
+//-----------------------------------------------------------------------------------------------------------------------------
+void BatchTools::ComputeBounds(const BSphereCollection& BSpheres, Vect& minVertex, Vect& maxVertex)
+{
+	assert(!BSpheres.isEmpty());
+
+	const float* centersX = BSpheres.getCentersX();
+	const float* centersY = BSpheres.getCentersY();
+	const float* centersZ = BSpheres.getCentersZ();
+	const float* radii = BSpheres.getRadii();
+	const int count = static_cast<int>(BSpheres.getSize());
+
+	float minX = centersX[0] - radii[0], minY = centersY[0] - radii[0], minZ = centersZ[0] - radii[0];
+	float maxX = centersX[0] + radii[0], maxY = centersY[0] + radii[0], maxZ = centersZ[0] + radii[0];
+
+	int i = 0;
+
+#if defined(__AVX__)
+	if (count >= LANE_COUNT)
+	{
+		__m256 minXs = _mm256_set1_ps(minX), minYs = _mm256_set1_ps(minY), minZs = _mm256_set1_ps(minZ);
+		__m256 maxXs = _mm256_set1_ps(maxX), maxYs = _mm256_set1_ps(maxY), maxZs = _mm256_set1_ps(maxZ);
+
+		for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+		{
+			const __m256 radius = _mm256_loadu_ps(radii + i);
+			const __m256 centerX = _mm256_loadu_ps(centersX + i);
+			const __m256 centerY = _mm256_loadu_ps(centersY + i);
+			const __m256 centerZ = _mm256_loadu_ps(centersZ + i);
+
+			minXs = _mm256_min_ps(minXs, _mm256_sub_ps(centerX, radius));
+			minYs = _mm256_min_ps(minYs, _mm256_sub_ps(centerY, radius));
+			minZs = _mm256_min_ps(minZs, _mm256_sub_ps(centerZ, radius));
+			maxXs = _mm256_max_ps(maxXs, _mm256_add_ps(centerX, radius));
+			maxYs = _mm256_max_ps(maxYs, _mm256_add_ps(centerY, radius));
+			maxZs = _mm256_max_ps(maxZs, _mm256_add_ps(centerZ, radius));
+		}
+
+		float lanes[6][LANE_COUNT];
+		_mm256_storeu_ps(lanes[0], minXs);
+		_mm256_storeu_ps(lanes[1], minYs);
+		_mm256_storeu_ps(lanes[2], minZs);
+		_mm256_storeu_ps(lanes[3], maxXs);
+		_mm256_storeu_ps(lanes[4], maxYs);
+		_mm256_storeu_ps(lanes[5], maxZs);
+
+		for (int lane = 0; lane < LANE_COUNT; lane++)
+		{
+			minX = std::min(minX, lanes[0][lane]);
+			minY = std::min(minY, lanes[1][lane]);
+			minZ = std::min(minZ, lanes[2][lane]);
+			maxX = std::max(maxX, lanes[3][lane]);
+			maxY = std::max(maxY, lanes[4][lane]);
+			maxZ = std::max(maxZ, lanes[5][lane]);
+		}
+	}
+#endif // __AVX__
+
+	for (; i < count; i++)
+	{
+		minX = std::min(minX, centersX[i] - radii[i]);
+		minY = std::min(minY, centersY[i] - radii[i]);
+		minZ = std::min(minZ, centersZ[i] - radii[i]);
+		maxX = std::max(maxX, centersX[i] + radii[i]);
+		maxY = std::max(maxY, centersY[i] + radii[i]);
+		maxZ = std::max(maxZ, centersZ[i] + radii[i]);
+	}
+
+	minVertex = Vect(minX, minY, minZ);
+	maxVertex = Vect(maxX, maxY, maxZ);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Transforms
+//-----------------------------------------------------------------------------------------------------------------------------
+void BatchTools::TransformBSpheres(BSphereTransformBatch& batch)
+{
+	const float* localCentersX = batch.getLocalCentersX();
+	const float* localCentersY = batch.getLocalCentersY();
+	const float* localCentersZ = batch.getLocalCentersZ();
+	const float* localRadii = batch.getLocalRadii();
+
+	const float* m[BSphereTransformBatch::NUMBER_OF_MATRIX_ELEMENTS];
+	for (int element = 0; element < BSphereTransformBatch::NUMBER_OF_MATRIX_ELEMENTS; element++)
+	{
+		m[element] = batch.getMatrixElements(element);
+	}
+
+	float* worldCentersX = batch.getWorldCentersX();
+	float* worldCentersY = batch.getWorldCentersY();
+	float* worldCentersZ = batch.getWorldCentersZ();
+	float* worldRadii = batch.getWorldRadii();
+	const int count = static_cast<int>(batch.getSize());
+
+	int i = 0;
+
+#if defined(__AVX__)
+	for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+	{
+		__m256 e[BSphereTransformBatch::NUMBER_OF_MATRIX_ELEMENTS];
+		for (int element = 0; element < BSphereTransformBatch::NUMBER_OF_MATRIX_ELEMENTS; element++)
+		{
+			e[element] = _mm256_loadu_ps(m[element] + i);
+		}
+
+		const __m256 localX = _mm256_loadu_ps(localCentersX + i);
+		const __m256 localY = _mm256_loadu_ps(localCentersY + i);
+		const __m256 localZ = _mm256_loadu_ps(localCentersZ + i);
+
+		// Center: row vector times matrix (rows 0 - 2 then translation in row 3)
+		__m256 worldX = _mm256_add_ps(_mm256_mul_ps(localX, e[0]), _mm256_mul_ps(localY, e[3]));
+		__m256 worldY = _mm256_add_ps(_mm256_mul_ps(localX, e[1]), _mm256_mul_ps(localY, e[4]));
+		__m256 worldZ = _mm256_add_ps(_mm256_mul_ps(localX, e[2]), _mm256_mul_ps(localY, e[5]));
+		worldX = _mm256_add_ps(worldX, _mm256_add_ps(_mm256_mul_ps(localZ, e[6]), e[9]));
+		worldY = _mm256_add_ps(worldY, _mm256_add_ps(_mm256_mul_ps(localZ, e[7]), e[10]));
+		worldZ = _mm256_add_ps(worldZ, _mm256_add_ps(_mm256_mul_ps(localZ, e[8]), e[11]));
+
+		// Radius: scaled by the largest row length
+		__m256 scaleX = _mm256_add_ps(_mm256_mul_ps(e[0], e[0]), _mm256_add_ps(_mm256_mul_ps(e[1], e[1]), _mm256_mul_ps(e[2], e[2])));
+		__m256 scaleY = _mm256_add_ps(_mm256_mul_ps(e[3], e[3]), _mm256_add_ps(_mm256_mul_ps(e[4], e[4]), _mm256_mul_ps(e[5], e[5])));
+		__m256 scaleZ = _mm256_add_ps(_mm256_mul_ps(e[6], e[6]), _mm256_add_ps(_mm256_mul_ps(e[7], e[7]), _mm256_mul_ps(e[8], e[8])));
+		__m256 maxScale = _mm256_sqrt_ps(_mm256_max_ps(scaleX, _mm256_max_ps(scaleY, scaleZ)));
+
+		_mm256_storeu_ps(worldCentersX + i, worldX);
+		_mm256_storeu_ps(worldCentersY + i, worldY);
+		_mm256_storeu_ps(worldCentersZ + i, worldZ);
+		_mm256_storeu_ps(worldRadii + i, _mm256_mul_ps(_mm256_loadu_ps(localRadii + i), maxScale));
+	}
+#endif // __AVX__
+
+	for (; i < count; i++)
+	{
+		const float localX = localCentersX[i];
+		const float localY = localCentersY[i];
+		const float localZ = localCentersZ[i];
+
+		worldCentersX[i] = localX * m[0][i] + localY * m[3][i] + localZ * m[6][i] + m[9][i];
+		worldCentersY[i] = localX * m[1][i] + localY * m[4][i] + localZ * m[7][i] + m[10][i];
+		worldCentersZ[i] = localX * m[2][i] + localY * m[5][i] + localZ * m[8][i] + m[11][i];
+
+		const float scaleX = m[0][i] * m[0][i] + m[1][i] * m[1][i] + m[2][i] * m[2][i];
+		const float scaleY = m[3][i] * m[3][i] + m[4][i] * m[4][i] + m[5][i] * m[5][i];
+		const float scaleZ = m[6][i] * m[6][i] + m[7][i] * m[7][i] + m[8][i] * m[8][i];
+
+		worldRadii[i] = localRadii[i] * std::sqrt(std::max(scaleX, std::max(scaleY, scaleZ)));
+	}
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+// Box Triangle Intersections
+//-----------------------------------------------------------------------------------------------------------------------------
+void BatchTools::IntersectTriangles(const TriangleBatch& triangles, const Vect& minVertex, const Vect& maxVertex, IndexCollection& hits)
+{
+	const int count = static_cast<int>(triangles.getSize());
+
+	int i = 0;
+
+#if defined(__AVX__)
+	const float* c[TriangleBatch::NUMBER_OF_COORDINATES];
+	for (int coordinate = 0; coordinate < TriangleBatch::NUMBER_OF_COORDINATES; coordinate++)
+	{
+		c[coordinate] = triangles.getCoordinates(coordinate);
+	}
+
+	const __m256 minX = _mm256_set1_ps(minVertex[x]);
+	const __m256 minY = _mm256_set1_ps(minVertex[y]);
+	const __m256 minZ = _mm256_set1_ps(minVertex[z]);
+	const __m256 maxX = _mm256_set1_ps(maxVertex[x]);
+	const __m256 maxY = _mm256_set1_ps(maxVertex[y]);
+	const __m256 maxZ = _mm256_set1_ps(maxVertex[z]);
+
+	// Grown by the rounding of the centering (see MathTools::IntersectBoxTriangle())
+	const Vect center = (minVertex + maxVertex) * 0.5f;
+	const float roundingError = 4.0f * FLT_EPSILON * std::max(std::max(std::abs(minVertex[x]), std::max(std::abs(minVertex[y]), std::abs(minVertex[z]))),
+		std::max(std::abs(maxVertex[x]), std::max(std::abs(maxVertex[y]), std::abs(maxVertex[z]))));
+	const Vect halfSize = (maxVertex - minVertex) * 0.5f + Vect(roundingError, roundingError, roundingError, 0.0f);
+	const __m256 centerX = _mm256_set1_ps(center[x]);
+	const __m256 centerY = _mm256_set1_ps(center[y]);
+	const __m256 centerZ = _mm256_set1_ps(center[z]);
+	const __m256 halfX = _mm256_set1_ps(halfSize[x]);
+	const __m256 halfY = _mm256_set1_ps(halfSize[y]);
+	const __m256 halfZ = _mm256_set1_ps(halfSize[z]);
+
+	for (; i + LANE_COUNT <= count; i += LANE_COUNT)
+	{
+		__m256 vertexX[3], vertexY[3], vertexZ[3];
+		for (int vertex = 0; vertex < 3; vertex++)
+		{
+			vertexX[vertex] = _mm256_loadu_ps(c[vertex * 3 + 0] + i);
+			vertexY[vertex] = _mm256_loadu_ps(c[vertex * 3 + 1] + i);
+			vertexZ[vertex] = _mm256_loadu_ps(c[vertex * 3 + 2] + i);
+		}
+
+		// Box face axes: the triangles' bounds against the box (before centering, so touching is exact)
+		__m256 isSeparated = IsOutside(vertexX[0], vertexX[1], vertexX[2], minX, maxX);
+		isSeparated = _mm256_or_ps(isSeparated, IsOutside(vertexY[0], vertexY[1], vertexY[2], minY, maxY));
+		isSeparated = _mm256_or_ps(isSeparated, IsOutside(vertexZ[0], vertexZ[1], vertexZ[2], minZ, maxZ));
+		if (_mm256_movemask_ps(isSeparated) == (1 << LANE_COUNT) - 1) continue;
+
+		// Vertices relative to the box center
+		for (int vertex = 0; vertex < 3; vertex++)
+		{
+			vertexX[vertex] = _mm256_sub_ps(vertexX[vertex], centerX);
+			vertexY[vertex] = _mm256_sub_ps(vertexY[vertex], centerY);
+			vertexZ[vertex] = _mm256_sub_ps(vertexZ[vertex], centerZ);
+		}
+
+		// Edge axes
+		const __m256 edge01X = _mm256_sub_ps(vertexX[1], vertexX[0]);
+		const __m256 edge01Y = _mm256_sub_ps(vertexY[1], vertexY[0]);
+		const __m256 edge01Z = _mm256_sub_ps(vertexZ[1], vertexZ[0]);
+		const __m256 edge12X = _mm256_sub_ps(vertexX[2], vertexX[1]);
+		const __m256 edge12Y = _mm256_sub_ps(vertexY[2], vertexY[1]);
+		const __m256 edge12Z = _mm256_sub_ps(vertexZ[2], vertexZ[1]);
+		const __m256 edge20X = _mm256_sub_ps(vertexX[0], vertexX[2]);
+		const __m256 edge20Y = _mm256_sub_ps(vertexY[0], vertexY[2]);
+		const __m256 edge20Z = _mm256_sub_ps(vertexZ[0], vertexZ[2]);
+		isSeparated = _mm256_or_ps(isSeparated, IsSeparatedOnEdgeAxes(edge01X, edge01Y, edge01Z, vertexX, vertexY, vertexZ, halfX, halfY, halfZ));
+		isSeparated = _mm256_or_ps(isSeparated, IsSeparatedOnEdgeAxes(edge12X, edge12Y, edge12Z, vertexX, vertexY, vertexZ, halfX, halfY, halfZ));
+		isSeparated = _mm256_or_ps(isSeparated, IsSeparatedOnEdgeAxes(edge20X, edge20Y, edge20Z, vertexX, vertexY, vertexZ, halfX, halfY, halfZ));
+
+		// Triangle planes against the box, except for slivers (see MathTools::IntersectBoxTriangle())
+		const __m256 normalX = _mm256_sub_ps(_mm256_mul_ps(edge01Y, edge12Z), _mm256_mul_ps(edge01Z, edge12Y));
+		const __m256 normalY = _mm256_sub_ps(_mm256_mul_ps(edge01Z, edge12X), _mm256_mul_ps(edge01X, edge12Z));
+		const __m256 normalZ = _mm256_sub_ps(_mm256_mul_ps(edge01X, edge12Y), _mm256_mul_ps(edge01Y, edge12X));
+		__m256 distance = _mm256_mul_ps(normalX, vertexX[0]);
+		distance = _mm256_add_ps(distance, _mm256_mul_ps(normalY, vertexY[0]));
+		distance = _mm256_add_ps(distance, _mm256_mul_ps(normalZ, vertexZ[0]));
+		__m256 r = _mm256_mul_ps(halfX, Abs(normalX));
+		r = _mm256_add_ps(r, _mm256_mul_ps(halfY, Abs(normalY)));
+		r = _mm256_add_ps(r, _mm256_mul_ps(halfZ, Abs(normalZ)));
+		__m256 normalLengthSquared = _mm256_mul_ps(normalX, normalX);
+		normalLengthSquared = _mm256_add_ps(normalLengthSquared, _mm256_mul_ps(normalY, normalY));
+		normalLengthSquared = _mm256_add_ps(normalLengthSquared, _mm256_mul_ps(normalZ, normalZ));
+		__m256 edge01LengthSquared = _mm256_mul_ps(edge01X, edge01X);
+		edge01LengthSquared = _mm256_add_ps(edge01LengthSquared, _mm256_mul_ps(edge01Y, edge01Y));
+		edge01LengthSquared = _mm256_add_ps(edge01LengthSquared, _mm256_mul_ps(edge01Z, edge01Z));
+		__m256 edge12LengthSquared = _mm256_mul_ps(edge12X, edge12X);
+		edge12LengthSquared = _mm256_add_ps(edge12LengthSquared, _mm256_mul_ps(edge12Y, edge12Y));
+		edge12LengthSquared = _mm256_add_ps(edge12LengthSquared, _mm256_mul_ps(edge12Z, edge12Z));
+		const __m256 isSliver = _mm256_cmp_ps(normalLengthSquared, _mm256_mul_ps(_mm256_set1_ps(FLT_EPSILON),
+			_mm256_mul_ps(edge01LengthSquared, edge12LengthSquared)), _CMP_LE_OQ);
+
+		isSeparated = _mm256_or_ps(isSeparated, _mm256_andnot_ps(isSliver, _mm256_cmp_ps(Abs(distance), r, _CMP_GT_OQ)));
+
+		AppendLanes(~_mm256_movemask_ps(isSeparated), i, hits);
+	}
+#endif // __AVX__
+
+	for (; i < count; i++)
+	{
+		if (MathTools::IntersectBoxTriangle(minVertex, maxVertex, triangles.getTriangleAt(i)))
+		{
+			hits.push_back(i);
+		}
+	}
+}
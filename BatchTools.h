@@ -0,0 +1,97 @@
+#ifndef _BatchTools
+#define _BatchTools
+
+#include <vector>
+
+class Vect;
+class BSphereCollection;
+class BSphereTransformBatch;
+class TriangleBatch;
+
+/**********************************************************************************************//**
+// namespace: BatchTools
+//
+// summary:	Batch kernels testing many volumes stored as structure-of-arrays at once.
+//			Uses AVX when available (8 lanes), otherwise falls back to scalar loops.
+ **************************************************************************************************/
+namespace BatchTools
+{
+	typedef std::vector<int> IndexCollection;
+
+	/**********************************************************************************************//**
+	* <summary> Tests every BSphere of a collection against an AABB.</summary>
+	*
+	* <remarks> Indices of the BSpheres that intersect are appended to candidates. </remarks>
+	*
+	* <param name="BSpheres"> The BSpheres to test.</param>
+	* <param name="minVertex"> The min vertex of the AABB.</param>
+	* <param name="maxVertex"> The max vertex of the AABB.</param>
+	* <param name="candidates"> Output of the BSphere indices that intersect.</param>
+	**************************************************************************************************/
+	void CullBSpheres(const BSphereCollection& BSpheres, const Vect& minVertex, const Vect& maxVertex, IndexCollection& candidates);
+
+	/**********************************************************************************************//**
+	* <summary> Tests the BSpheres of a collection, starting at startIndex, against a single BSphere.</summary>
+	*
+	* <remarks> Indices of the BSpheres that intersect are appended to candidates. </remarks>
+	*
+	* <param name="BSpheres"> The BSpheres to test.</param>
+	* <param name="startIndex"> The first index of the collection to test.</param>
+	* <param name="center"> The center of the BSphere.</param>
+	* <param name="radius"> The radius of the BSphere.</param>
+	* <param name="candidates"> Output of the BSphere indices that intersect.</param>
+	**************************************************************************************************/
+	void CullBSpheres(const BSphereCollection& BSpheres, int startIndex, const Vect& center, float radius, IndexCollection& candidates);
+
+	/**********************************************************************************************//**
+	* <summary> Tests BSphere i of a collection against BSphere i of another, for every i.</summary>
+	*
+	* <remarks> Both collections must have the same size.
+	*			Indices of the pairs that intersect are appended to hits. </remarks>
+	*
+	* <param name="BSpheres_1"> The first BSphere of each pair.</param>
+	* <param name="BSpheres_2"> The second BSphere of each pair.</param>
+	* <param name="hits"> Output of the pair indices that intersect.</param>
+	**************************************************************************************************/
+	void IntersectBSpherePairs(const BSphereCollection& BSpheres_1, const BSphereCollection& BSpheres_2, IndexCollection& hits);
+
+	/**********************************************************************************************//**
+	* <summary> Computes the min and max vertex enclosing every BSphere of a collection.</summary>
+	*
+	* <remarks> Collection must not be empty. </remarks>
+	*
+	* <param name="BSpheres"> The BSpheres.</param>
+	* <param name="minVertex"> Output of the min vertex.</param>
+	* <param name="maxVertex"> Output of the max vertex.</param>
+	**************************************************************************************************/
+	void ComputeBounds(const BSphereCollection& BSpheres, Vect& minVertex, Vect& maxVertex);
+
+	/**********************************************************************************************//**
+	* <summary> Moves every local BSphere of a batch into world space using its world matrix.</summary>
+	*
+	* <remarks> Radii are scaled by the largest axis scale of their matrix.
+	*			Results are written to the world outputs of the batch. </remarks>
+	*
+	* <param name="batch"> The batch to transform.</param>
+	**************************************************************************************************/
+	void TransformBSpheres(BSphereTransformBatch& batch);
+
+	/**********************************************************************************************//**
+	* <summary> Tests every triangle of a batch against an axis aligned box, in the same space.</summary>
+	*
+	* <remarks> Runs MathTools::IntersectBoxTriangle() on 8 triangles at once: every lane takes
+	*			all 13 axes, and a group stops after the box face axes once they separate all of
+	*			its lanes. Indices of the triangles that intersect are appended to hits. </remarks>
+	*
+	* <param name="triangles"> The triangles to test.</param>
+	* <param name="minVertex"> The min vertex of the box.</param>
+	* <param name="maxVertex"> The max vertex of the box.</param>
+	* <param name="hits"> Output of the triangle indices that intersect.</param>
+	**************************************************************************************************/
+	void IntersectTriangles(const TriangleBatch& triangles, const Vect& minVertex, const Vect& maxVertex, IndexCollection& hits);
+};
+#endif // !_BatchTools
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// BatchTools Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -3,27 +3,31 @@
 #include "SceneManager.h"
 #include "CollisionManager.h"
 #include "CollidableGroup.h"
-#include "CollisionRegisterCommand.h"
-#include "CollisionDeregisterCommand.h"
+#include "CollisionRecorder.h"
 #include "CollisionVolumeBSphere.h"
 #include "CollisionVolumeAABB.h"
 #include "CollisionVolumeOBB.h"
 #include "CollisionVolumeOctree.h"
 
+const CollisionManager::FrameCount Collidable::SLEEP_FRAME_COUNT = 60;
+
 Collidable::Collidable()
-	: _pCollisionVolume(nullptr), _pBSphere(new CollisionVolumeBSphere()), _pColliderModel(nullptr),
+	: _volumeStorageMode(VolumeStorageMode::OWNED), _pCollisionVolume(nullptr), _pBSphere(&_ownedBSphere), _ownedBSphere(),
+	_pCollisionVolumeStorage(nullptr), _collisionVolumeHandle(), _BSphereHandle(), _pColliderModel(nullptr),
+	_lastWorldMatrix(ZERO), _localBSphereCenter(0.0f, 0.0f, 0.0f), _localBSphereRadius(0.0f), _lastMovedFrame(0),
+	_lastActiveFrame(0), _isStatic(false),
 	_myCollisionTypeID(CollisionManager::ID_UNDEFINED),
-	_pCollisionRegisterCommand(new CollisionRegisterCommand(this)),
-	_pCollisionDeregisterCommand(new CollisionDeregisterCommand(this)),
+	_pCollidableGroup(nullptr),
+	_registrationRequest(this, CollisionRequestQueue::RequestType::REGISTRATION),
+	_deregistrationRequest(this, CollisionRequestQueue::RequestType::DEREGISTRATION),
+	_collisionRegisterCommand(this),
+	_collisionDeregisterCommand(this),
 	_currentRegistrationState(RegistrationState::CURRENTLY_DEREGISTERED)
 {}
 
 Collidable::~Collidable()
 {
-	delete _pCollisionVolume;
-	delete _pBSphere;
-	delete _pCollisionRegisterCommand;
-	delete _pCollisionDeregisterCommand;
+	releaseCollisionVolumes();
 }
 
 //-----------------------------------------------------------------------------------------------------------------------------
@@ -34,44 +38,201 @@ const CollisionVolume& Collidable::getCollisionVolume() const
 	return *_pCollisionVolume;
 }
 
+void Collidable::setVolumeStorageMode(VolumeStorageMode volumeStorageMode)
+{
+	// The volumes already live in the storage of the current mode
+	assert(_pCollisionVolume == nullptr);
+	if (_pCollisionVolume != nullptr) return;
+
+	_volumeStorageMode = volumeStorageMode;
+}
+
 void Collidable::setColliderModel(Model* pColliderModel, VolumeType volumeType)
 {
 	_pColliderModel = pColliderModel;
-	delete _pCollisionVolume;
+	releaseCollisionVolume();
 	switch (volumeType)
 	{
 	case Collidable::VolumeType::BSPHERE:
-		_pCollisionVolume = new CollisionVolumeBSphere();
+		createCollisionVolume(CollisionVolume::Type::BSPHERE);
 		break;
 	case Collidable::VolumeType::AABB:
-		_pCollisionVolume = new CollisionVolumeAABB();
+		createCollisionVolume(CollisionVolume::Type::AABB);
 		break;
 	case Collidable::VolumeType::OBB:
-		_pCollisionVolume = new CollisionVolumeOBB();
+		createCollisionVolume(CollisionVolume::Type::OBB);
 		break;
 	default:
 		break;
 	}
+	computeLocalBSphere();
 }
 
 void Collidable::setColliderModel(Model* pColliderModel, VolumeHierarchyType volumeHierarchyType, int maxDepth)
 {
 	_pColliderModel = pColliderModel;
-	delete _pCollisionVolume;
+	releaseCollisionVolume();
 	switch (volumeHierarchyType)
 	{
 	case Collidable::VolumeHierarchyType::OCTREE:
-		_pCollisionVolume = new CollisionVolumeOctree(pColliderModel, maxDepth);
+		createOctreeVolume(maxDepth, OctreeTools::BuildMode::UNIFORM);
+		break;
+	case Collidable::VolumeHierarchyType::ADAPTIVE_OCTREE:
+		createOctreeVolume(maxDepth, OctreeTools::BuildMode::ADAPTIVE);
+		break;
+	default:
+		break;
+	}
+	computeLocalBSphere();
+}
+
+void Collidable::createCollisionVolume(CollisionVolume::Type volumeType)
+{
+	if (_volumeStorageMode == VolumeStorageMode::SCENE)
+	{
+		prepareCollisionVolumeStorage();
+		_collisionVolumeHandle = _pCollisionVolumeStorage->create(volumeType);
+		_pCollisionVolume = &_pCollisionVolumeStorage->get(_collisionVolumeHandle);
+		return;
+	}
+
+	switch (volumeType)
+	{
+	case CollisionVolume::Type::BSPHERE:
+		_pCollisionVolume = new CollisionVolumeBSphere();
+		break;
+	case CollisionVolume::Type::AABB:
+		_pCollisionVolume = new CollisionVolumeAABB();
+		break;
+	case CollisionVolume::Type::OBB:
+		_pCollisionVolume = new CollisionVolumeOBB();
 		break;
 	default:
+		assert(false);
 		break;
 	}
 }
 
+void Collidable::createOctreeVolume(int maxDepth, OctreeTools::BuildMode buildMode)
+{
+	if (_volumeStorageMode == VolumeStorageMode::SCENE)
+	{
+		prepareCollisionVolumeStorage();
+		_collisionVolumeHandle = _pCollisionVolumeStorage->createOctree(_pColliderModel, maxDepth, buildMode);
+		_pCollisionVolume = &_pCollisionVolumeStorage->get(_collisionVolumeHandle);
+		return;
+	}
+
+	_pCollisionVolume = new CollisionVolumeOctree(_pColliderModel, maxDepth, buildMode);
+}
+
+void Collidable::prepareCollisionVolumeStorage()
+{
+	if (_pCollisionVolumeStorage != nullptr) return;
+
+	// The BSphere moves to the pools with the collision volume
+	_pCollisionVolumeStorage = &SceneAttorney::RegistrationAccess::GetCollisionManager().getCollisionVolumeStorage();
+	_BSphereHandle = _pCollisionVolumeStorage->create(CollisionVolume::Type::BSPHERE);
+	_pBSphere = &_pCollisionVolumeStorage->getBSphere(_BSphereHandle);
+}
+
+void Collidable::releaseCollisionVolume()
+{
+	if (_pCollisionVolume == nullptr) return;
+
+	if (_volumeStorageMode == VolumeStorageMode::SCENE)
+	{
+		_pCollisionVolumeStorage->destroy(_collisionVolumeHandle);
+	}
+	else
+	{
+		delete _pCollisionVolume;
+	}
+	_pCollisionVolume = nullptr;
+}
+
+void Collidable::releaseCollisionVolumes()
+{
+	releaseCollisionVolume();
+
+	if (_pCollisionVolumeStorage == nullptr) return;
+
+	_pCollisionVolumeStorage->destroy(_BSphereHandle);
+	_pCollisionVolumeStorage = nullptr;
+	_pBSphere = &_ownedBSphere;
+}
+
+void Collidable::computeLocalBSphere()
+{
+	CollisionVolumeBSphere localBSphere;
+	localBSphere.computeData(_pColliderModel, Matrix(IDENTITY));
+	_localBSphereCenter = localBSphere.getCenter();
+	_localBSphereRadius = localBSphere.getRadius();
+
+	// Forces the next update to recompute the collision data
+	_lastWorldMatrix = Matrix(ZERO);
+}
+
 void Collidable::updateCollisionData(const Matrix& world)
 {
+	// Nothing to recompute when the object has not moved
+	if (world.isEqual(_lastWorldMatrix)) return;
+
 	_pCollisionVolume->computeData(_pColliderModel, world);
 	_pBSphere->computeData(_pColliderModel, world);
+
+	CollisionManager& collisionManager = SceneAttorney::RegistrationAccess::GetCollisionManager();
+	if (collisionManager.getRecorder() != nullptr)
+	{
+		collisionManager.getRecorder()->recordMove(*this, world);
+	}
+
+	markAsMoved(world, collisionManager.getFrameCount());
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Movement
+//-----------------------------------------------------------------------------------------------------------------------------
+void Collidable::markAsMoved(const Matrix& world, CollisionManager::FrameCount currentFrame)
+{
+	_lastWorldMatrix = world;
+	_lastMovedFrame = currentFrame;
+	_lastActiveFrame = currentFrame;
+	markForRefresh();
+}
+
+void Collidable::markForRefresh()
+{
+	if (_pCollidableGroup != nullptr)
+	{
+		_pCollidableGroup->markForRefresh(this);
+	}
+}
+
+void Collidable::setIsStatic(bool isStatic)
+{
+	_isStatic = isStatic;
+	markForRefresh();
+}
+
+bool Collidable::isAtRest() const
+{
+	const CollisionManager::FrameCount currentFrame = SceneAttorney::RegistrationAccess::GetCollisionManager().getFrameCount();
+	return _isStatic || currentFrame - _lastActiveFrame > Collidable::SLEEP_FRAME_COUNT;
+}
+
+void Collidable::wake()
+{
+	if (_isStatic || !isAtRest()) return;
+
+	_lastActiveFrame = SceneAttorney::RegistrationAccess::GetCollisionManager().getFrameCount();
+	markForRefresh();
+}
+
+bool Collidable::hasMoved() const
+{
+	return _lastMovedFrame == SceneAttorney::RegistrationAccess::GetCollisionManager().getFrameCount()
+		&& !_lastWorldMatrix.isEqual(Matrix(ZERO));
 }
 
 //-----------------------------------------------------------------------------------------------------------------------------
@@ -80,7 +241,7 @@ void Collidable::updateCollisionData(const Matrix& world)
 void Collidable::submitCollisionRegistration()
 {
 	assert(_currentRegistrationState == RegistrationState::CURRENTLY_DEREGISTERED);
-	SceneAttorney::RegistrationAccess::SubmitCommand(SceneManager::GetCurrentScene(), _pCollisionRegisterCommand);
+	SceneAttorney::RegistrationAccess::SubmitCommand(SceneManager::GetCurrentScene(), &_collisionRegisterCommand);
 	_currentRegistrationState = RegistrationState::PENDING_REGISTRATION;
 }
 
@@ -88,14 +249,20 @@ void Collidable::registerToScene()
 {
 	assert(_currentRegistrationState == RegistrationState::PENDING_REGISTRATION);
 	CollisionManager& collisionManager = SceneAttorney::RegistrationAccess::GetCollisionManager();
-	collisionManager.getCollidableGroup(_myCollisionTypeID)->registerEntity(this, _deleteReference);
+	_pCollidableGroup = collisionManager.getCollidableGroup(_myCollisionTypeID);
+	_pCollidableGroup->registerEntity(this, _deleteReference);
 	_currentRegistrationState = RegistrationState::CURRENTLY_REGISTERED;
+
+	if (collisionManager.getRecorder() != nullptr)
+	{
+		collisionManager.getRecorder()->recordRegistration(*this);
+	}
 }
 
 void Collidable::submitCollisionDeregistration()
 {
 	assert(_currentRegistrationState == RegistrationState::CURRENTLY_REGISTERED);
-	SceneAttorney::RegistrationAccess::SubmitCommand(SceneManager::GetCurrentScene(), _pCollisionDeregisterCommand);
+	SceneAttorney::RegistrationAccess::SubmitCommand(SceneManager::GetCurrentScene(), &_collisionDeregisterCommand);
 	_currentRegistrationState = RegistrationState::PENDING_DEREGISTRATION;
 }
 
@@ -117,5 +284,11 @@ void Collidable::deregisterFromScene()
 	assert(_currentRegistrationState == RegistrationState::PENDING_DEREGISTRATION);
 	CollisionManager& collisionManager = SceneAttorney::RegistrationAccess::GetCollisionManager();
 	collisionManager.getCollidableGroup(_myCollisionTypeID)->deregisterEntity(_deleteReference);
+	_pCollidableGroup = nullptr;
 	_currentRegistrationState = RegistrationState::CURRENTLY_DEREGISTERED;
+
+	if (collisionManager.getRecorder() != nullptr)
+	{
+		collisionManager.getRecorder()->recordDeregistration(*this);
+	}
 }
\ No newline at end of file
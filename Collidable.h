@@ -6,15 +6,27 @@
 #include "CollidableGroup.h"
 #include "SceneManager.h"
 #include "SceneAttorney.h"
+#include "CollisionRegisterCommand.h"
+#include "CollisionDeregisterCommand.h"
+#include "CollisionVolumeStorage.h"
+#include "Matrix.h"
 
 class CollisionVolume;
 class CollisionVolumeBSphere;
-class CollisionRegisterCommand;
-class CollisionDeregisterCommand;
 
 class Collidable
 {
 	friend class CollidableAttorney;
+	friend class CollisionManager;
+	friend class CollidableGroup;
+	friend class CollisionRecorder;
+public:
+	/**********************************************************************************************//**
+	 * <summary> Number of frames without moving (or being woken) before a collidable falls asleep.</summary>
+	 *	\ingroup COLLISION
+	 **************************************************************************************************/
+	static const CollisionManager::FrameCount SLEEP_FRAME_COUNT;
+
 public:
 	/**********************************************************************************************//**
 	 * <summary> Values that represent volume types.</summary>
@@ -37,19 +49,47 @@ public:
 	*	\ingroup COLLISION
 	*
 	 * <remarks> To be used in GameObject::setColliderModel(). Currently there is
-	 *   Collidable::VolumeHierarchyType::OCTREE </remarks>
+	 *   Collidable::VolumeHierarchyType::OCTREE (leaves at the full depth)
+	 *   and Collidable::VolumeHierarchyType::ADAPTIVE_OCTREE (leaves as deep as each region
+	 *   needs, up to the depth; see OctreeAdaptiveCriteria) </remarks>
 	**************************************************************************************************/
 	enum class VolumeHierarchyType
 	{
-		OCTREE
+		OCTREE,
+		ADAPTIVE_OCTREE
+	};
+
+	/**********************************************************************************************//**
+	* <summary> Values that represent where the collision volumes of a collidable live.</summary>
+	*	\ingroup COLLISION
+	*
+	 * <remarks> To be used in GameObject::setVolumeStorageMode(). Currently there is
+	 *   Collidable::VolumeStorageMode::OWNED (default: volumes owned by the collidable, one
+	 *   allocation per collider model)
+	 *   and Collidable::VolumeStorageMode::SCENE (opt-in: contiguous pools owned by the
+	 *   CollisionManager of the current scene, the collidable MUST be destroyed before that
+	 *   scene) </remarks>
+	**************************************************************************************************/
+	enum class VolumeStorageMode
+	{
+		OWNED,
+		SCENE
 	};
 
 public:
 	Collidable();
-	Collidable(const Collidable&) = default;
-	Collidable& operator=(const Collidable&) = default;
-	Collidable(Collidable&&) = default;
-	Collidable& operator=(Collidable&&) = default;
+	Collidable(const Collidable&) = delete;
+	Collidable& operator=(const Collidable&) = delete;
+	Collidable(Collidable&&) = delete;
+	Collidable& operator=(Collidable&&) = delete;
+
+	/**********************************************************************************************//**
+	* <summary> Destructor, releases the collision volumes.</summary>
+	*
+	* <remarks> With VolumeStorageMode::SCENE (opt-in) the volumes are released into the
+	*			CollisionManager of the scene that was current at setColliderModel(): destroy the
+	*			collidable before that scene. </remarks>
+	**************************************************************************************************/
 	virtual ~Collidable();
 
 	/**********************************************************************************************//**
@@ -70,6 +110,36 @@ public:
 	**************************************************************************************************/
 	const CollisionVolumeBSphere& getBSphere() const;
 
+	/**********************************************************************************************//**
+	* <summary> Query if the collision data changed since the last processed collisions.</summary>
+	*
+	* <remarks> Set by updateCollisionData() and CollisionManager::updateCollisionData()
+	*			only when the world matrix is different from the previous one. </remarks>
+	*
+	* <returns> True if moved this frame, false if not.</returns>
+	**************************************************************************************************/
+	bool hasMoved() const;
+
+	/**********************************************************************************************//**
+	* <summary> Query if this object is at rest: static, or asleep.</summary>
+	* \ingroup COLLISION
+	*
+	* <remarks> A collidable falls asleep after SLEEP_FRAME_COUNT frames without moving.
+	*			Pairs where both collidables are at rest are not tested. </remarks>
+	*
+	* <returns> True if at rest, false if not.</returns>
+	**************************************************************************************************/
+	bool isAtRest() const;
+
+	/**********************************************************************************************//**
+	* <summary> Wakes this object if it is asleep.</summary>
+	* \ingroup COLLISION
+	*
+	* <remarks> Called by the collision test commands when this object is touched.
+	*			Static objects are never woken. </remarks>
+	**************************************************************************************************/
+	void wake();
+
 	/**********************************************************************************************//**
 	* <summary> Terrain collision callback for this object.</summary>
 	* \ingroup COLLISION
@@ -84,10 +154,22 @@ public:
 protected:
 	// Collsion Volumes
 
+	/**********************************************************************************************//**
+	 * <summary> Sets where the collision volumes live.</summary>
+	 * \ingroup COLLISION
+	 * <remarks> Must be called before setColliderModel(), ignored once the volumes exist.
+	 *			 VolumeStorageMode::SCENE keeps the volumes dense for the per-frame updates, but
+	 *			 the collidable must then be destroyed before its scene. </remarks>
+	 *
+	 * <param name="volumeStorageMode"> The volume storage mode.</param>
+	 **************************************************************************************************/
+	void setVolumeStorageMode(VolumeStorageMode volumeStorageMode);
+
 	/**********************************************************************************************//**
 	 * <summary> Sets collider model and Collision Volume type.</summary>
 	 * \ingroup COLLISION
-	 * <remarks> MUST be set if collisions are to be used. </remarks>
+	 * <remarks> MUST be set if collisions are to be used. MUST be called on the main thread
+	 *			 (not thread-safe, see CollisionManager::submitConcurrentRegistration()). </remarks>
 	 *
 	* <param name="pColliderModel"> pointer to a collider model.</param>
 	 * <param name="volumeType"> collision volume type to be used.</param>
@@ -97,11 +179,14 @@ protected:
 	/**********************************************************************************************//**
 	* <summary> Sets collider model and Collision Volume Hierarchy type.</summary>
 	* \ingroup COLLISION
-	* <remarks> MUST be set if collisions are to be used. </remarks>
+	* <remarks> MUST be set if collisions are to be used. MUST be called on the main thread
+	*			(not thread-safe, see CollisionManager::submitConcurrentRegistration()). </remarks>
 	*
 	* <param name="pColliderModel"> pointer to a collider model.</param>
 	* <param name="volumeType"> collision volume type to be used.</param>
-	* <param name="maxDepth"> The maximum depth of volume hierarchy.</param>
+	* <param name="maxDepth"> The maximum depth of volume hierarchy (clamped to 1 to
+	*						 OctreeTools::MAX_DEPTH), or OctreeTools::AUTO_DEPTH to let
+	*						 OctreeModelManager pick it for the model.</param>
 	**************************************************************************************************/
 	void setColliderModel(Model* pColliderModel, VolumeHierarchyType volumeHierarchyType, int maxDepth);
 
@@ -114,13 +199,24 @@ protected:
 	 **************************************************************************************************/
 	void updateCollisionData(const Matrix& world);
 
+	/**********************************************************************************************//**
+	 * <summary> Sets whether this object is static.</summary>
+	 * \ingroup COLLISION
+	 * <remarks> Static objects are always at rest: they are never tested against other objects at rest
+	 *			 and are never woken. </remarks>
+	 *
+	 * <param name="isStatic"> True if the object never moves.</param>
+	 **************************************************************************************************/
+	void setIsStatic(bool isStatic);
+
 	// Registration/Deregistration
 
 	/**********************************************************************************************//**
 	 * <summary> Sets collidable group.</summary>
 	 * \ingroup COLLISION
 	 * <remarks> Must be called when the GameObject enters the scene for the first time
-	 * 			 and will use collisions. </remarks>
+	 * 			 and will use collisions. MUST be called on the main thread (not thread-safe,
+	 * 			 see CollisionManager::submitConcurrentRegistration()). </remarks>
 	 *
 	 * <typeparam name="UserClass"> Type of the user class.</typeparam>
 	 **************************************************************************************************/
@@ -173,19 +269,54 @@ private:
 	 **************************************************************************************************/
 	void deregisterFromScene();
 
+	// Collsion Volumes
+	void computeLocalBSphere();
+	void createCollisionVolume(CollisionVolume::Type volumeType);
+	void createOctreeVolume(int maxDepth, OctreeTools::BuildMode buildMode);
+	void prepareCollisionVolumeStorage();
+	void releaseCollisionVolume();
+	void releaseCollisionVolumes();
+
+	// Movement
+	void markAsMoved(const Matrix& world, CollisionManager::FrameCount currentFrame);
+	void markForRefresh();
+
 private:
-	// Collision Volume Properites
+	// Collision Volume Properites (owned, or in the CollisionManager's storage: see VolumeStorageMode)
+	VolumeStorageMode _volumeStorageMode;
 	CollisionVolume* _pCollisionVolume;
 	CollisionVolumeBSphere* _pBSphere;
+	CollisionVolumeBSphere _ownedBSphere;
+
+	// Only with VolumeStorageMode::SCENE (pooled volumes never move)
+	CollisionVolumeStorage* _pCollisionVolumeStorage;
+	CollisionVolumeStorage::Handle _collisionVolumeHandle;
+	CollisionVolumeStorage::Handle _BSphereHandle;
 	Model* _pColliderModel;
 
+	// Movement Properties (BSphere in model space is kept for batch updates)
+	Matrix _lastWorldMatrix;
+	Vect _localBSphereCenter;
+	float _localBSphereRadius;
+	CollisionManager::FrameCount _lastMovedFrame;
+
+	// Resting Properties
+	CollisionManager::FrameCount _lastActiveFrame;
+	bool _isStatic;
+
 	// De/Registration Properties
 	CollisionManager::CollisionTypeID _myCollisionTypeID;
 
+	CollidableGroup* _pCollidableGroup;
 	CollidableGroup::StorageReference _deleteReference;
 
-	CollisionRegisterCommand* _pCollisionRegisterCommand;
-	CollisionDeregisterCommand* _pCollisionDeregisterCommand;
+	// Nodes for CollisionManager::submitConcurrent(De)Registration()
+	CollisionRequestQueue::Node _registrationRequest;
+	CollisionRequestQueue::Node _deregistrationRequest;
+
+	// Reused on every (de)registration, stored in place to avoid allocations
+	CollisionRegisterCommand _collisionRegisterCommand;
+	CollisionDeregisterCommand _collisionDeregisterCommand;
 
 	RegistrationState _currentRegistrationState;
 };
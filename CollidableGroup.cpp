@@ -0,0 +1,257 @@
+#include "CollidableGroup.h"
+#include "Collidable.h"
+#include "CollisionVolumeAABB.h"
+#include "CollisionVolumeBSphere.h"
+#include "BatchTools.h"
+#include "MathTools.h"
+#include <algorithm>
+
+CollidableGroup::CollidableGroup()
+	: _pGroupAABB(new CollisionVolumeAABB()),
+	_minVertex(0.0f, 0.0f, 0.0f), _maxVertex(0.0f, 0.0f, 0.0f),
+	_isGroupAABBOutdated(false), _isBoundsRecomputeNeeded(false),
+	_numberOfAwake(0), _nextRestingUpdateFrame(0), _isRestingUpdateNeeded(false)
+{}
+
+CollidableGroup::~CollidableGroup()
+{
+	delete _pGroupAABB;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Registration/Deregistration
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollidableGroup::registerEntity(Collidable* pCollidable, StorageReference& deleteReference)
+{
+	const int BSphereIndex = addBSphere(pCollidable, deleteReference);
+
+	if (_BSpheres.getSize() == 1)
+	{
+		_BSpheres.getBoundsAt(BSphereIndex, _minVertex, _maxVertex);
+		_isGroupAABBOutdated = true;
+	}
+	else
+	{
+		expandBounds(BSphereIndex);
+	}
+	_isRestingUpdateNeeded = true;
+}
+
+void CollidableGroup::deregisterEntity(const StorageReference& deleteReference)
+{
+	const int BSphereIndex = deleteReference.BSphereIndex;
+	Collidable* pCollidable = _BSpheres.getCollidableAt(BSphereIndex);
+
+	if (deleteReference.isMarkedForRefresh)
+	{
+		_markedCollidables.erase(std::find(_markedCollidables.begin(), _markedCollidables.end(), pCollidable));
+	}
+
+	// Removing a BSphere inside the bounds cannot shrink them
+	if (isOnBounds(BSphereIndex))
+	{
+		_isBoundsRecomputeNeeded = true;
+	}
+	_isRestingUpdateNeeded = true;
+
+	removeBSphere(BSphereIndex);
+}
+
+void CollidableGroup::registerEntities(Collidable* const* pCollidables, size_t count)
+{
+	if (count == 0) return;
+
+	_BSpheres.reserve(_BSpheres.getSize() + count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Collidable* pCollidable = pCollidables[i];
+		addBSphere(pCollidable, pCollidable->_deleteReference);
+	}
+
+	// One batch reduction instead of growing the bounds per member
+	_isBoundsRecomputeNeeded = true;
+	_isRestingUpdateNeeded = true;
+}
+
+void CollidableGroup::deregisterEntities(Collidable* const* pCollidables, size_t count)
+{
+	if (count == 0) return;
+
+	bool hasMarkedCollidables = false;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		StorageReference& deleteReference = pCollidables[i]->_deleteReference;
+
+		// Unmarked now, purged from the marked collidables in a single pass below
+		hasMarkedCollidables |= deleteReference.isMarkedForRefresh;
+		deleteReference.isMarkedForRefresh = false;
+
+		removeBSphere(deleteReference.BSphereIndex);
+	}
+
+	if (hasMarkedCollidables)
+	{
+		_markedCollidables.erase(std::remove_if(_markedCollidables.begin(), _markedCollidables.end(),
+			[](const Collidable* pCollidable) { return !pCollidable->_deleteReference.isMarkedForRefresh; }),
+			_markedCollidables.end());
+	}
+
+	_isBoundsRecomputeNeeded = true;
+	_isRestingUpdateNeeded = true;
+}
+
+const CollidableGroup::Collection& CollidableGroup::getColliderCollection() const
+{
+	return _BSpheres.getCollidables();
+}
+
+bool CollidableGroup::isEmpty() const
+{
+	return _BSpheres.isEmpty();
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Registration/Deregistration helpers
+//-----------------------------------------------------------------------------------------------------------------------------
+int CollidableGroup::addBSphere(Collidable* pCollidable, StorageReference& deleteReference)
+{
+	deleteReference.BSphereIndex = _BSpheres.add(pCollidable->getBSphere(), pCollidable);
+	deleteReference.isMarkedForRefresh = false;
+
+	_BSpheres.setActivity(deleteReference.BSphereIndex, pCollidable->_lastActiveFrame, pCollidable->_isStatic);
+
+	return deleteReference.BSphereIndex;
+}
+
+void CollidableGroup::removeBSphere(int BSphereIndex)
+{
+	// The last BSphere was swapped into the removed index, so its owner must be told
+	Collidable* pSwappedCollidable = _BSpheres.removeAt(BSphereIndex);
+	if (pSwappedCollidable != nullptr)
+	{
+		pSwappedCollidable->_deleteReference.BSphereIndex = BSphereIndex;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Refresh
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollidableGroup::markForRefresh(Collidable* pCollidable)
+{
+	StorageReference& storageReference = pCollidable->_deleteReference;
+	if (storageReference.isMarkedForRefresh) return;
+
+	storageReference.isMarkedForRefresh = true;
+	_markedCollidables.push_back(pCollidable);
+}
+
+void CollidableGroup::refreshMarkedBSpheres()
+{
+	for (Collidable* pCollidable : _markedCollidables)
+	{
+		refreshBSphere(pCollidable);
+		pCollidable->_deleteReference.isMarkedForRefresh = false;
+	}
+	_markedCollidables.clear();
+}
+
+void CollidableGroup::refreshBSphere(Collidable* pCollidable)
+{
+	const int BSphereIndex = pCollidable->_deleteReference.BSphereIndex;
+
+	// A BSphere that was on the bounds may have moved away from them (bounds can shrink),
+	// otherwise the bounds can only grow to fit the BSphere
+	const bool wasOnBounds = isOnBounds(BSphereIndex);
+
+	_BSpheres.set(BSphereIndex, pCollidable->getBSphere());
+	_BSpheres.setActivity(BSphereIndex, pCollidable->_lastActiveFrame, pCollidable->_isStatic);
+
+	if (wasOnBounds)
+	{
+		_isBoundsRecomputeNeeded = true;
+	}
+	else
+	{
+		expandBounds(BSphereIndex);
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Bounds
+//-----------------------------------------------------------------------------------------------------------------------------
+bool CollidableGroup::isOnBounds(int BSphereIndex) const
+{
+	Vect minVertex;
+	Vect maxVertex;
+	_BSpheres.getBoundsAt(BSphereIndex, minVertex, maxVertex);
+
+	// Bounds are built from the same values, so exact comparison is intended
+	return minVertex[x] == _minVertex[x] || minVertex[y] == _minVertex[y] || minVertex[z] == _minVertex[z]
+		|| maxVertex[x] == _maxVertex[x] || maxVertex[y] == _maxVertex[y] || maxVertex[z] == _maxVertex[z];
+}
+
+void CollidableGroup::expandBounds(int BSphereIndex)
+{
+	Vect minVertex;
+	Vect maxVertex;
+	_BSpheres.getBoundsAt(BSphereIndex, minVertex, maxVertex);
+
+	if (!MathTools::IsLessThan(_minVertex, minVertex) || !MathTools::IsGreaterThan(_maxVertex, maxVertex))
+	{
+		_minVertex = MathTools::Min(_minVertex, minVertex);
+		_maxVertex = MathTools::Max(_maxVertex, maxVertex);
+		_isGroupAABBOutdated = true;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Group AABB
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollidableGroup::updateGroupAABB(FrameCount currentFrame)
+{
+	if (isEmpty()) return;
+
+	if (!_markedCollidables.empty())
+	{
+		refreshMarkedBSpheres();
+		_isRestingUpdateNeeded = true;
+	}
+
+	// Resting states only change on refresh/registration or when an awake member falls asleep
+	if (_isRestingUpdateNeeded || (_numberOfAwake > 0 && currentFrame >= _nextRestingUpdateFrame))
+	{
+		_numberOfAwake = _BSpheres.updateRestingStates(currentFrame, Collidable::SLEEP_FRAME_COUNT, _nextRestingUpdateFrame);
+		_isRestingUpdateNeeded = false;
+	}
+
+	// Full reduction only when a member on the bounds moved inward or left
+	if (_isBoundsRecomputeNeeded)
+	{
+		BatchTools::ComputeBounds(_BSpheres, _minVertex, _maxVertex);
+		_isBoundsRecomputeNeeded = false;
+		_isGroupAABBOutdated = true;
+	}
+
+	if (_isGroupAABBOutdated)
+	{
+		_pGroupAABB->computeData(_minVertex, _maxVertex);
+		_isGroupAABBOutdated = false;
+	}
+}
+
+bool CollidableGroup::isAtRest() const
+{
+	return _numberOfAwake == 0;
+}
+
+const CollisionVolumeAABB& CollidableGroup::getGroupAABB() const
+{
+	return *_pGroupAABB;
+}
+
+const BSphereCollection& CollidableGroup::getBSphereCollection() const
+{
+	return _BSpheres;
+}
\ No newline at end of file
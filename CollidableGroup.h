@@ -0,0 +1,163 @@
+#ifndef _CollidableGroup
+#define _CollidableGroup
+
+#include <vector>
+#include "BSphereCollection.h"
+#include "Vect.h"
+
+class Collidable;
+class CollisionVolumeAABB;
+
+/**********************************************************************************************//**
+ * <summary> Group of collidables sharing the same collision type.
+ *			 Holds the group AABB enclosing every member and a structure-of-arrays copy
+ *			 of the members' BSpheres used by the collision test commands. </summary>
+ *
+ * <remarks> Owned by the CollisionManager. Members are stored contiguously (swap-remove).
+ *			 Only the BSpheres of members marked for refresh are copied again on update. The
+ *			 group bounds are grown from those members and only fully recomputed when a member
+ *			 on the bounds moves or leaves. </remarks>
+ **************************************************************************************************/
+class CollidableGroup
+{
+	typedef std::vector<Collidable*> CollidableCollection;
+
+public:
+	typedef BSphereCollection::CollidableCollection Collection;
+	typedef BSphereCollection::FrameCount FrameCount;
+
+	/**********************************************************************************************//**
+	 * <summary> Reference kept by a registered collidable to find itself in the group.</summary>
+	 *
+	 * <remarks> Only modified by the group. </remarks>
+	 **************************************************************************************************/
+	struct StorageReference
+	{
+		int BSphereIndex = -1;
+		bool isMarkedForRefresh = false;
+	};
+
+public:
+	CollidableGroup();
+	CollidableGroup(const CollidableGroup&) = delete;
+	CollidableGroup& operator=(const CollidableGroup&) = delete;
+	CollidableGroup(CollidableGroup&&) = delete;
+	CollidableGroup& operator=(CollidableGroup&&) = delete;
+	~CollidableGroup();
+
+	/**********************************************************************************************//**
+	 * <summary> Registers the entity described by pCollidable.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="pCollidable"> The collidable to add.</param>
+	 * <param name="deleteReference"> Output of the reference used to deregister.</param>
+	 **************************************************************************************************/
+	void registerEntity(Collidable* pCollidable, StorageReference& deleteReference);
+
+	/**********************************************************************************************//**
+	 * <summary> Deregisters the entity described by deleteReference.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="deleteReference"> The reference given on registration.</param>
+	 **************************************************************************************************/
+	void deregisterEntity(const StorageReference& deleteReference);
+
+	/**********************************************************************************************//**
+	 * <summary> Registers many collidables at once.</summary>
+	 *
+	 * <remarks> Each collidable's reference is its own StorageReference. The group bounds and
+	 *			 resting states are recomputed once, on the next update. </remarks>
+	 *
+	 * <param name="pCollidables"> The collidables to add.</param>
+	 * <param name="count"> The number of collidables.</param>
+	 **************************************************************************************************/
+	void registerEntities(Collidable* const* pCollidables, size_t count);
+
+	/**********************************************************************************************//**
+	 * <summary> Deregisters many members at once.</summary>
+	 *
+	 * <remarks> The group bounds and resting states are recomputed once, on the next update. </remarks>
+	 *
+	 * <param name="pCollidables"> The members to remove.</param>
+	 * <param name="count"> The number of members.</param>
+	 **************************************************************************************************/
+	void deregisterEntities(Collidable* const* pCollidables, size_t count);
+
+	const Collection& getColliderCollection() const;
+	bool isEmpty() const;
+
+	/**********************************************************************************************//**
+	 * <summary> Marks a member so its BSphere and activity are copied on the next update.</summary>
+	 *
+	 * <remarks> Called when the member moved, was woken or changed its static state.
+	 *			 Marking the same member more than once per update is ignored. </remarks>
+	 *
+	 * <param name="pCollidable"> The registered collidable.</param>
+	 **************************************************************************************************/
+	void markForRefresh(Collidable* pCollidable);
+
+	/**********************************************************************************************//**
+	 * <summary> Refreshes the marked BSpheres, then the resting states and the group AABB if needed.</summary>
+	 *
+	 * <remarks> Called only by CollisionManager::processCollisions(), before any command executes.
+	 *			 Does nothing for an empty group. </remarks>
+	 *
+	 * <param name="currentFrame"> The current frame.</param>
+	 **************************************************************************************************/
+	void updateGroupAABB(FrameCount currentFrame);
+
+	/**********************************************************************************************//**
+	 * <summary> Query if every member is at rest (static or asleep).</summary>
+	 *
+	 * <remarks> Valid after updateGroupAABB() for the current frame. </remarks>
+	 *
+	 * <returns> True if at rest, false if not.</returns>
+	 **************************************************************************************************/
+	bool isAtRest() const;
+
+	const CollisionVolumeAABB& getGroupAABB() const;
+
+	/**********************************************************************************************//**
+	 * <summary> Gets the structure-of-arrays copy of the members' BSpheres.</summary>
+	 *
+	 * <remarks> Valid after updateGroupAABB() for the current frame. </remarks>
+	 *
+	 * <returns> The BSphere collection.</returns>
+	 **************************************************************************************************/
+	const BSphereCollection& getBSphereCollection() const;
+
+private:
+	// Registration/Deregistration helpers
+	int addBSphere(Collidable* pCollidable, StorageReference& deleteReference);
+	void removeBSphere(int BSphereIndex);
+
+	void refreshMarkedBSpheres();
+	void refreshBSphere(Collidable* pCollidable);
+
+	// Bounds
+	bool isOnBounds(int BSphereIndex) const;
+	void expandBounds(int BSphereIndex);
+
+private:
+	BSphereCollection _BSpheres;
+	CollidableCollection _markedCollidables;
+	CollisionVolumeAABB* _pGroupAABB;
+
+	// Bounds
+	Vect _minVertex;
+	Vect _maxVertex;
+	bool _isGroupAABBOutdated;
+	bool _isBoundsRecomputeNeeded;
+
+	// Resting
+	int _numberOfAwake;
+	FrameCount _nextRestingUpdateFrame;
+	bool _isRestingUpdateNeeded;
+};
+#endif // !_CollidableGroup
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollidableGroup Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
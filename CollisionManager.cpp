@@ -2,13 +2,38 @@
 #include "CollidableGroup.h"
 #include "CollisionTestCommand.h"
 #include "CollisionVolumeAABB.h"
+#include "CollisionVolumeBSphere.h"
+#include "CollisionVolumeOBB.h"
+#include "CollisionVolumeOctree.h"
+#include "Collidable.h"
+#include "CollisionTimeline.h"
+#include "BatchTools.h"
 #include "Visualizer.h"
 #include "Colors.h"
+#include <cassert>
+#include <algorithm>
 
 CollisionManager::CollisionTypeID CollisionManager::NextCollisionIDNumber = 0;
 const size_t CollisionManager::MAX_GROUP_SIZE = 20;
 
+namespace
+{
+	const char* GetExecuteSpanName(CollisionRecorder::CommandType commandType)
+	{
+		switch (commandType)
+		{
+		case CollisionRecorder::CommandType::SELF:
+			return "CollisionTestSelfCommand::execute";
+		case CollisionRecorder::CommandType::PAIR:
+			return "CollisionTestPairCommand::execute";
+		default:
+			return "CollisionTestTerrainCommand::execute";
+		}
+	}
+}
+
 CollisionManager::CollisionManager()
+	: _pRecorder(nullptr), _frameCount(0)
 {
 	_collidableGroups.resize(CollisionManager::MAX_GROUP_SIZE, nullptr);
 
@@ -50,16 +75,428 @@ void CollisionManager::deinitializeCollisionTestCommands()
 //-----------------------------------------------------------------------------------------------------------------------------
 void CollisionManager::processCollisions()
 {
-	// First update all group AABBs before...
-	for (CollidableGroup* pCollidableGroup : _collidableGroups)
+	typedef CollisionFrameStats::Stage Stage;
+
+	CollisionTimelineScope frameScope("CollisionManager::processCollisions", "frame", _frameCount);
+
+	_lastFrameStats.reset();
+	_lastFrameStats.frame = _frameCount;
+	_lastFrameStats.hasDetailedCounters = CollisionCounters::IsEnabled();
+	_lastFrameStats.hasHardwareCounters = HardwareCounters::IsOpen();
+	HardwareCounterValues stageHardwareCountersStart = HardwareCounters::Read();
+	StageClock::time_point stageStart = StageClock::now();
+
+	// Apply the batch registrations (including the ones from other threads) then...
+	{
+		CollisionTimelineScope registrationScope("CollisionManager::applyRegistrations");
+		drainConcurrentRequests();
+		applyPendingDeregistrations();
+		applyPendingRegistrations();
+	}
+	endStage(Stage::REGISTRATION, stageStart, stageHardwareCountersStart);
+
+	// update all group AABBs (and their BSphere collections) before...
+	for (size_t collisionTypeID = 0; collisionTypeID < _collidableGroups.size(); collisionTypeID++)
 	{
-		pCollidableGroup->updateGroupAABB();
+		CollidableGroup* pCollidableGroup = _collidableGroups[collisionTypeID];
+		if (pCollidableGroup == nullptr || pCollidableGroup->isEmpty()) continue;
+
+		CollisionTimelineScope groupScope("CollidableGroup::updateGroupAABB", "collision type", static_cast<long long>(collisionTypeID));
+		pCollidableGroup->updateGroupAABB(_frameCount);
 	}
+	endStage(Stage::GROUP_UPDATE, stageStart, stageHardwareCountersStart);
 
-	// Executing the commands to test the collision
+	// Executing the commands to find the candidate pairs then...
+	int commandIndex = 0;
 	for (CollisionTestCommand* pCommand : _collisionTestCommands)
 	{
-		pCommand->execute();
+		CollisionTimelineScope commandScope(GetExecuteSpanName(_commandDescriptions[commandIndex].commandType), "command", commandIndex);
+		commandIndex++;
+
+		pCommand->resetStats();
+		if (_lastFrameStats.hasHardwareCounters)
+		{
+			const HardwareCounterValues executeStart = HardwareCounters::Read();
+			pCommand->execute();
+			pCommand->setHardwareCounters(HardwareCounters::Read() - executeStart);
+		}
+		else
+		{
+			pCommand->execute();
+		}
+	}
+	endStage(Stage::BROAD_PHASE, stageStart, stageHardwareCountersStart);
+
+	// test their collision volumes, one volume type pair at a time
+	{
+		CollisionTimelineScope narrowPhaseScope("NarrowPhase::process");
+		_narrowPhase.process();
+	}
+	endStage(Stage::NARROW_PHASE, stageStart, stageHardwareCountersStart);
+
+	// gather the stats of the commands (the narrow phase adds to them while counting)
+	for (CollisionTestCommand* pCommand : _collisionTestCommands)
+	{
+		_lastFrameStats.commands.push_back(pCommand->getStats());
+		_lastFrameStats.totals += pCommand->getStats();
+	}
+
+	_lastFrameStats.narrowPhaseTests = _narrowPhase.getLastTestCount();
+	_lastFrameStats.collisions = _narrowPhase.getLastCollisionCount();
+
+	if (_pRecorder != nullptr)
+	{
+		_pRecorder->recordFrame(_lastFrameStats);
+	}
+
+	_frameCount++;
+}
+
+void CollisionManager::endStage(CollisionFrameStats::Stage stage, StageClock::time_point& stageStart, HardwareCounterValues& stageHardwareCountersStart)
+{
+	const StageClock::time_point stageEnd = StageClock::now();
+	_lastFrameStats.stageSeconds[static_cast<int>(stage)] = std::chrono::duration<double>(stageEnd - stageStart).count();
+	stageStart = stageEnd;
+
+	if (_lastFrameStats.hasHardwareCounters)
+	{
+		const HardwareCounterValues stageHardwareCountersEnd = HardwareCounters::Read();
+		_lastFrameStats.stageHardwareCounters[static_cast<int>(stage)] = stageHardwareCountersEnd - stageHardwareCountersStart;
+		stageHardwareCountersStart = stageHardwareCountersEnd;
+	}
+}
+
+const CollisionFrameStats& CollisionManager::getLastFrameStats() const
+{
+	return _lastFrameStats;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Recording
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionManager::setRecorder(CollisionRecorder* pRecorder)
+{
+	_pRecorder = pRecorder;
+	_narrowPhase.setRecorder(pRecorder);
+
+	if (_pRecorder == nullptr) return;
+
+	// The log starts from the current state
+	for (const CommandDescription& description : _commandDescriptions)
+	{
+		_pRecorder->recordCommand(description.commandType, description.collisionTypeID_1, description.collisionTypeID_2);
+	}
+
+	for (CollidableGroup* pCollidableGroup : _collidableGroups)
+	{
+		for (Collidable* pCollidable : pCollidableGroup->getColliderCollection())
+		{
+			_pRecorder->recordRegistration(*pCollidable);
+		}
+	}
+}
+
+CollisionRecorder* CollisionManager::getRecorder() const
+{
+	return _pRecorder;
+}
+
+void CollisionManager::addCommandDescription(CollisionRecorder::CommandType commandType, CollisionTypeID collisionTypeID_1, CollisionTypeID collisionTypeID_2)
+{
+	_commandDescriptions.push_back({ commandType, collisionTypeID_1, collisionTypeID_2 });
+
+	if (_pRecorder != nullptr)
+	{
+		_pRecorder->recordCommand(commandType, collisionTypeID_1, collisionTypeID_2);
+	}
+}
+
+CollisionManager::FrameCount CollisionManager::getFrameCount() const
+{
+	return _frameCount;
+}
+
+CollisionVolumeStorage& CollisionManager::getCollisionVolumeStorage()
+{
+	return _collisionVolumeStorage;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Batch Registration
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionManager::submitRegistrations(Collidable* const* pCollidables, size_t count)
+{
+	_pendingRegistrations.reserve(_pendingRegistrations.size() + count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		addPendingRegistration(pCollidables[i]);
+	}
+}
+
+void CollisionManager::submitDeregistrations(Collidable* const* pCollidables, size_t count)
+{
+	_pendingDeregistrations.reserve(_pendingDeregistrations.size() + count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		addPendingDeregistration(pCollidables[i]);
+	}
+}
+
+void CollisionManager::submitConcurrentRegistration(Collidable* pCollidable)
+{
+	_concurrentRequests.push(&pCollidable->_registrationRequest);
+}
+
+void CollisionManager::submitConcurrentDeregistration(Collidable* pCollidable)
+{
+	_concurrentRequests.push(&pCollidable->_deregistrationRequest);
+}
+
+void CollisionManager::drainConcurrentRequests()
+{
+	CollisionRequestQueue::Node* pRequest = _concurrentRequests.drain();
+
+	while (pRequest != nullptr)
+	{
+		// Read before handling, the node may be pushed again once handled
+		CollisionRequestQueue::Node* pNextRequest = pRequest->pNext;
+		Collidable* pCollidable = pRequest->pCollidable;
+
+		// Checked at runtime: the state may have changed since the request was submitted
+		const RegistrationState registrationState = pCollidable->_currentRegistrationState;
+		if (pRequest->requestType == CollisionRequestQueue::RequestType::REGISTRATION)
+		{
+			if (registrationState == RegistrationState::CURRENTLY_DEREGISTERED)
+			{
+				addPendingRegistration(pCollidable);
+			}
+			else if (registrationState == RegistrationState::PENDING_DEREGISTRATION)
+			{
+				// Deregistered and registered again before being applied: cancel the deregistration
+				cancelPendingRequest(pRequest, _pendingDeregistrations, RegistrationState::CURRENTLY_REGISTERED);
+			}
+			// Already registered (or pending): the request is dropped
+		}
+		else
+		{
+			if (registrationState == RegistrationState::CURRENTLY_REGISTERED)
+			{
+				addPendingDeregistration(pCollidable);
+			}
+			else if (registrationState == RegistrationState::PENDING_REGISTRATION)
+			{
+				// Registered and deregistered before ever being applied: cancel the registration
+				cancelPendingRequest(pRequest, _pendingRegistrations, RegistrationState::CURRENTLY_DEREGISTERED);
+			}
+			// Already deregistered (or pending): the request is dropped
+		}
+
+		pRequest = pNextRequest;
+	}
+}
+
+void CollisionManager::cancelPendingRequest(CollisionRequestQueue::Node* pRequest, CollidableCollection& pendingCollidables, RegistrationState cancelledState)
+{
+	Collidable* pCollidable = pRequest->pCollidable;
+	CollidableCollection::iterator it = std::find(pendingCollidables.begin(), pendingCollidables.end(), pCollidable);
+	if (it != pendingCollidables.end())
+	{
+		pendingCollidables.erase(it);
+		pCollidable->_currentRegistrationState = cancelledState;
+	}
+	else
+	{
+		// Pending as a scene command (Collidable::submitCollision(De)Registration()), which
+		// cannot be cancelled: retried at the next drain, once the command ran
+		_concurrentRequests.push(pRequest);
+	}
+}
+
+void CollisionManager::addPendingRegistration(Collidable* pCollidable)
+{
+	assert(pCollidable->_currentRegistrationState == RegistrationState::CURRENTLY_DEREGISTERED);
+	pCollidable->_currentRegistrationState = RegistrationState::PENDING_REGISTRATION;
+	_pendingRegistrations.push_back(pCollidable);
+}
+
+void CollisionManager::addPendingDeregistration(Collidable* pCollidable)
+{
+	assert(pCollidable->_currentRegistrationState == RegistrationState::CURRENTLY_REGISTERED);
+	pCollidable->_currentRegistrationState = RegistrationState::PENDING_DEREGISTRATION;
+	_pendingDeregistrations.push_back(pCollidable);
+}
+
+void CollisionManager::applyPendingDeregistrations()
+{
+	if (_pendingDeregistrations.empty()) return;
+
+	// Each run of the same collision type is removed from its group in one pass
+	sortByCollisionTypeID(_pendingDeregistrations);
+
+	size_t start = 0;
+	while (start < _pendingDeregistrations.size())
+	{
+		const size_t end = findEndOfCollisionTypeID(_pendingDeregistrations, start);
+		CollidableGroup* pCollidableGroup = getCollidableGroup(_pendingDeregistrations[start]->_myCollisionTypeID);
+		pCollidableGroup->deregisterEntities(&_pendingDeregistrations[start], end - start);
+		start = end;
+	}
+
+	for (Collidable* pCollidable : _pendingDeregistrations)
+	{
+		pCollidable->_pCollidableGroup = nullptr;
+		pCollidable->_currentRegistrationState = RegistrationState::CURRENTLY_DEREGISTERED;
+
+		if (_pRecorder != nullptr)
+		{
+			_pRecorder->recordDeregistration(*pCollidable);
+		}
+	}
+
+	_pendingDeregistrations.clear();
+}
+
+void CollisionManager::applyPendingRegistrations()
+{
+	if (_pendingRegistrations.empty()) return;
+
+	// Each run of the same collision type is added to its group in one pass
+	sortByCollisionTypeID(_pendingRegistrations);
+
+	size_t start = 0;
+	while (start < _pendingRegistrations.size())
+	{
+		const size_t end = findEndOfCollisionTypeID(_pendingRegistrations, start);
+		CollidableGroup* pCollidableGroup = getCollidableGroup(_pendingRegistrations[start]->_myCollisionTypeID);
+
+		for (size_t i = start; i < end; i++)
+		{
+			_pendingRegistrations[i]->_pCollidableGroup = pCollidableGroup;
+			_pendingRegistrations[i]->_currentRegistrationState = RegistrationState::CURRENTLY_REGISTERED;
+		}
+
+		pCollidableGroup->registerEntities(&_pendingRegistrations[start], end - start);
+		start = end;
+	}
+
+	if (_pRecorder != nullptr)
+	{
+		for (Collidable* pCollidable : _pendingRegistrations)
+		{
+			_pRecorder->recordRegistration(*pCollidable);
+		}
+	}
+
+	_pendingRegistrations.clear();
+}
+
+void CollisionManager::sortByCollisionTypeID(CollidableCollection& collidables) const
+{
+	std::stable_sort(collidables.begin(), collidables.end(),
+		[](const Collidable* pCollidable_1, const Collidable* pCollidable_2)
+		{
+			return pCollidable_1->_myCollisionTypeID < pCollidable_2->_myCollisionTypeID;
+		});
+}
+
+size_t CollisionManager::findEndOfCollisionTypeID(const CollidableCollection& collidables, size_t start) const
+{
+	const CollisionTypeID collisionTypeID = collidables[start]->_myCollisionTypeID;
+
+	size_t end = start + 1;
+	while (end < collidables.size() && collidables[end]->_myCollisionTypeID == collisionTypeID)
+	{
+		end++;
+	}
+	return end;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Batch Update
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionManager::updateCollisionData(Collidable* const* pCollidables, const Matrix* worldMatrices, size_t count)
+{
+	// Pass 1: keep only the collidables that actually moved
+	gatherMovedCollidables(pCollidables, worldMatrices, count);
+
+	// Pass 2: move all their BSpheres at once
+	updateMovedBSpheres();
+
+	// Pass 3: update their collision volumes
+	updateMovedCollisionVolumes();
+}
+
+void CollisionManager::gatherMovedCollidables(Collidable* const* pCollidables, const Matrix* worldMatrices, size_t count)
+{
+	_movedCollidables.clear();
+	_movedCollidables.reserve(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		Collidable* pCollidable = pCollidables[i];
+		const Matrix& worldMatrix = worldMatrices[i];
+
+		if (!worldMatrix.isEqual(pCollidable->_lastWorldMatrix))
+		{
+			pCollidable->markAsMoved(worldMatrix, _frameCount);
+			_movedCollidables.push_back(pCollidable);
+
+			if (_pRecorder != nullptr)
+			{
+				_pRecorder->recordMove(*pCollidable, worldMatrix);
+			}
+		}
+	}
+}
+
+void CollisionManager::updateMovedBSpheres()
+{
+	_transformBatch.clear();
+	_transformBatch.reserve(_movedCollidables.size());
+
+	for (Collidable* pCollidable : _movedCollidables)
+	{
+		_transformBatch.add(pCollidable->_localBSphereCenter, pCollidable->_localBSphereRadius, pCollidable->_lastWorldMatrix);
+	}
+
+	BatchTools::TransformBSpheres(_transformBatch);
+
+	for (size_t i = 0; i < _movedCollidables.size(); i++)
+	{
+		const int index = static_cast<int>(i);
+		_movedCollidables[i]->_pBSphere->computeData(_transformBatch.getWorldCenterAt(index), _transformBatch.getWorldRadiusAt(index));
+	}
+}
+
+void CollisionManager::updateMovedCollisionVolumes()
+{
+	// Qualified calls on the concrete type skip the virtual dispatch
+	for (Collidable* pCollidable : _movedCollidables)
+	{
+		CollisionVolume* pCollisionVolume = pCollidable->_pCollisionVolume;
+		Model* pColliderModel = pCollidable->_pColliderModel;
+		const Matrix& worldMatrix = pCollidable->_lastWorldMatrix;
+
+		switch (pCollisionVolume->getType())
+		{
+		case CollisionVolume::Type::BSPHERE:
+			static_cast<CollisionVolumeBSphere*>(pCollisionVolume)->CollisionVolumeBSphere::computeData(pColliderModel, worldMatrix);
+			break;
+		case CollisionVolume::Type::AABB:
+			static_cast<CollisionVolumeAABB*>(pCollisionVolume)->CollisionVolumeAABB::computeData(pColliderModel, worldMatrix);
+			break;
+		case CollisionVolume::Type::OBB:
+			static_cast<CollisionVolumeOBB*>(pCollisionVolume)->CollisionVolumeOBB::computeData(pColliderModel, worldMatrix);
+			break;
+		case CollisionVolume::Type::OCTREE:
+			static_cast<CollisionVolumeOctree*>(pCollisionVolume)->CollisionVolumeOctree::computeData(pColliderModel, worldMatrix);
+			break;
+		default:
+			assert(false);
+			break;
+		}
 	}
 }
 
@@ -3,24 +3,45 @@
 
 #include <vector>
 #include <list>
+#include <chrono>
 
 #include "CollisionDispatch.h"
 #include "CollisionTestPairCommand.h"
 #include "CollisionTestSelfCommand.h"
 #include "CollisionTestTerrainCommand.h"
+#include "BSphereTransformBatch.h"
+#include "NarrowPhase.h"
+#include "CollisionVolumeStorage.h"
+#include "CollisionRequestQueue.h"
+#include "CollisionStats.h"
+#include "CollisionRecorder.h"
+#include "RegistrationStates.h"
 
 class CollidableGroup;
 class CollisionTestCommand;
 class Collidable;
+class Matrix;
 
 class CollisionManager
 {
 public:
 	typedef int CollisionTypeID;
 	static const CollisionTypeID ID_UNDEFINED = -1;
+	typedef unsigned int FrameCount;
 private:
 	typedef std::vector<CollidableGroup*> GroupCollection;
 	typedef std::list<CollisionTestCommand*> StorageList;
+	typedef std::vector<Collidable*> CollidableCollection;
+	typedef std::chrono::steady_clock StageClock;
+
+	// Test commands set so far, written at the start of a recording
+	struct CommandDescription
+	{
+		CollisionRecorder::CommandType commandType;
+		CollisionTypeID collisionTypeID_1;
+		CollisionTypeID collisionTypeID_2;
+	};
+	typedef std::vector<CommandDescription> CommandDescriptionCollection;
 
 public:
 	CollisionManager();
@@ -39,12 +60,15 @@ public:
 	template<class UserClass1, class UserClass2>
 	void setCollisionPair()
 	{
-		CollidableGroup* collidablegroup1 = _collidableGroups.at(getCollisionTypeID<UserClass1>());
-		CollidableGroup* collidablegroup2 = _collidableGroups.at(getCollisionTypeID<UserClass2>());
+		const CollisionTypeID collisionTypeID1 = getCollisionTypeID<UserClass1>();
+		const CollisionTypeID collisionTypeID2 = getCollisionTypeID<UserClass2>();
+		CollidableGroup* collidablegroup1 = _collidableGroups.at(collisionTypeID1);
+		CollidableGroup* collidablegroup2 = _collidableGroups.at(collisionTypeID2);
 	
 		CollisionDispatch<UserClass1, UserClass2>* pDispatch = new CollisionDispatch<UserClass1, UserClass2>();
 	
-		_collisionTestCommands.push_back(new CollisionTestPairCommand(collidablegroup1, collidablegroup2, pDispatch));
+		_collisionTestCommands.push_back(new CollisionTestPairCommand(collidablegroup1, collidablegroup2, pDispatch, &_narrowPhase));
+		addCommandDescription(CollisionRecorder::CommandType::PAIR, collisionTypeID1, collisionTypeID2);
 	}
 
 	/**********************************************************************************************//**
@@ -55,11 +79,13 @@ public:
 	template<class UserClass>
 	void setCollisionSelf()
 	{
-		CollidableGroup* collidablegroup = _collidableGroups.at(getCollisionTypeID<UserClass>());
+		const CollisionTypeID collisionTypeID = getCollisionTypeID<UserClass>();
+		CollidableGroup* collidablegroup = _collidableGroups.at(collisionTypeID);
 	
 		CollisionDispatch<UserClass, UserClass>* pDispatch = new CollisionDispatch<UserClass, UserClass>();
 	
-		_collisionTestCommands.push_back(new CollisionTestSelfCommand(collidablegroup, pDispatch));
+		_collisionTestCommands.push_back(new CollisionTestSelfCommand(collidablegroup, pDispatch, &_narrowPhase));
+		addCommandDescription(CollisionRecorder::CommandType::SELF, collisionTypeID, collisionTypeID);
 	}
 
 	/**********************************************************************************************//**
@@ -70,9 +96,11 @@ public:
 	template<class UserClass>
 	void setCollisionTerrain()
 	{
-		CollidableGroup* collidablegroup = _collidableGroups.at(getCollisionTypeID<UserClass>());
+		const CollisionTypeID collisionTypeID = getCollisionTypeID<UserClass>();
+		CollidableGroup* collidablegroup = _collidableGroups.at(collisionTypeID);
 
 		_collisionTestCommands.push_back(new CollisionTestTerrainCommand(collidablegroup));
+		addCommandDescription(CollisionRecorder::CommandType::TERRAIN, collisionTypeID, collisionTypeID);
 	}
 
 	/**********************************************************************************************//**
@@ -111,6 +139,117 @@ public:
 	 **************************************************************************************************/
 	void processCollisions();
 
+	/**********************************************************************************************//**
+	 * <summary> Updates the collision data of many collidables at once.</summary>
+	 *
+	 * <remarks> Batch version of Collidable::updateCollisionData(). Collidables whose world matrix
+	 *			 did not change are skipped; the others are marked as moved for the current frame.
+	 *			 BSpheres are moved to world space in one SIMD pass, then the collision volumes. </remarks>
+	 *
+	 * <param name="pCollidables"> The collidables to update.</param>
+	 * <param name="worldMatrices"> The world matrix of each collidable (same order).</param>
+	 * <param name="count"> The number of collidables.</param>
+	 **************************************************************************************************/
+	void updateCollisionData(Collidable* const* pCollidables, const Matrix* worldMatrices, size_t count);
+
+	/**********************************************************************************************//**
+	 * <summary> Submits the registration of many collidables at once.</summary>
+	 *
+	 * <remarks> Batch version of Collidable::submitCollisionRegistration(). Collidables must have
+	 *			 their collider model and collidable group set. They are added to their groups
+	 *			 at the start of the next processCollisions(), one pass per group. </remarks>
+	 *
+	 * <param name="pCollidables"> The collidables to register.</param>
+	 * <param name="count"> The number of collidables.</param>
+	 **************************************************************************************************/
+	void submitRegistrations(Collidable* const* pCollidables, size_t count);
+
+	/**********************************************************************************************//**
+	 * <summary> Submits the deregistration of many collidables at once.</summary>
+	 *
+	 * <remarks> Batch version of Collidable::submitCollisionDeregistration(). Collidables are removed
+	 *			 from their groups at the start of the next processCollisions() (before the pending
+	 *			 registrations), one pass per group. </remarks>
+	 *
+	 * <param name="pCollidables"> The collidables to deregister.</param>
+	 * <param name="count"> The number of collidables.</param>
+	 **************************************************************************************************/
+	void submitDeregistrations(Collidable* const* pCollidables, size_t count);
+
+	/**********************************************************************************************//**
+	 * <summary> Submits the registration of a collidable from any thread.</summary>
+	 *
+	 * <remarks> Lock-free and allocation free. The request is drained at the start of the next
+	 *			 processCollisions() (on the main thread) and then applied like submitRegistrations().
+	 *			 A collidable must not submit the same request twice before it is drained.
+	 *			 ONLY the submission is thread-safe: Collidable::setColliderModel() and
+	 *			 Collidable::setCollidableGroup() share the OctreeModelManager, the volume storage
+	 *			 and the collision type IDs with processCollisions(), and MUST run on the main
+	 *			 thread before the collidable is handed to another thread. </remarks>
+	 *
+	 * <param name="pCollidable"> The collidable to register.</param>
+	 **************************************************************************************************/
+	void submitConcurrentRegistration(Collidable* pCollidable);
+
+	/**********************************************************************************************//**
+	 * <summary> Submits the deregistration of a collidable from any thread.</summary>
+	 *
+	 * <remarks> Same as submitConcurrentRegistration(). A request drained while the opposite one is
+	 *			 still pending cancels it. A request pending as a scene command
+	 *			 (Collidable::submitCollision(De)Registration()) cannot be cancelled, the request is
+	 *			 then retried at the next drain. A request that would not change the state (already
+	 *			 deregistered, or a duplicate) is dropped. </remarks>
+	 *
+	 * <param name="pCollidable"> The collidable to deregister.</param>
+	 **************************************************************************************************/
+	void submitConcurrentDeregistration(Collidable* pCollidable);
+
+	/**********************************************************************************************//**
+	 * <summary> Gets the current frame count.</summary>
+	 *
+	 * <remarks> Incremented at the end of every processCollisions(). </remarks>
+	 *
+	 * <returns> The frame count.</returns>
+	 **************************************************************************************************/
+	FrameCount getFrameCount() const;
+
+	/**********************************************************************************************//**
+	 * <summary> Gets the storage of the collision volumes of the collidables.</summary>
+	 *
+	 * <remarks> Used by Collidable when its collider model is set (Collidable::VolumeStorageMode::SCENE).
+	 *			 Collidables using it must be destroyed before this manager. </remarks>
+	 *
+	 * <returns> The collision volume storage.</returns>
+	 **************************************************************************************************/
+	CollisionVolumeStorage& getCollisionVolumeStorage();
+
+	/**********************************************************************************************//**
+	 * <summary> Gets the statistics of the last processCollisions().</summary>
+	 *
+	 * <remarks> Time spent in each stage, and candidate counts of every broad phase tier and of
+	 *			 the narrow phase, per command and in total. The detailed counters are filled in
+	 *			 while CollisionCounters::SetEnabled(true), the CPU events of each stage and command
+	 *			 once HardwareCounters::Open() succeeded on this thread. Used by the profiling
+	 *			 tools. </remarks>
+	 *
+	 * <returns> The statistics of the last frame.</returns>
+	 **************************************************************************************************/
+	const CollisionFrameStats& getLastFrameStats() const;
+
+	/**********************************************************************************************//**
+	 * <summary> Starts or stops recording the collision frames.</summary>
+	 *
+	 * <remarks> The recording starts with the test commands and the collidables registered so far,
+	 *			 then follows every (de)registration, move, collision and frame. The recorder is
+	 *			 not owned. </remarks>
+	 *
+	 * <param name="pRecorder"> The recorder, nullptr to stop recording.</param>
+	 **************************************************************************************************/
+	void setRecorder(CollisionRecorder* pRecorder);
+
+	// The current recorder (nullptr when not recording)
+	CollisionRecorder* getRecorder() const;
+
 private:	
 	// Setting Collidable Group
 	void setGroupForTypeID(CollisionTypeID);
@@ -119,6 +258,27 @@ private:
 	bool isValidIndex(CollisionTypeID) const;
 	void resizeToFit(CollisionTypeID);
 
+	// Batch registration helpers
+	void drainConcurrentRequests();
+	void cancelPendingRequest(CollisionRequestQueue::Node* pRequest, CollidableCollection& pendingCollidables, RegistrationState cancelledState);
+	void addPendingRegistration(Collidable* pCollidable);
+	void addPendingDeregistration(Collidable* pCollidable);
+	void applyPendingDeregistrations();
+	void applyPendingRegistrations();
+	void sortByCollisionTypeID(CollidableCollection& collidables) const;
+	size_t findEndOfCollisionTypeID(const CollidableCollection& collidables, size_t start) const;
+
+	// Batch update helpers
+	void gatherMovedCollidables(Collidable* const* pCollidables, const Matrix* worldMatrices, size_t count);
+	void updateMovedBSpheres();
+	void updateMovedCollisionVolumes();
+
+	// Recording
+	void addCommandDescription(CollisionRecorder::CommandType commandType, CollisionTypeID collisionTypeID_1, CollisionTypeID collisionTypeID_2);
+
+	// Statistics
+	void endStage(CollisionFrameStats::Stage stage, StageClock::time_point& stageStart, HardwareCounterValues& stageHardwareCountersStart);
+
 	// Deinitializaton
 	void deinitializeCollisionGroups();
 	void deinitializeCollisionTestCommands();
@@ -128,6 +288,30 @@ private:
 
 	GroupCollection _collidableGroups;
 	StorageList _collisionTestCommands;
+
+	// Batch registrations applied on the next processCollisions()
+	CollidableCollection _pendingRegistrations;
+	CollidableCollection _pendingDeregistrations;
+
+	// Registrations submitted from any thread, drained into the batch registrations
+	CollisionRequestQueue _concurrentRequests;
+
+	// Batch update scratch data (kept to reuse their storage)
+	CollidableCollection _movedCollidables;
+	BSphereTransformBatch _transformBatch;
+
+	// Collision volumes of every collidable, contiguous per volume type
+	CollisionVolumeStorage _collisionVolumeStorage;
+
+	// Candidate pairs queued by the commands, tested once they all executed
+	NarrowPhase _narrowPhase;
+
+	CollisionFrameStats _lastFrameStats;
+
+	CommandDescriptionCollection _commandDescriptions;
+	CollisionRecorder* _pRecorder;
+
+	FrameCount _frameCount;
 	
 	static const size_t MAX_GROUP_SIZE;
 };
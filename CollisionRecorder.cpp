@@ -0,0 +1,215 @@
+#include "CollisionRecorder.h"
+#include "CollisionStats.h"
+#include "Collidable.h"
+#include "CollisionVolumeOctree.h"
+#include "OctreeModelManager.h"
+#include "AzulCore.h"
+#include <cassert>
+#include <cstring>
+
+const unsigned int CollisionRecorder::FILE_MAGIC;
+const unsigned int CollisionRecorder::FORMAT_VERSION;
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Checksum
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionPairChecksum::add(unsigned int recordID_1, unsigned int recordID_2)
+{
+	const unsigned long long low = (recordID_1 < recordID_2) ? recordID_1 : recordID_2;
+	const unsigned long long high = (recordID_1 < recordID_2) ? recordID_2 : recordID_1;
+
+	// SplitMix64 finalizer, so that sums of different pairs rarely cancel out
+	unsigned long long hash = (high << 32) | low;
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBULL;
+	hash = hash ^ (hash >> 31);
+
+	count++;
+	sum += hash;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Log
+//-----------------------------------------------------------------------------------------------------------------------------
+CollisionRecorder::CollisionRecorder(const char* path)
+	: _pFile(fopen(path, "wb")), _nextCollidableID(0), _nextModelID(0), _frameCount(0)
+{
+	if (_pFile == nullptr) return;
+
+	write(CollisionRecorder::FILE_MAGIC);
+	write(CollisionRecorder::FORMAT_VERSION);
+	write(OctreeModelManager::GetFrameMode());
+	fwrite(_buffer.data(), 1, _buffer.size(), _pFile);
+	_buffer.clear();
+}
+
+CollisionRecorder::~CollisionRecorder()
+{
+	if (_pFile != nullptr)
+	{
+		fclose(_pFile);
+	}
+}
+
+bool CollisionRecorder::isOpen() const
+{
+	return _pFile != nullptr;
+}
+
+unsigned int CollisionRecorder::getFrameCount() const
+{
+	return _frameCount;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Recording
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionRecorder::recordCommand(CommandType commandType, int collisionTypeID_1, int collisionTypeID_2)
+{
+	write(RecordType::COMMAND);
+	write(commandType);
+	write(collisionTypeID_1);
+	write(collisionTypeID_2);
+}
+
+void CollisionRecorder::recordRegistration(const Collidable& collidable)
+{
+	const RecordID collidableID = getCollidableID(collidable);
+	const RecordID modelID = getModelID(collidable._pColliderModel);
+
+	const CollisionVolume& collisionVolume = collidable.getCollisionVolume();
+	const unsigned char hasWorld = collidable._lastWorldMatrix.isEqual(Matrix(ZERO)) ? 0 : 1;
+
+	// The depth the Octree was requested with (getMaxDepth() is the deepest level below the root)
+	unsigned char octreeDepth = 0;
+	OctreeTools::BuildMode octreeBuildMode = OctreeTools::BuildMode::UNIFORM;
+	if (collisionVolume.getType() == CollisionVolume::Type::OCTREE)
+	{
+		const CollisionVolumeOctree& octree = static_cast<const CollisionVolumeOctree&>(collisionVolume);
+		octreeDepth = static_cast<unsigned char>(octree.getMaxDepth() + 1);
+		octreeBuildMode = octree.getBuildMode();
+	}
+
+	write(RecordType::REGISTRATION);
+	write(collidableID);
+	write(collidable._myCollisionTypeID);
+	write(collisionVolume.getType());
+	write(octreeDepth);
+	write(octreeBuildMode);
+	write(static_cast<unsigned char>(collidable._isStatic ? 1 : 0));
+	write(modelID);
+	write(hasWorld);
+	if (hasWorld)
+	{
+		writeMatrix(collidable._lastWorldMatrix);
+	}
+}
+
+void CollisionRecorder::recordDeregistration(const Collidable& collidable)
+{
+	write(RecordType::DEREGISTRATION);
+	write(getCollidableID(collidable));
+
+	// The address may be reused by a collidable created later
+	_collidableIDs.erase(&collidable);
+}
+
+void CollisionRecorder::recordMove(const Collidable& collidable, const Matrix& world)
+{
+	write(RecordType::MOVE);
+	write(getCollidableID(collidable));
+	writeMatrix(world);
+}
+
+void CollisionRecorder::recordCollision(const Collidable& collidable_1, const Collidable& collidable_2)
+{
+	_checksum.add(getCollidableID(collidable_1), getCollidableID(collidable_2));
+}
+
+void CollisionRecorder::recordFrame(const CollisionFrameStats& frameStats)
+{
+	write(RecordType::FRAME);
+	write(frameStats.frame);
+	for (double seconds : frameStats.stageSeconds)
+	{
+		write(static_cast<float>(seconds));
+	}
+	write(frameStats.narrowPhaseTests);
+	write(_checksum.count);
+	write(_checksum.sum);
+
+	if (_pFile != nullptr)
+	{
+		fwrite(_buffer.data(), 1, _buffer.size(), _pFile);
+	}
+	_buffer.clear();
+	_checksum.reset();
+	_frameCount++;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Helpers
+//-----------------------------------------------------------------------------------------------------------------------------
+CollisionRecorder::RecordID CollisionRecorder::getCollidableID(const Collidable& collidable)
+{
+	const RecordIDMap::const_iterator it = _collidableIDs.find(&collidable);
+	if (it != _collidableIDs.end()) return it->second;
+
+	_collidableIDs.emplace(&collidable, _nextCollidableID);
+	return _nextCollidableID++;
+}
+
+CollisionRecorder::RecordID CollisionRecorder::getModelID(Model* pModel)
+{
+	assert(pModel != nullptr);
+
+	const RecordIDMap::const_iterator it = _modelIDs.find(pModel);
+	if (it != _modelIDs.end()) return it->second;
+
+	// First use of the model: its geometry goes in the log
+	const RecordID modelID = _nextModelID++;
+	_modelIDs.emplace(pModel, modelID);
+
+	const unsigned int vectCount = static_cast<unsigned int>(pModel->getVectNum());
+	const unsigned int triangleCount = static_cast<unsigned int>(pModel->getTriNum());
+	const Vect* pVects = pModel->getVectList();
+	const TriangleIndex* pTriangles = pModel->getTriangleList();
+
+	write(RecordType::MODEL);
+	write(modelID);
+	write(vectCount);
+	for (unsigned int i = 0; i < vectCount; i++)
+	{
+		write(pVects[i][x]);
+		write(pVects[i][y]);
+		write(pVects[i][z]);
+	}
+	write(triangleCount);
+	for (unsigned int i = 0; i < triangleCount; i++)
+	{
+		write(static_cast<unsigned int>(pTriangles[i].v0));
+		write(static_cast<unsigned int>(pTriangles[i].v1));
+		write(static_cast<unsigned int>(pTriangles[i].v2));
+	}
+
+	return modelID;
+}
+
+void CollisionRecorder::write(const void* pData, size_t size)
+{
+	const size_t offset = _buffer.size();
+	_buffer.resize(offset + size);
+	memcpy(_buffer.data() + offset, pData, size);
+}
+
+void CollisionRecorder::writeMatrix(const Matrix& matrix)
+{
+	const MatrixRowType rows[] = { ROW_0, ROW_1, ROW_2, ROW_3 };
+	for (MatrixRowType row : rows)
+	{
+		const Vect& vect = matrix.get(row);
+		write(vect[x]);
+		write(vect[y]);
+		write(vect[z]);
+	}
+}
@@ -0,0 +1,144 @@
+#ifndef _CollisionRecorder
+#define _CollisionRecorder
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+class Collidable;
+class Matrix;
+class Model;
+struct CollisionFrameStats;
+
+/**********************************************************************************************//**
+ * <summary> Order independent checksum of the collision pairs of a frame.</summary>
+ *
+ * <remarks> Pairs are identified by the record IDs of their collidables, in any order. The
+ *			 same pairs give the same checksum whatever order they are reported in. </remarks>
+ **************************************************************************************************/
+struct CollisionPairChecksum
+{
+	unsigned int count = 0;
+	unsigned long long sum = 0;
+
+	void add(unsigned int recordID_1, unsigned int recordID_2);
+
+	void reset()
+	{
+		count = 0;
+		sum = 0;
+	}
+};
+
+/**********************************************************************************************//**
+ * <summary> Records the collision frames of a CollisionManager into a compact binary log.</summary>
+ *
+ * <remarks> Attached with CollisionManager::setRecorder(). The log holds the test commands, the
+ *			 registrations (collider model, volume type, collision group, world matrix), the
+ *			 deregistrations, the world matrix of every collidable that moved and, for every
+ *			 frame, its stage timings and the checksum of its collision pairs. CollisionReplay
+ *			 (Tools/) feeds a log back through a CollisionManager. Main thread only.
+ *
+ *			 Layout: FILE_MAGIC, FORMAT_VERSION, the u8 OctreeTools::FrameMode of the
+ *			 OctreeModelManager when the log is opened, then records made of a RecordType byte and
+ *			 its fields (native byte order, no padding). A frame's records end with its FRAME record.
+ *			 Collider models are written once, the first time a collidable using them registers.
+ *			 </remarks>
+ **************************************************************************************************/
+class CollisionRecorder
+{
+public:
+	typedef unsigned int RecordID;
+
+	static const unsigned int FILE_MAGIC = 0x4C524357; // "WCRL"
+	static const unsigned int FORMAT_VERSION = 3;
+
+	enum class RecordType : unsigned char
+	{
+		// RecordID model, u32 vertex count, vertex count * 3 floats, u32 triangle count, triangle count * 3 u32
+		MODEL,
+		// u8 CommandType, i32 collision type ID 1, i32 collision type ID 2
+		COMMAND,
+		// RecordID collidable, i32 collision type ID, u8 volume type, u8 octree depth, u8 octree build
+		// mode, u8 is static, RecordID model, u8 has world, [12 floats: rows 0 to 3, x y z]
+		REGISTRATION,
+		// RecordID collidable
+		DEREGISTRATION,
+		// RecordID collidable, 12 floats: rows 0 to 3, x y z
+		MOVE,
+		// u32 frame, 4 floats stage seconds, u32 narrow phase tests, u32 collisions, u64 checksum
+		FRAME
+	};
+
+	enum class CommandType : unsigned char
+	{
+		SELF,
+		PAIR,
+		TERRAIN
+	};
+
+public:
+	CollisionRecorder() = delete;
+	CollisionRecorder(const CollisionRecorder&) = delete;
+	CollisionRecorder& operator=(const CollisionRecorder&) = delete;
+	CollisionRecorder(CollisionRecorder&&) = delete;
+	CollisionRecorder& operator=(CollisionRecorder&&) = delete;
+
+	/**********************************************************************************************//**
+	 * <summary> Opens the log.</summary>
+	 *
+	 * <param name="path"> Path of the log file (overwritten).</param>
+	 **************************************************************************************************/
+	explicit CollisionRecorder(const char* path);
+
+	// Closes the log (the records of an unfinished frame are dropped)
+	~CollisionRecorder();
+
+	bool isOpen() const;
+
+	// Number of frames recorded so far
+	unsigned int getFrameCount() const;
+
+	// Recording, called by the collision system only
+	void recordCommand(CommandType commandType, int collisionTypeID_1, int collisionTypeID_2);
+	void recordRegistration(const Collidable& collidable);
+	void recordDeregistration(const Collidable& collidable);
+	void recordMove(const Collidable& collidable, const Matrix& world);
+	void recordCollision(const Collidable& collidable_1, const Collidable& collidable_2);
+	void recordFrame(const CollisionFrameStats& frameStats);
+
+private:
+	typedef std::unordered_map<const void*, RecordID> RecordIDMap;
+
+	RecordID getCollidableID(const Collidable& collidable);
+	RecordID getModelID(Model* pModel);
+
+	void write(const void* pData, size_t size);
+
+	template <typename Value>
+	void write(const Value& value)
+	{
+		write(&value, sizeof(Value));
+	}
+
+	void writeMatrix(const Matrix& matrix);
+
+private:
+	FILE* _pFile;
+
+	// Records of the current frame, written at once by recordFrame()
+	std::vector<unsigned char> _buffer;
+
+	RecordIDMap _collidableIDs;
+	RecordIDMap _modelIDs;
+	RecordID _nextCollidableID;
+	RecordID _nextModelID;
+
+	CollisionPairChecksum _checksum;
+	unsigned int _frameCount;
+};
+#endif // !_CollisionRecorder
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionRecorder Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,31 @@
+#include "CollisionRequestQueue.h"
+
+CollisionRequestQueue::CollisionRequestQueue()
+	: _pHead(nullptr)
+{}
+
+void CollisionRequestQueue::push(Node* pNode)
+{
+	Node* pHead = _pHead.load(std::memory_order_relaxed);
+	do
+	{
+		pNode->pNext = pHead;
+	} while (!_pHead.compare_exchange_weak(pHead, pNode, std::memory_order_release, std::memory_order_relaxed));
+}
+
+CollisionRequestQueue::Node* CollisionRequestQueue::drain()
+{
+	Node* pNode = _pHead.exchange(nullptr, std::memory_order_acquire);
+
+	// Reverse the list so requests come out in the order they were pushed
+	Node* pFirst = nullptr;
+	while (pNode != nullptr)
+	{
+		Node* pNext = pNode->pNext;
+		pNode->pNext = pFirst;
+		pFirst = pNode;
+		pNode = pNext;
+	}
+
+	return pFirst;
+}
\ No newline at end of file
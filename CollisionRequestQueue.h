@@ -0,0 +1,71 @@
+#ifndef _CollisionRequestQueue
+#define _CollisionRequestQueue
+
+#include <atomic>
+
+class Collidable;
+
+/**********************************************************************************************//**
+ * <summary> Lock-free multi-producer, single-consumer queue of collision registration and
+ *			 deregistration requests.</summary>
+ *
+ * <remarks> Intrusive: every Collidable owns one node per request type, so pushing never
+ *			 allocates. Any thread may push. Only the main thread drains, through
+ *			 CollisionManager::processCollisions(). A node must not be pushed again before
+ *			 it has been drained. </remarks>
+ **************************************************************************************************/
+class CollisionRequestQueue
+{
+public:
+	enum class RequestType
+	{
+		REGISTRATION,
+		DEREGISTRATION
+	};
+
+	struct Node
+	{
+		Node(Collidable* pCollidable, RequestType requestType)
+			: pCollidable(pCollidable), requestType(requestType), pNext(nullptr)
+		{}
+
+		Collidable* const pCollidable;
+		const RequestType requestType;
+		Node* pNext;
+	};
+
+public:
+	CollisionRequestQueue();
+	CollisionRequestQueue(const CollisionRequestQueue&) = delete;
+	CollisionRequestQueue& operator=(const CollisionRequestQueue&) = delete;
+	CollisionRequestQueue(CollisionRequestQueue&&) = delete;
+	CollisionRequestQueue& operator=(CollisionRequestQueue&&) = delete;
+	~CollisionRequestQueue() = default;
+
+	/**********************************************************************************************//**
+	 * <summary> Pushes a request. Thread-safe, lock-free.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="pNode"> The request node (owned by the collidable).</param>
+	 **************************************************************************************************/
+	void push(Node* pNode);
+
+	/**********************************************************************************************//**
+	 * <summary> Takes every request pushed so far.</summary>
+	 *
+	 * <remarks> Single consumer only. Requests pushed during the drain go to the next one. </remarks>
+	 *
+	 * <returns> The first request, following pNext in the order they were pushed (nullptr if empty).</returns>
+	 **************************************************************************************************/
+	Node* drain();
+
+private:
+	// Requests are pushed at the head (most recent first)
+	std::atomic<Node*> _pHead;
+};
+#endif // !_CollisionRequestQueue
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionRequestQueue Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
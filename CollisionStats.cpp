@@ -0,0 +1,18 @@
+#include "CollisionStats.h"
+
+namespace
+{
+	bool IsCountingEnabled = false;
+}
+
+thread_local CollisionCommandStats* CollisionCounters::pActiveStats = nullptr;
+
+void CollisionCounters::SetEnabled(bool isEnabled)
+{
+	IsCountingEnabled = isEnabled;
+}
+
+bool CollisionCounters::IsEnabled()
+{
+	return IsCountingEnabled;
+}
@@ -0,0 +1,196 @@
+#ifndef _CollisionStats
+#define _CollisionStats
+
+#include <vector>
+#include "CollisionVolume.h"
+#include "HardwareCounters.h"
+
+/**********************************************************************************************//**
+ * <summary> Work done by a collision test command, for one frame.</summary>
+ *
+ * <remarks> Broad phase tiers are always counted. Each tier only tests what passed the previous
+ *			 one: group AABBs (pair commands), then BSpheres against the other group's AABB (pair
+ *			 commands), then BSphere pairs. BSphere pairs that pass, unless both are at rest, go to
+ *			 the narrow phase.
+ *
+ *			 The detailed counters (narrow phase per volume type pair, Octree traversals, separating
+ *			 axes, callbacks) are only counted while CollisionCounters is enabled. </remarks>
+ **************************************************************************************************/
+struct CollisionCommandStats
+{
+	static const int NUMBER_OF_TYPES = static_cast<int>(CollisionVolume::Type::COUNT);
+
+	// Broad phase tiers
+	unsigned int groupAABBTests = 0;
+	unsigned int groupAABBPasses = 0;
+
+	unsigned int BSphereCullTests = 0;
+	unsigned int BSphereCullPasses = 0;
+
+	unsigned int BSpherePairTests = 0;
+	unsigned int BSpherePairPasses = 0;
+
+	unsigned int narrowPhasePairs = 0;
+
+	// Detailed counters, indexed by volume type with the lower type first
+	unsigned int narrowPhaseTests[NUMBER_OF_TYPES][NUMBER_OF_TYPES] = {};
+	unsigned int narrowPhaseHits[NUMBER_OF_TYPES][NUMBER_OF_TYPES] = {};
+
+	// Nodes tested by Octree-volume traversals and node pairs tested by Octree-Octree traversals
+	unsigned long long octreeNodeVisits = 0;
+	unsigned long long octreeNodePairVisits = 0;
+
+	// Separating axes projected by the box-box and box-triangle tests
+	unsigned long long SATAxes = 0;
+
+	// Collision callbacks called (one per collidable of a colliding pair)
+	unsigned int callbacks = 0;
+
+	// CPU events of execute(), while HardwareCounters is open
+	HardwareCounterValues hardwareCounters;
+
+	void reset()
+	{
+		*this = CollisionCommandStats();
+	}
+
+	unsigned int getNarrowPhaseTests(CollisionVolume::Type type_1, CollisionVolume::Type type_2) const
+	{
+		return (type_1 < type_2) ? narrowPhaseTests[static_cast<int>(type_1)][static_cast<int>(type_2)]
+			: narrowPhaseTests[static_cast<int>(type_2)][static_cast<int>(type_1)];
+	}
+
+	unsigned int getNarrowPhaseHits(CollisionVolume::Type type_1, CollisionVolume::Type type_2) const
+	{
+		return (type_1 < type_2) ? narrowPhaseHits[static_cast<int>(type_1)][static_cast<int>(type_2)]
+			: narrowPhaseHits[static_cast<int>(type_2)][static_cast<int>(type_1)];
+	}
+
+	CollisionCommandStats& operator+=(const CollisionCommandStats& other)
+	{
+		groupAABBTests += other.groupAABBTests;
+		groupAABBPasses += other.groupAABBPasses;
+		BSphereCullTests += other.BSphereCullTests;
+		BSphereCullPasses += other.BSphereCullPasses;
+		BSpherePairTests += other.BSpherePairTests;
+		BSpherePairPasses += other.BSpherePairPasses;
+		narrowPhasePairs += other.narrowPhasePairs;
+
+		for (int type_1 = 0; type_1 < NUMBER_OF_TYPES; type_1++)
+		{
+			for (int type_2 = 0; type_2 < NUMBER_OF_TYPES; type_2++)
+			{
+				narrowPhaseTests[type_1][type_2] += other.narrowPhaseTests[type_1][type_2];
+				narrowPhaseHits[type_1][type_2] += other.narrowPhaseHits[type_1][type_2];
+			}
+		}
+		octreeNodeVisits += other.octreeNodeVisits;
+		octreeNodePairVisits += other.octreeNodePairVisits;
+		SATAxes += other.SATAxes;
+		callbacks += other.callbacks;
+		hardwareCounters += other.hardwareCounters;
+		return *this;
+	}
+};
+
+/**********************************************************************************************//**
+ * <summary> Timings and counters of one CollisionManager::processCollisions().</summary>
+ *
+ * <remarks> Timings and broad phase tiers are always collected: a few clock reads per frame and
+ *			 one increment per candidate. </remarks>
+ **************************************************************************************************/
+struct CollisionFrameStats
+{
+	enum class Stage
+	{
+		REGISTRATION,
+		GROUP_UPDATE,
+		BROAD_PHASE,
+		NARROW_PHASE,
+		COUNT
+	};
+
+	typedef std::vector<CollisionCommandStats> CommandStatsCollection;
+
+	unsigned int frame = 0;
+	double stageSeconds[static_cast<int>(Stage::COUNT)] = {};
+
+	// True when the detailed counters were enabled for the frame
+	bool hasDetailedCounters = false;
+
+	// True when HardwareCounters was open on the thread, filling in the CPU events of each
+	// stage and of each command's execute()
+	bool hasHardwareCounters = false;
+	HardwareCounterValues stageHardwareCounters[static_cast<int>(Stage::COUNT)];
+
+	// Each command, in the order they were set on the CollisionManager, then their sum
+	CommandStatsCollection commands;
+	CollisionCommandStats totals;
+
+	unsigned int narrowPhaseTests = 0;
+	unsigned int collisions = 0;
+
+	// Clears the stats, keeping the storage of the command stats
+	void reset()
+	{
+		CommandStatsCollection keptCommands;
+		keptCommands.swap(commands);
+		keptCommands.clear();
+
+		*this = CollisionFrameStats();
+		commands.swap(keptCommands);
+	}
+
+	double getStageSeconds(Stage stage) const
+	{
+		return stageSeconds[static_cast<int>(stage)];
+	}
+
+	const HardwareCounterValues& getStageHardwareCounters(Stage stage) const
+	{
+		return stageHardwareCounters[static_cast<int>(stage)];
+	}
+
+	double getTotalSeconds() const
+	{
+		double totalSeconds = 0.0;
+		for (double seconds : stageSeconds)
+		{
+			totalSeconds += seconds;
+		}
+		return totalSeconds;
+	}
+};
+
+/**********************************************************************************************//**
+// namespace: CollisionCounters
+//
+// summary:	Runtime switch of the detailed counters of CollisionCommandStats.
+//
+// remarks:	Disabled by default. While enabled, the narrow phase makes the stats of each pair's
+//			command active on its thread before testing it, and the MathTools kernels add to the
+//			active stats. A disabled kernel only pays one thread local load and a branch.
+ **************************************************************************************************/
+namespace CollisionCounters
+{
+	void SetEnabled(bool isEnabled);
+	bool IsEnabled();
+
+	// Stats the kernels of this thread add to (nullptr when not counting)
+	extern thread_local CollisionCommandStats* pActiveStats;
+
+	inline CollisionCommandStats* GetActive()
+	{
+		return pActiveStats;
+	}
+
+	inline void SetActive(CollisionCommandStats* pStats)
+	{
+		pActiveStats = pStats;
+	}
+};
+#endif // !_CollisionStats
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionStats Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
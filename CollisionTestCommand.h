@@ -1,6 +1,8 @@
 #ifndef _CollisionTestCommand
 #define _CollisionTestCommand
 
+#include "CollisionStats.h"
+
 class CollisionTestCommand
 {
 public:
@@ -12,6 +14,26 @@ public:
 	virtual ~CollisionTestCommand() = default;
 
 	virtual void execute() = 0;
+
+	// Candidate counts since the last resetStats() (reset by the CollisionManager every frame)
+	const CollisionCommandStats& getStats() const
+	{
+		return _stats;
+	}
+
+	void resetStats()
+	{
+		_stats.reset();
+	}
+
+	// CPU events of the last execute(), read by the CollisionManager
+	void setHardwareCounters(const HardwareCounterValues& hardwareCounters)
+	{
+		_stats.hardwareCounters = hardwareCounters;
+	}
+
+protected:
+	CollisionCommandStats _stats;
 };
 #endif // !_CollisionTestCommand
 
@@ -1,9 +1,11 @@
 #include "CollisionTestPairCommand.h"
 #include "CollidableGroup.h"
 #include "CollisionDispatch.h"
+#include "NarrowPhase.h"
 #include "Collidable.h"
 #include "CollisionVolumeAABB.h"
 #include "CollisionVolumeBSphere.h"
+#include "BSphereCollection.h"
 #include "MathTools.h"
 #include "Visualizer.h"
 #include "Colors.h"
@@ -12,10 +14,11 @@
 #define CollisionTestPairCommand_DEBUG 0
 #endif // !CollisionTestPairCommand_DEBUG
 
-CollisionTestPairCommand::CollisionTestPairCommand(CollidableGroup* pCollidableGroup1, CollidableGroup* pCollidableGroup2, CollisionDispatchBase* pCollisionDispatch)
+CollisionTestPairCommand::CollisionTestPairCommand(CollidableGroup* pCollidableGroup1, CollidableGroup* pCollidableGroup2, CollisionDispatchBase* pCollisionDispatch, NarrowPhase* pNarrowPhase)
 	: _pCollidableGroup_1(pCollidableGroup1),
 	_pCollidableGroup_2(pCollidableGroup2),
-	_pCollisionDispatch(pCollisionDispatch)
+	_pCollisionDispatch(pCollisionDispatch),
+	_pNarrowPhase(pNarrowPhase)
 {}
 
 CollisionTestPairCommand::~CollisionTestPairCommand()
@@ -32,25 +35,38 @@ void CollisionTestPairCommand::execute()
 // Execute helpers
 //-----------------------------------------------------------------------------------------------------------------------------
 
-void CollisionTestPairCommand::testCollisionGroups(CollidableGroup* pCollidableGroup_1, CollidableGroup* pCollidableGroup_2) const
+void CollisionTestPairCommand::testCollisionGroups(CollidableGroup* pCollidableGroup_1, CollidableGroup* pCollidableGroup_2)
 {
 	if (pCollidableGroup_1->isEmpty() || pCollidableGroup_2->isEmpty()) return;
 
+	// Nothing can have changed between two groups at rest
+	if (pCollidableGroup_1->isAtRest() && pCollidableGroup_2->isAtRest()) return;
+
 	const CollisionVolumeAABB& groupAABB_1 = pCollidableGroup_1->getGroupAABB();
 	const CollisionVolumeAABB& groupAABB_2 = pCollidableGroup_2->getGroupAABB();
 
 	// If group AABB 1 collides with group AABB 2 then...
+	_stats.groupAABBTests++;
 	if (MathTools::Intersect(groupAABB_1, groupAABB_2))
 	{
+		_stats.groupAABBPasses++;
+
 #if CollisionTestPairCommand_DEBUG
 		Visualizer::ShowCollisionVolume(groupAABB_1, Colors::Red);
 		Visualizer::ShowCollisionVolume(groupAABB_2, Colors::Red);
 #endif // CollisionTestPairCommand_DEBUG
 
-		const CollidableGroup::Collection& collection_1 = _pCollidableGroup_1->getColliderCollection();
-		for (Collidable* pCollidable_1 : collection_1)
+		// Batch test every BSphere of group 1 against group AABB 2 and...
+		const BSphereCollection& BSpheres_1 = pCollidableGroup_1->getBSphereCollection();
+		_candidates_1.clear();
+		BatchTools::CullBSpheres(BSpheres_1, groupAABB_2.getMinWorldVertex(), groupAABB_2.getMaxWorldVertex(), _candidates_1);
+		_stats.BSphereCullTests += static_cast<unsigned int>(BSpheres_1.getSize());
+		_stats.BSphereCullPasses += static_cast<unsigned int>(_candidates_1.size());
+
+		// only the BSpheres that collide go on to be tested against group 2
+		for (int index_1 : _candidates_1)
 		{
-			testCollidableAgainstCollisionGroup(pCollidable_1, pCollidableGroup_2);
+			testBSphereAgainstCollisionGroup(BSpheres_1, index_1, pCollidableGroup_2);
 		}
 	}
 	else
@@ -62,78 +78,37 @@ void CollisionTestPairCommand::testCollisionGroups(CollidableGroup* pCollidableG
 	}
 }
 
-void CollisionTestPairCommand::testCollidableAgainstCollisionGroup(Collidable* pCollidable_1, CollidableGroup* pCollidableGroup_2) const
+void CollisionTestPairCommand::testBSphereAgainstCollisionGroup(const BSphereCollection& BSpheres_1, int index_1, CollidableGroup* pCollidableGroup_2)
 {
-	const CollisionVolumeBSphere& BSphere_1 = pCollidable_1->getBSphere();
-	const CollisionVolumeAABB& groupAABB_2 = pCollidableGroup_2->getGroupAABB();
+	// A BSphere at rest only needs to be tested against the members of group 2 that are not
+	const bool isAtRest_1 = BSpheres_1.isAtRestAt(index_1);
+	if (isAtRest_1 && pCollidableGroup_2->isAtRest()) return;
 
-	// If collidable's BSphere_1 1 collides with group AABB 2 then...
-	if (MathTools::Intersect(BSphere_1, groupAABB_2))
-	{
-#if CollisionTestPairCommand_DEBUG
-		Visualizer::ShowCollisionVolume(BSphere_1, Colors::Red);
-		Visualizer::ShowCollisionVolume(groupAABB_2, Colors::Red);
-#endif // CollisionTestPairCommand_DEBUG
+	Collidable* pCollidable_1 = BSpheres_1.getCollidableAt(index_1);
 
-		const CollidableGroup::Collection& collection_2 = _pCollidableGroup_2->getColliderCollection();
-		for (Collidable* pCollidable_2 : collection_2)
-		{
-			testCollidablesBSphere(pCollidable_1, pCollidable_2);
-		}
-	}
-	else
-	{
 #if CollisionTestPairCommand_DEBUG
-		Visualizer::ShowCollisionVolume(BSphere_1);
-		Visualizer::ShowCollisionVolume(groupAABB_2);
+	Visualizer::ShowCollisionVolume(pCollidable_1->getBSphere(), Colors::Red);
 #endif // CollisionTestPairCommand_DEBUG
-	}
-}
-
-void CollisionTestPairCommand::testCollidablesBSphere(Collidable* pCollidable_1, Collidable* pCollidable_2) const
-{
-	const CollisionVolumeBSphere& BSphere_1 = pCollidable_1->getBSphere();
-	const CollisionVolumeBSphere& BSphere_2 = pCollidable_2->getBSphere();
 
-	// If collidables's BSphere_1 1 collides with collidable'2 BSphere_1 2 then..
-	if (MathTools::Intersect(BSphere_1, BSphere_2))
-	{
-#if CollisionTestPairCommand_DEBUG
-		Visualizer::ShowCollisionVolume(BSphere_1, Colors::Red);
-		Visualizer::ShowCollisionVolume(BSphere_2, Colors::Red);
-#endif // CollisionTestPairCommand_DEBUG
+	// Batch test BSphere 1 against every BSphere of group 2 then...
+	const BSphereCollection& BSpheres_2 = pCollidableGroup_2->getBSphereCollection();
+	_candidates_2.clear();
+	BatchTools::CullBSpheres(BSpheres_2, 0, BSpheres_1.getCenterAt(index_1), BSpheres_1.getRadiusAt(index_1), _candidates_2);
+	_stats.BSpherePairTests += static_cast<unsigned int>(BSpheres_2.getSize());
+	_stats.BSpherePairPasses += static_cast<unsigned int>(_candidates_2.size());
 
-		testCollidablesCollisionVolume(pCollidable_1, pCollidable_2);
-	}
-	else
+	// queue the collision volumes of every pair whose BSpheres collide for the narrow phase
+	for (int index_2 : _candidates_2)
 	{
-#if CollisionTestPairCommand_DEBUG
-		Visualizer::ShowCollisionVolume(BSphere_1);
-		Visualizer::ShowCollisionVolume(BSphere_2);
-#endif // CollisionTestPairCommand_DEBUG
-	}
-}
+		if (isAtRest_1 && BSpheres_2.isAtRestAt(index_2)) continue;
 
-void CollisionTestPairCommand::testCollidablesCollisionVolume(Collidable* pCollidable_1, Collidable* pCollidable_2) const
-{
-	const CollisionVolume& collisionVolume_1 = pCollidable_1->getCollisionVolume();
-	const CollisionVolume& collisionVolume_2 = pCollidable_2->getCollisionVolume();
+		Collidable* pCollidable_2 = BSpheres_2.getCollidableAt(index_2);
 
-	// If collidables's collision volume 1 collides with collidables's collision volume 2 then..
-	if (MathTools::Intersect(collisionVolume_1, collisionVolume_2))
-	{
 #if CollisionTestPairCommand_DEBUG
-		Visualizer::ShowCollisionVolume(collisionVolume_1, Colors::Red);
-		Visualizer::ShowCollisionVolume(collisionVolume_2, Colors::Red);
+		Visualizer::ShowCollisionVolume(pCollidable_2->getBSphere(), Colors::Red);
 #endif // CollisionTestPairCommand_DEBUG
 
-		_pCollisionDispatch->processCallBacks(pCollidable_1, pCollidable_2);
-	}
-	else
-	{
-#if CollisionTestPairCommand_DEBUG
-		Visualizer::ShowCollisionVolume(collisionVolume_1, Colors::Green);
-		Visualizer::ShowCollisionVolume(collisionVolume_2, Colors::Green);
-#endif // CollisionTestPairCommand_DEBUG
+		_pNarrowPhase->addPair(pCollidable_1, pCollidable_2, _pCollisionDispatch, &_stats);
+		_stats.narrowPhasePairs++;
 	}
 }
\ No newline at end of file
@@ -2,10 +2,13 @@
 #define _CollisionTestPairCommand
 
 #include "CollisionTestCommand.h"
+#include "BatchTools.h"
 
 class CollidableGroup;
 class CollisionDispatchBase;
 class Collidable;
+class BSphereCollection;
+class NarrowPhase;
 
 class CollisionTestPairCommand : public CollisionTestCommand
 {
@@ -17,22 +20,25 @@ public:
 	CollisionTestPairCommand& operator=(CollisionTestPairCommand&&) = default;
 	~CollisionTestPairCommand();
 
-	CollisionTestPairCommand(CollidableGroup*, CollidableGroup*, CollisionDispatchBase*);
+	CollisionTestPairCommand(CollidableGroup*, CollidableGroup*, CollisionDispatchBase*, NarrowPhase*);
 
 	// Inherited via CollisionTestCommand
 	virtual void execute() override;
 
 private:
 	// Execute helpers
-	void testCollisionGroups(CollidableGroup*, CollidableGroup*) const;
-	void testCollidableAgainstCollisionGroup(Collidable*, CollidableGroup*) const;
-	void testCollidablesBSphere(Collidable*, Collidable*) const;
-	void testCollidablesCollisionVolume(Collidable*, Collidable*) const;
+	void testCollisionGroups(CollidableGroup*, CollidableGroup*);
+	void testBSphereAgainstCollisionGroup(const BSphereCollection&, int, CollidableGroup*);
 
 private:
 	CollidableGroup* _pCollidableGroup_1;
 	CollidableGroup* _pCollidableGroup_2;
 	CollisionDispatchBase* _pCollisionDispatch;
+	NarrowPhase* _pNarrowPhase;
+
+	// Candidate indices output by the batch BSphere tiers (kept to reuse their storage)
+	BatchTools::IndexCollection _candidates_1;
+	BatchTools::IndexCollection _candidates_2;
 
 };
 #endif // !_CollisionTestPairCommand
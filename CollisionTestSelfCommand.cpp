@@ -1,9 +1,11 @@
 #include "CollisionTestSelfCommand.h"
 #include "CollidableGroup.h"
 #include "CollisionDispatch.h"
+#include "NarrowPhase.h"
 #include "Collidable.h"
 #include "CollisionVolumeAABB.h"
 #include "CollisionVolumeBSphere.h"
+#include "BSphereCollection.h"
 #include "MathTools.h"
 #include "Visualizer.h"
 #include "Colors.h"
@@ -12,9 +14,10 @@
 #define CollisionTestSelfCommand_DEBUG 0
 #endif // !CollisionTestSelfCommand_DEBUG
 
-CollisionTestSelfCommand::CollisionTestSelfCommand(CollidableGroup* pCollidableGroup, CollisionDispatchBase* pCollisionDispatch)
+CollisionTestSelfCommand::CollisionTestSelfCommand(CollidableGroup* pCollidableGroup, CollisionDispatchBase* pCollisionDispatch, NarrowPhase* pNarrowPhase)
 	: _pCollidableGroup(pCollidableGroup),
-	_pCollisionDispatch(pCollisionDispatch)
+	_pCollisionDispatch(pCollisionDispatch),
+	_pNarrowPhase(pNarrowPhase)
 {}
 
 CollisionTestSelfCommand::~CollisionTestSelfCommand()
@@ -30,65 +33,39 @@ void CollisionTestSelfCommand::execute()
 //-----------------------------------------------------------------------------------------------------------------------------
 // Execute helpers
 //-----------------------------------------------------------------------------------------------------------------------------
-void CollisionTestSelfCommand::testCollisionGroup(CollidableGroup* pCollidableGroup) const
+void CollisionTestSelfCommand::testCollisionGroup(CollidableGroup* pCollidableGroup)
 {
-	const CollidableGroup::Collection& collection = pCollidableGroup->getColliderCollection();
+	// Nothing can have changed in a group at rest
+	if (pCollidableGroup->isAtRest()) return;
 
-	for (auto current = collection.begin(); current != collection.end(); current++)
-	{
-		for (auto afterCurrent = std::next(current); afterCurrent != collection.end(); afterCurrent++)
-		{
-			Collidable* pCollidable_1 = *current;
-			Collidable* pCollidable_2 = *afterCurrent;
-			testCollidablesBSphere(pCollidable_1, pCollidable_2);
-		}
-	}
-}
-
-void CollisionTestSelfCommand::testCollidablesBSphere(Collidable* pCollidable_1, Collidable* pCollidable_2) const
-{
-	const CollisionVolumeBSphere& BSphere_1 = pCollidable_1->getBSphere();
-	const CollisionVolumeBSphere& BSphere_2 = pCollidable_2->getBSphere();
+	const BSphereCollection& BSpheres = pCollidableGroup->getBSphereCollection();
+	const int numberOfBSpheres = static_cast<int>(BSpheres.getSize());
 
-	// If collidables's BSphere_1 1 collides with collidable'2 BSphere_1 2 then..
-	if (MathTools::Intersect(BSphere_1, BSphere_2))
+	for (int current = 0; current < numberOfBSpheres; current++)
 	{
-#if CollisionTestSelfCommand_DEBUG
-		Visualizer::ShowCollisionVolume(BSphere_1, Colors::Red);
-		Visualizer::ShowCollisionVolume(BSphere_2, Colors::Red);
-#endif // CollisionTestSelfCommand_DEBUG
+		// Batch test the current BSphere against every BSphere after it then...
+		_candidates.clear();
+		BatchTools::CullBSpheres(BSpheres, current + 1, BSpheres.getCenterAt(current), BSpheres.getRadiusAt(current), _candidates);
+		_stats.BSpherePairTests += static_cast<unsigned int>(numberOfBSpheres - current - 1);
+		_stats.BSpherePairPasses += static_cast<unsigned int>(_candidates.size());
 
-		testCollidablesCollisionVolume(pCollidable_1, pCollidable_2);
-	}
-	else
-	{
-#if CollisionTestSelfCommand_DEBUG
-		Visualizer::ShowCollisionVolume(BSphere_1);
-		Visualizer::ShowCollisionVolume(BSphere_2);
-#endif // CollisionTestSelfCommand_DEBUG
-	}
-}
+		Collidable* pCollidable_1 = BSpheres.getCollidableAt(current);
+		const bool isAtRest_1 = BSpheres.isAtRestAt(current);
 
-void CollisionTestSelfCommand::testCollidablesCollisionVolume(Collidable* pCollidable_1, Collidable* pCollidable_2) const
-{
-	const CollisionVolume& collisionVolume_1 = pCollidable_1->getCollisionVolume();
-	const CollisionVolume& collisionVolume_2 = pCollidable_2->getCollisionVolume();
+		// queue the collision volumes of every pair whose BSpheres collide (unless both are at rest)
+		for (int afterCurrent : _candidates)
+		{
+			if (isAtRest_1 && BSpheres.isAtRestAt(afterCurrent)) continue;
 
-	// If collidables's collision volume 1 collides with collidables's collision volume 2 then..
-	if (MathTools::Intersect(collisionVolume_1, collisionVolume_2))
-	{
-#if CollisionTestSelfCommand_DEBUG
-		Visualizer::ShowCollisionVolume(collisionVolume_1, Colors::Red);
-		Visualizer::ShowCollisionVolume(collisionVolume_2, Colors::Red);
-#endif // CollisionTestSelfCommand_DEBUG
+			Collidable* pCollidable_2 = BSpheres.getCollidableAt(afterCurrent);
 
-		_pCollisionDispatch->processCallBacks(pCollidable_1, pCollidable_2);
-	}
-	else
-	{
 #if CollisionTestSelfCommand_DEBUG
-		Visualizer::ShowCollisionVolume(collisionVolume_1);
-		Visualizer::ShowCollisionVolume(collisionVolume_2);
+			Visualizer::ShowCollisionVolume(pCollidable_1->getBSphere(), Colors::Red);
+			Visualizer::ShowCollisionVolume(pCollidable_2->getBSphere(), Colors::Red);
 #endif // CollisionTestSelfCommand_DEBUG
+
+			_pNarrowPhase->addPair(pCollidable_1, pCollidable_2, _pCollisionDispatch, &_stats);
+			_stats.narrowPhasePairs++;
+		}
 	}
 }
\ No newline at end of file
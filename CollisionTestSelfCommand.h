@@ -2,10 +2,12 @@
 #define _CollisionTestSelfCommand
 
 #include "CollisionTestCommand.h"
+#include "BatchTools.h"
 
 class CollidableGroup;
 class CollisionDispatchBase;
 class Collidable;
+class NarrowPhase;
 
 class CollisionTestSelfCommand : public CollisionTestCommand
 {
@@ -18,20 +20,22 @@ public:
 	// Is it a base class? Should it be virtual?
 	~CollisionTestSelfCommand();
 
-	CollisionTestSelfCommand(CollidableGroup*, CollisionDispatchBase*);
+	CollisionTestSelfCommand(CollidableGroup*, CollisionDispatchBase*, NarrowPhase*);
 
 	// Inherited via CollisionTestCommand
 	virtual void execute() override;
 
 private:
 	// Execute helpers
-	void testCollisionGroup(CollidableGroup*) const;
-	void testCollidablesBSphere(Collidable*, Collidable*) const;
-	void testCollidablesCollisionVolume(Collidable*, Collidable*) const;
+	void testCollisionGroup(CollidableGroup*);
 
 private:
 	CollidableGroup* _pCollidableGroup;
 	CollisionDispatchBase* _pCollisionDispatch;
+	NarrowPhase* _pNarrowPhase;
+
+	// Candidate indices output by the batch BSphere tier (kept to reuse its storage)
+	BatchTools::IndexCollection _candidates;
 
 };
 #endif // !_CollisionTestSelfCommand
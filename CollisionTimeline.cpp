@@ -0,0 +1,241 @@
+#include "CollisionTimeline.h"
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cassert>
+
+std::atomic<bool> CollisionTimeline::IsRecording(false);
+std::atomic<unsigned int> CollisionTimeline::Capacity(CollisionTimeline::DEFAULT_CAPACITY);
+std::atomic<long long> CollisionTimeline::ClearedAtNanoseconds(LLONG_MIN);
+std::atomic<CollisionTimeline::ThreadRing*> CollisionTimeline::pRings(nullptr);
+std::atomic<int> CollisionTimeline::NextThreadID(1);
+thread_local CollisionTimeline::ThreadRing* CollisionTimeline::pThreadRing = nullptr;
+
+const unsigned int CollisionTimeline::DEFAULT_CAPACITY;
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Thread Ring
+//-----------------------------------------------------------------------------------------------------------------------------
+
+// Single producer ring: only its thread writes, publishing each span by incrementing the write count
+class CollisionTimeline::ThreadRing
+{
+public:
+	ThreadRing() = delete;
+	ThreadRing(const ThreadRing&) = delete;
+	ThreadRing& operator=(const ThreadRing&) = delete;
+	ThreadRing(ThreadRing&&) = delete;
+	ThreadRing& operator=(ThreadRing&&) = delete;
+	~ThreadRing() = default;
+
+	ThreadRing(unsigned int capacity, int threadID)
+		: spans(capacity), mask(capacity - 1), threadID(threadID), name(nullptr), writeCount(0), pNext(nullptr)
+	{
+		assert((capacity & mask) == 0);
+	}
+
+	void record(const Span& span)
+	{
+		const unsigned long long index = writeCount.load(std::memory_order_relaxed);
+		spans[index & mask] = span;
+		writeCount.store(index + 1, std::memory_order_release);
+	}
+
+	// Copies the spans still in the ring, oldest first
+	void copySpans(std::vector<Span>& copiedSpans) const
+	{
+		const unsigned long long capacity = spans.size();
+		const unsigned long long end = writeCount.load(std::memory_order_acquire);
+		unsigned long long begin = (end > capacity) ? end - capacity : 0;
+
+		const size_t firstCopied = copiedSpans.size();
+		for (unsigned long long index = begin; index < end; index++)
+		{
+			copiedSpans.push_back(spans[index & mask]);
+		}
+
+		// The thread kept recording during the copy: drop the spans it may have overwritten
+		const unsigned long long endAfterCopy = writeCount.load(std::memory_order_acquire);
+		if (endAfterCopy + 1 > begin + capacity)
+		{
+			const unsigned long long overwritten = std::min(end - begin, endAfterCopy + 1 - (begin + capacity));
+			copiedSpans.erase(copiedSpans.begin() + firstCopied, copiedSpans.begin() + firstCopied + static_cast<size_t>(overwritten));
+		}
+	}
+
+	std::vector<Span> spans;
+	const unsigned long long mask;
+	const int threadID;
+	std::atomic<const char*> name;
+	std::atomic<unsigned long long> writeCount;
+	ThreadRing* pNext;
+};
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Settings
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionTimeline::SetEnabled(bool isEnabled)
+{
+	CollisionTimeline::IsRecording.store(isEnabled, std::memory_order_relaxed);
+}
+
+void CollisionTimeline::SetCapacity(unsigned int spansPerThread)
+{
+	unsigned int capacity = 1;
+	while (capacity < spansPerThread && capacity < (1u << 31))
+	{
+		capacity <<= 1;
+	}
+	CollisionTimeline::Capacity.store(capacity, std::memory_order_relaxed);
+}
+
+void CollisionTimeline::SetThreadName(const char* name)
+{
+	CollisionTimeline::GetThreadRing().name.store(name, std::memory_order_relaxed);
+}
+
+void CollisionTimeline::Clear()
+{
+	CollisionTimeline::ClearedAtNanoseconds.store(CollisionTimeline::Now(), std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Recording
+//-----------------------------------------------------------------------------------------------------------------------------
+long long CollisionTimeline::Now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CollisionTimeline::Record(const Span& span)
+{
+	CollisionTimeline::GetThreadRing().record(span);
+}
+
+CollisionTimeline::ThreadRing& CollisionTimeline::GetThreadRing()
+{
+	if (CollisionTimeline::pThreadRing == nullptr)
+	{
+		ThreadRing* pRing = new ThreadRing(CollisionTimeline::Capacity.load(std::memory_order_relaxed),
+			CollisionTimeline::NextThreadID.fetch_add(1, std::memory_order_relaxed));
+
+		// Publish the ring for the trace writers
+		pRing->pNext = CollisionTimeline::pRings.load(std::memory_order_relaxed);
+		while (!CollisionTimeline::pRings.compare_exchange_weak(pRing->pNext, pRing, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+
+		CollisionTimeline::pThreadRing = pRing;
+	}
+	return *CollisionTimeline::pThreadRing;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Chrome Trace
+//-----------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	void WriteJsonString(FILE* pFile, const char* text)
+	{
+		fputc('"', pFile);
+		for (const char* p = text; *p != '\0'; p++)
+		{
+			if (*p == '"' || *p == '\\') fputc('\\', pFile);
+			fputc(*p, pFile);
+		}
+		fputc('"', pFile);
+	}
+}
+
+bool CollisionTimeline::WriteChromeTrace(const char* path)
+{
+	FILE* pFile = fopen(path, "w");
+	if (pFile == nullptr) return false;
+
+	CollisionTimeline::WriteChromeTrace(pFile);
+	return fclose(pFile) == 0;
+}
+
+void CollisionTimeline::WriteChromeTrace(FILE* pFile)
+{
+	const long long clearedAtNanoseconds = CollisionTimeline::ClearedAtNanoseconds.load(std::memory_order_relaxed);
+
+	std::vector<const ThreadRing*> rings;
+	for (const ThreadRing* pRing = CollisionTimeline::pRings.load(std::memory_order_acquire); pRing != nullptr; pRing = pRing->pNext)
+	{
+		rings.push_back(pRing);
+	}
+	std::reverse(rings.begin(), rings.end());
+
+	std::vector<std::vector<Span>> ringSpans(rings.size());
+	long long originNanoseconds = LLONG_MAX;
+	for (size_t i = 0; i < rings.size(); i++)
+	{
+		rings[i]->copySpans(ringSpans[i]);
+
+		std::vector<Span>& spans = ringSpans[i];
+		spans.erase(std::remove_if(spans.begin(), spans.end(),
+			[clearedAtNanoseconds](const Span& span) { return span.startNanoseconds < clearedAtNanoseconds; }), spans.end());
+
+		for (const Span& span : spans)
+		{
+			originNanoseconds = std::min(originNanoseconds, span.startNanoseconds);
+		}
+	}
+
+	fprintf(pFile, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+	bool isFirst = true;
+	for (size_t i = 0; i < rings.size(); i++)
+	{
+		const ThreadRing& ring = *rings[i];
+
+		fprintf(pFile, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": ", isFirst ? "" : ",", ring.threadID);
+		const char* name = ring.name.load(std::memory_order_relaxed);
+		if (name != nullptr)
+		{
+			WriteJsonString(pFile, name);
+		}
+		else
+		{
+			fprintf(pFile, "\"thread %d\"", ring.threadID);
+		}
+		fprintf(pFile, "}}");
+		isFirst = false;
+
+		for (const Span& span : ringSpans[i])
+		{
+			fprintf(pFile, ",\n{\"name\": ");
+			WriteJsonString(pFile, span.name);
+			fprintf(pFile, ", \"cat\": \"collision\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+				ring.threadID, (span.startNanoseconds - originNanoseconds) / 1000.0, span.durationNanoseconds / 1000.0);
+			if (span.valueName != nullptr)
+			{
+				fprintf(pFile, ", \"args\": {");
+				WriteJsonString(pFile, span.valueName);
+				fprintf(pFile, ": %lld}", span.value);
+			}
+			fprintf(pFile, "}");
+		}
+	}
+	fprintf(pFile, "\n]}\n");
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Termination
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionTimeline::Delete()
+{
+	CollisionTimeline::SetEnabled(false);
+
+	ThreadRing* pRing = CollisionTimeline::pRings.exchange(nullptr, std::memory_order_acquire);
+	while (pRing != nullptr)
+	{
+		ThreadRing* pNext = pRing->pNext;
+		delete pRing;
+		pRing = pNext;
+	}
+
+	// Only the calling thread's pointer can be reset; other threads must not record anymore
+	CollisionTimeline::pThreadRing = nullptr;
+}
@@ -0,0 +1,156 @@
+#ifndef _CollisionTimeline
+#define _CollisionTimeline
+
+#include <atomic>
+#include <cstdio>
+
+/**********************************************************************************************//**
+ * <summary> Timeline of timed spans of the collision system, exported as Chrome trace JSON.</summary>
+ *
+ * <remarks> Disabled by default. While enabled, every CollisionTimelineScope records one span
+ *			 (name, start, duration and an optional value) into the ring buffer of its thread.
+ *			 A ring only keeps the latest spans of its thread, so a trace written right after a
+ *			 spike shows the frames that led to it. Open the trace in chrome://tracing or
+ *			 ui.perfetto.dev.
+ *
+ *			 Recording is lock-free: each thread only writes to its own ring, made (once per
+ *			 thread) the first time it records. Writing the trace may run on any thread, while
+ *			 other threads record; spans overwritten during the copy are dropped. Names and value
+ *			 names must be string literals (only their address is kept). </remarks>
+ **************************************************************************************************/
+class CollisionTimeline
+{
+public:
+	// Spans kept per thread by the rings made after SetCapacity()
+	static const unsigned int DEFAULT_CAPACITY = 1 << 15;
+
+	struct Span
+	{
+		const char* name;
+		const char* valueName;
+		long long value;
+		long long startNanoseconds;
+		long long durationNanoseconds;
+	};
+
+private:
+	class ThreadRing;
+
+public:
+	CollisionTimeline() = delete;
+	CollisionTimeline(const CollisionTimeline&) = delete;
+	CollisionTimeline& operator=(const CollisionTimeline&) = delete;
+	CollisionTimeline(CollisionTimeline&&) = delete;
+	CollisionTimeline& operator=(CollisionTimeline&&) = delete;
+	~CollisionTimeline() = delete;
+
+	static void SetEnabled(bool isEnabled);
+
+	static bool IsEnabled()
+	{
+		return IsRecording.load(std::memory_order_relaxed);
+	}
+
+	/**********************************************************************************************//**
+	 * <summary> Sets the number of spans kept per thread.</summary>
+	 *
+	 * <remarks> Rounded up to a power of two. Only applies to the rings of threads that have not
+	 *			 recorded yet. </remarks>
+	 *
+	 * <param name="spansPerThread"> The number of spans kept per thread.</param>
+	 **************************************************************************************************/
+	static void SetCapacity(unsigned int spansPerThread);
+
+	// Names the calling thread in the trace (string literal, "thread <n>" by default)
+	static void SetThreadName(const char* name);
+
+	// Drops the spans recorded so far, from every thread
+	static void Clear();
+
+	/**********************************************************************************************//**
+	 * <summary> Writes the spans kept by every thread as Chrome trace JSON.</summary>
+	 *
+	 * <param name="path"> Path of the trace file (overwritten).</param>
+	 *
+	 * <returns> False if the file could not be written.</returns>
+	 **************************************************************************************************/
+	static bool WriteChromeTrace(const char* path);
+	static void WriteChromeTrace(FILE* pFile);
+
+	// Nanoseconds on the timeline clock
+	static long long Now();
+
+	// Records a span of the calling thread (called by CollisionTimelineScope)
+	static void Record(const Span& span);
+
+	// Termination: frees the rings. No thread may record anymore.
+	static void Delete();
+
+private:
+	static ThreadRing& GetThreadRing();
+
+private:
+	static std::atomic<bool> IsRecording;
+	static std::atomic<unsigned int> Capacity;
+	static std::atomic<long long> ClearedAtNanoseconds;
+
+	// Every ring made so far, most recent first
+	static std::atomic<ThreadRing*> pRings;
+	static std::atomic<int> NextThreadID;
+	static thread_local ThreadRing* pThreadRing;
+};
+
+/**********************************************************************************************//**
+ * <summary> Records a CollisionTimeline span covering its lifetime.</summary>
+ *
+ * <remarks> Only reads the clock when the timeline is enabled. </remarks>
+ **************************************************************************************************/
+class CollisionTimelineScope
+{
+public:
+	CollisionTimelineScope() = delete;
+	CollisionTimelineScope(const CollisionTimelineScope&) = delete;
+	CollisionTimelineScope& operator=(const CollisionTimelineScope&) = delete;
+	CollisionTimelineScope(CollisionTimelineScope&&) = delete;
+	CollisionTimelineScope& operator=(CollisionTimelineScope&&) = delete;
+
+	/**********************************************************************************************//**
+	 * <summary> Starts a span.</summary>
+	 *
+	 * <param name="name"> The name of the span (string literal).</param>
+	 * <param name="valueName"> The name of the value shown with the span (string literal), nullptr for none.</param>
+	 * <param name="value"> The value shown with the span.</param>
+	 **************************************************************************************************/
+	explicit CollisionTimelineScope(const char* name, const char* valueName = nullptr, long long value = 0)
+		: _span{ name, valueName, value, 0, 0 }, _isRecording(CollisionTimeline::IsEnabled())
+	{
+		if (_isRecording)
+		{
+			_span.startNanoseconds = CollisionTimeline::Now();
+		}
+	}
+
+	~CollisionTimelineScope()
+	{
+		if (_isRecording)
+		{
+			_span.durationNanoseconds = CollisionTimeline::Now() - _span.startNanoseconds;
+			CollisionTimeline::Record(_span);
+		}
+	}
+
+	// Changes the value shown with the span (e.g. a result known at the end of the scope)
+	void setValue(long long value)
+	{
+		_span.value = value;
+	}
+
+private:
+	CollisionTimeline::Span _span;
+	const bool _isRecording;
+};
+#endif // !_CollisionTimeline
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionTimeline Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
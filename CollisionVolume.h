@@ -12,14 +12,31 @@ class CollisionVolumeOctree;
 /**********************************************************************************************//**
  * <summary> A collision volume base class.</summary>
  *
- * <remarks> </remarks>
+ * <remarks> Every concrete volume carries a type tag, so code that knows the pair of types
+ *			 (narrow phase, batched updates) can call the concrete kernel without going
+ *			 through the visitor. </remarks>
  **************************************************************************************************/
 class CollisionVolume
 {
 	friend class CollisionVolumeAttorney;
 
 public:
-	CollisionVolume() = default;
+	/**********************************************************************************************//**
+	 * <summary> Values that represent the concrete collision volume types.</summary>
+	 *
+	 * <remarks> Used as an index, COUNT must stay last. </remarks>
+	 **************************************************************************************************/
+	enum class Type : unsigned char
+	{
+		BSPHERE,
+		AABB,
+		OBB,
+		OCTREE,
+		COUNT
+	};
+
+public:
+	CollisionVolume() = delete;
 	CollisionVolume(const CollisionVolume&) = default;
 	CollisionVolume& operator=(const CollisionVolume&) = default;
 	CollisionVolume(CollisionVolume&&) = default;
@@ -84,6 +101,23 @@ public:
 
 	virtual int getMaxDepth() const = 0;
 
+	/**********************************************************************************************//**
+	* <summary> Gets the concrete type of the collision volume.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <returns> The type.</returns>
+	**************************************************************************************************/
+	Type getType() const
+	{
+		return _type;
+	}
+
+protected:
+	explicit CollisionVolume(Type type)
+		: _type(type)
+	{}
+
 private:
 	/**********************************************************************************************//**
 	* <summary> Draws it collision volume.</summary>
@@ -96,6 +130,9 @@ private:
 	* <param name="depth"> the depth to render collision volume.</param>
 	**************************************************************************************************/
 	virtual void debugDraw(const Vect& color, int depth) const = 0;
+
+private:
+	Type _type;
 };
 #endif // !_CollisionVolume
 
@@ -0,0 +1,141 @@
+#include "CollisionVolumeAABB.h"
+#include "CollisionVolumeOBB.h"
+#include "VisualizerAttorney.h"
+#include "MathTools.h"
+#include "Triangle.h"
+#include <cmath>
+
+CollisionVolumeAABB::CollisionVolumeAABB()
+	: CollisionVolume(Type::AABB),
+	_worldMatrix(IDENTITY),
+	_minWorldVertex(0.0f, 0.0f, 0.0f),
+	_maxWorldVertex(0.0f, 0.0f, 0.0f),
+	_localHalfDiagonal(0.0f, 0.0f, 0.0f),
+	_worldCenter(0.0f, 0.0f, 0.0f)
+{}
+
+void CollisionVolumeAABB::computeData(Model* pModel, const Matrix& worldMatrix)
+{
+	computeData(pModel->getMinAABB(), pModel->getMaxAABB(), worldMatrix);
+}
+
+void CollisionVolumeAABB::computeData(const Vect& minLocalVertex, const Vect& maxLocalVertex, const Matrix& worldMatrix)
+{
+	Vect localCenter = (minLocalVertex + maxLocalVertex) * 0.5f;
+	Vect localHalfDiagonal = (maxLocalVertex - minLocalVertex) * 0.5f;
+
+	// The world half diagonal along an axis is the sum of the local half diagonal
+	// projected (absolute values) by each row of the world matrix
+	const Vect row0 = worldMatrix.get(ROW_0);
+	const Vect row1 = worldMatrix.get(ROW_1);
+	const Vect row2 = worldMatrix.get(ROW_2);
+
+	Vect worldHalfDiagonal(
+		std::abs(row0[x]) * localHalfDiagonal[x] + std::abs(row1[x]) * localHalfDiagonal[y] + std::abs(row2[x]) * localHalfDiagonal[z],
+		std::abs(row0[y]) * localHalfDiagonal[x] + std::abs(row1[y]) * localHalfDiagonal[y] + std::abs(row2[y]) * localHalfDiagonal[z],
+		std::abs(row0[z]) * localHalfDiagonal[x] + std::abs(row1[z]) * localHalfDiagonal[y] + std::abs(row2[z]) * localHalfDiagonal[z]);
+
+	Vect worldCenter = localCenter * worldMatrix;
+
+	computeData(worldCenter - worldHalfDiagonal, worldCenter + worldHalfDiagonal);
+}
+
+void CollisionVolumeAABB::computeData(const Vect& minWorldVertex, const Vect& maxWorldVertex)
+{
+	_minWorldVertex = minWorldVertex;
+	_maxWorldVertex = maxWorldVertex;
+	_localHalfDiagonal = 0.5f * (_maxWorldVertex - _minWorldVertex);
+	_worldCenter = _minWorldVertex + _localHalfDiagonal;
+}
+
+void CollisionVolumeAABB::computeData(const CollisionVolumeOBB& OBB)
+{
+	computeData(OBB.getMinLocalVertex(), OBB.getMaxLocalVertex(), OBB.getWorldMatrix());
+}
+
+void CollisionVolumeAABB::computeData(const Triangle& triangle)
+{
+	computeData(MathTools::Min(triangle.getVertex0(), MathTools::Min(triangle.getVertex1(), triangle.getVertex2())),
+		MathTools::Max(triangle.getVertex0(), MathTools::Max(triangle.getVertex1(), triangle.getVertex2())));
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Intersection
+//-----------------------------------------------------------------------------------------------------------------------------
+
+bool CollisionVolumeAABB::intersectAccept(const CollisionVolume& collisionVolume) const
+{
+	return collisionVolume.intersectVisitor(*this);
+}
+
+bool CollisionVolumeAABB::intersectVisitor(const CollisionVolumeBSphere& collisionBSphere) const
+{
+	return MathTools::Intersect(collisionBSphere, *this);
+}
+
+bool CollisionVolumeAABB::intersectVisitor(const CollisionVolumeAABB& AABB) const
+{
+	return MathTools::Intersect(AABB, *this);
+}
+
+bool CollisionVolumeAABB::intersectVisitor(const CollisionVolumeOBB& OBB) const
+{
+	return MathTools::Intersect(*this, OBB);
+}
+
+bool CollisionVolumeAABB::intersectVisitor(const CollisionVolumeOctree& Octree) const
+{
+	return MathTools::Intersect(*this, Octree);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Debugging
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionVolumeAABB::debugDraw(const Vect& color, int) const
+{
+	VisualizerAttorney::RenderAccess::ShowAABB(*this, color);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Getters
+//-----------------------------------------------------------------------------------------------------------------------------
+const Vect& CollisionVolumeAABB::getMinWorldVertex() const
+{
+	return _minWorldVertex;
+}
+
+const Vect& CollisionVolumeAABB::getMaxWorldVertex() const
+{
+	return _maxWorldVertex;
+}
+
+const Vect& CollisionVolumeAABB::getWorldCenter() const
+{
+	return _worldCenter;
+}
+
+const Vect& CollisionVolumeAABB::getLocalHalfDiagonal() const
+{
+	return _localHalfDiagonal;
+}
+
+const Matrix& CollisionVolumeAABB::getWorldMatrix() const
+{
+	return _worldMatrix;
+}
+
+const Matrix& CollisionVolumeAABB::getInverseWorldMatrix() const
+{
+	// Inverse of the identity
+	return _worldMatrix;
+}
+
+float CollisionVolumeAABB::getScalingFactorSquared() const
+{
+	return 1.0f;
+}
+
+int CollisionVolumeAABB::getMaxDepth() const
+{
+	return 0;
+}
@@ -0,0 +1,109 @@
+#ifndef _CollisionVolumeAABB
+#define _CollisionVolumeAABB
+
+#include "AzulCore.h"
+#include "CollisionVolume.h"
+
+class Triangle;
+
+/**********************************************************************************************//**
+ * <summary> An AABB Collision volume</summary>
+ *
+ * <remarks> The box is axis aligned in world space, so its world matrix is always the identity.
+ *			 The matrix getters exist so AABB can share the box SAT helpers with OBB. </remarks>
+ **************************************************************************************************/
+class CollisionVolumeAABB : public CollisionVolume
+{
+public:
+	CollisionVolumeAABB();
+	CollisionVolumeAABB(const CollisionVolumeAABB&) = default;
+	CollisionVolumeAABB& operator=(const CollisionVolumeAABB&) = default;
+	CollisionVolumeAABB(CollisionVolumeAABB&&) = default;
+	CollisionVolumeAABB& operator=(CollisionVolumeAABB&&) = default;
+	~CollisionVolumeAABB() = default;
+
+	/**********************************************************************************************//**
+	 * <summary> Calculates the data for AABB.
+	 * 			 In this case the min and max vertex in world space.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="pModel"> the pointer to a model.</param>
+	 * <param name="worldMatrix"> The world matrix.</param>
+	 **************************************************************************************************/
+	virtual void computeData(Model* pModel, const Matrix& worldMatrix) override;
+
+	/**********************************************************************************************//**
+	* <summary> Calculates the data for AABB enclosing a local box moved into world space.</summary>
+	*
+	* <remarks> Transforms the box center and extents directly (no corner transforms). </remarks>
+	*
+	* <param name="minLocalVertex"> The min local vertex.</param>
+	* <param name="maxLocalVertex"> The max local vertex.</param>
+	* <param name="worldMatrix"> The world matrix.</param>
+	**************************************************************************************************/
+	void computeData(const Vect& minLocalVertex, const Vect& maxLocalVertex, const Matrix& worldMatrix);
+
+	/**********************************************************************************************//**
+	* <summary> Calculates the data for AABB from its min and max vertex in world space.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <param name="minWorldVertex"> The min world vertex.</param>
+	* <param name="maxWorldVertex"> The max world vertex.</param>
+	**************************************************************************************************/
+	void computeData(const Vect& minWorldVertex, const Vect& maxWorldVertex);
+
+	/**********************************************************************************************//**
+	* <summary> Calculates the data for AABB enclosing an OBB.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <param name="OBB"> The OBB to enclose.</param>
+	**************************************************************************************************/
+	void computeData(const CollisionVolumeOBB& OBB);
+
+	/**********************************************************************************************//**
+	* <summary> Calculates the data for AABB enclosing a triangle.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <param name="triangle"> The triangle to enclose.</param>
+	**************************************************************************************************/
+	void computeData(const Triangle& triangle);
+
+	virtual bool intersectAccept(const CollisionVolume& collisionVolume) const override;
+	virtual bool intersectVisitor(const CollisionVolumeBSphere& collisionBSphere) const override;
+	virtual bool intersectVisitor(const CollisionVolumeAABB& AABB) const override;
+	virtual bool intersectVisitor(const CollisionVolumeOBB& OBB) const override;
+	virtual bool intersectVisitor(const CollisionVolumeOctree& Octree) const override;
+
+	// Getters
+
+	const Vect& getMinWorldVertex() const;
+	const Vect& getMaxWorldVertex() const;
+	const Vect& getWorldCenter() const;
+	const Vect& getLocalHalfDiagonal() const;
+
+	const Matrix& getWorldMatrix() const;
+	const Matrix& getInverseWorldMatrix() const;
+	float getScalingFactorSquared() const;
+
+	virtual int getMaxDepth() const override;
+
+private:
+	// Debugging
+	virtual void debugDraw(const Vect& color, int depth) const override;
+
+private:
+	Matrix _worldMatrix;
+	Vect _minWorldVertex;
+	Vect _maxWorldVertex;
+	Vect _localHalfDiagonal;
+	Vect _worldCenter;
+};
+#endif // !_CollisionVolumeAABB
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionVolumeAABB Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,97 @@
+#include "CollisionVolumeBSphere.h"
+#include "CollisionVolumeOBB.h"
+#include "VisualizerAttorney.h"
+#include "MathTools.h"
+#include "Triangle.h"
+#include <algorithm>
+#include <cmath>
+
+CollisionVolumeBSphere::CollisionVolumeBSphere()
+	: CollisionVolume(Type::BSPHERE), _center(0.0f, 0.0f, 0.0f), _radius(0.0f)
+{}
+
+void CollisionVolumeBSphere::computeData(Model* pModel, const Matrix& worldMatrix)
+{
+	Vect scale = MathTools::ExtractScaleXYZ(worldMatrix);
+	float maxScale = std::max(scale[x], std::max(scale[y], scale[z]));
+
+	computeData(pModel->getCenter() * worldMatrix, pModel->getRadius() * maxScale);
+}
+
+void CollisionVolumeBSphere::computeData(const Vect& center, float radius)
+{
+	_center = center;
+	_radius = radius;
+}
+
+void CollisionVolumeBSphere::computeData(const CollisionVolumeOBB& OBB)
+{
+	float halfDiagonalLength = OBB.getLocalHalfDiagonal().mag() * sqrtf(OBB.getScalingFactorSquared());
+	computeData(OBB.getWorldCenter(), halfDiagonalLength);
+}
+
+void CollisionVolumeBSphere::computeData(const Triangle& triangle)
+{
+	Vect center = (triangle.getVertex0() + triangle.getVertex1() + triangle.getVertex2()) * (1.0f / 3.0f);
+
+	float radiusSquared = (triangle.getVertex0() - center).magSqr();
+	radiusSquared = std::max(radiusSquared, (triangle.getVertex1() - center).magSqr());
+	radiusSquared = std::max(radiusSquared, (triangle.getVertex2() - center).magSqr());
+
+	computeData(center, sqrtf(radiusSquared));
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Intersection
+//-----------------------------------------------------------------------------------------------------------------------------
+
+bool CollisionVolumeBSphere::intersectAccept(const CollisionVolume& collisionVolume) const
+{
+	return collisionVolume.intersectVisitor(*this);
+}
+
+bool CollisionVolumeBSphere::intersectVisitor(const CollisionVolumeBSphere& collisionBSphere) const
+{
+	return MathTools::Intersect(collisionBSphere, *this);
+}
+
+bool CollisionVolumeBSphere::intersectVisitor(const CollisionVolumeAABB& AABB) const
+{
+	return MathTools::Intersect(*this, AABB);
+}
+
+bool CollisionVolumeBSphere::intersectVisitor(const CollisionVolumeOBB& OBB) const
+{
+	return MathTools::Intersect(*this, OBB);
+}
+
+bool CollisionVolumeBSphere::intersectVisitor(const CollisionVolumeOctree& Octree) const
+{
+	return MathTools::Intersect(*this, Octree);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Debugging
+//-----------------------------------------------------------------------------------------------------------------------------
+void CollisionVolumeBSphere::debugDraw(const Vect& color, int) const
+{
+	VisualizerAttorney::RenderAccess::ShowBSphere(*this, color);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Getters
+//-----------------------------------------------------------------------------------------------------------------------------
+const Vect& CollisionVolumeBSphere::getCenter() const
+{
+	return _center;
+}
+
+float CollisionVolumeBSphere::getRadius() const
+{
+	return _radius;
+}
+
+int CollisionVolumeBSphere::getMaxDepth() const
+{
+	return 0;
+}
@@ -0,0 +1,101 @@
+#ifndef _CollisionVolumeBSphere
+#define _CollisionVolumeBSphere
+
+#include "AzulCore.h"
+#include "CollisionVolume.h"
+
+class Triangle;
+
+/**********************************************************************************************//**
+ * <summary> A BSphere Collision volume</summary>
+ *
+ * <remarks> </remarks>
+ **************************************************************************************************/
+class CollisionVolumeBSphere : public CollisionVolume
+{
+public:
+	CollisionVolumeBSphere();
+	CollisionVolumeBSphere(const CollisionVolumeBSphere&) = default;
+	CollisionVolumeBSphere& operator=(const CollisionVolumeBSphere&) = default;
+	CollisionVolumeBSphere(CollisionVolumeBSphere&&) = default;
+	CollisionVolumeBSphere& operator=(CollisionVolumeBSphere&&) = default;
+	~CollisionVolumeBSphere() = default;
+
+	/**********************************************************************************************//**
+	 * <summary> Calculates the data for BSphere.
+	 * 			 In this case the center and radius.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="pModel"> the pointer to a model.</param>
+	 * <param name="worldMatrix"> The world matrix.</param>
+	 **************************************************************************************************/
+	virtual void computeData(Model* pModel, const Matrix& worldMatrix) override;
+
+	/**********************************************************************************************//**
+	* <summary> Calculates the data for BSphere from its center and radius in world space.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <param name="center"> The center in world space.</param>
+	* <param name="radius"> The radius in world space.</param>
+	**************************************************************************************************/
+	void computeData(const Vect& center, float radius);
+
+	/**********************************************************************************************//**
+	* <summary> Calculates the data for BSphere enclosing an OBB.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <param name="OBB"> The OBB to enclose.</param>
+	**************************************************************************************************/
+	void computeData(const CollisionVolumeOBB& OBB);
+
+	/**********************************************************************************************//**
+	* <summary> Calculates the data for BSphere enclosing a triangle.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <param name="triangle"> The triangle to enclose.</param>
+	**************************************************************************************************/
+	void computeData(const Triangle& triangle);
+
+	virtual bool intersectAccept(const CollisionVolume& collisionVolume) const override;
+	virtual bool intersectVisitor(const CollisionVolumeBSphere& collisionBSphere) const override;
+	virtual bool intersectVisitor(const CollisionVolumeAABB& AABB) const override;
+	virtual bool intersectVisitor(const CollisionVolumeOBB& OBB) const override;
+	virtual bool intersectVisitor(const CollisionVolumeOctree& Octree) const override;
+
+	/**********************************************************************************************//**
+	* <summary> Gets the center of BSphere in world space.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <returns> The center.</returns>
+	**************************************************************************************************/
+	const Vect& getCenter() const;
+
+	/**********************************************************************************************//**
+	* <summary> Gets the radius of BSphere in world space.</summary>
+	*
+	* <remarks> </remarks>
+	*
+	* <returns> The radius.</returns>
+	**************************************************************************************************/
+	float getRadius() const;
+
+	virtual int getMaxDepth() const override;
+
+private:
+	// Debugging
+	virtual void debugDraw(const Vect& color, int depth) const override;
+
+private:
+	Vect _center;
+	float _radius;
+};
+#endif // !_CollisionVolumeBSphere
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionVolumeBSphere Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include "VisualizerAttorney.h"
 #include "MathTools.h"
 
+CollisionVolumeOBB::CollisionVolumeOBB()
+	: CollisionVolume(Type::OBB)
+{}
+
 void CollisionVolumeOBB::computeData(Model* pModel, const Matrix& worldMatrix)
 {
 	computeData(pModel->getMinAABB(), pModel->getMaxAABB(), worldMatrix);
@@ -12,7 +12,7 @@
 class CollisionVolumeOBB : public CollisionVolume
 {
 public:
-	CollisionVolumeOBB() = default;
+	CollisionVolumeOBB();
 	CollisionVolumeOBB(const CollisionVolumeOBB&) = default;
 	CollisionVolumeOBB& operator=(const CollisionVolumeOBB&) = default;
 	CollisionVolumeOBB(CollisionVolumeOBB&&) = default;
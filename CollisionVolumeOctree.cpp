@@ -2,19 +2,26 @@
 #include "Visualizer.h"
 #include "OctreeModelManager.h"
 #include "OctreeNode.h"
+#include "OctreeNodeArena.h"
+#include "OctreeTools.h"
 #include "MathTools.h"
 #include <cassert>
 
-CollisionVolumeOctree::CollisionVolumeOctree(Model* pModel, int maxDepth)
-	: _pRoot(nullptr), _maxDepth(maxDepth)
+CollisionVolumeOctree::CollisionVolumeOctree(Model* pModel, int maxDepth, OctreeTools::BuildMode buildMode)
+	: CollisionVolume(Type::OCTREE), _pModel(pModel), _pOctreeNodeArena(nullptr), _pRoot(nullptr), _buildMode(buildMode),
+	_frameMode(OctreeModelManager::GetFrameMode()),
+	_maxDepth((maxDepth == OctreeTools::AUTO_DEPTH) ? OctreeModelManager::GetAutoDepth(pModel, buildMode, _frameMode) : OctreeTools::ClampDepth(maxDepth))
 {
-	assert(pModel != nullptr && maxDepth >= 1);
-	_pRoot = OctreeModelManager::GetOctreeModel(pModel, maxDepth);
+	assert(pModel != nullptr && _maxDepth >= 1 && _maxDepth <= OctreeTools::MAX_DEPTH);
+	_pOctreeNodeArena = OctreeModelManager::GetOctreeModel(pModel, _maxDepth, _buildMode, _frameMode);
+	_pRoot = _pOctreeNodeArena->getRoot();
 }
 
 CollisionVolumeOctree::~CollisionVolumeOctree()
 {
-	delete _pRoot;
+	// Releases every node at once
+	delete _pOctreeNodeArena;
+	OctreeModelManager::ReleaseOctreeModel(_pModel, _maxDepth, _buildMode, _frameMode);
 }
 
 // Get Nodes
@@ -44,12 +51,15 @@ void CollisionVolumeOctree::computeData(Model*, const Matrix& worldMatrix)
 	OctreeNodeCollection nodesToUpdate; nodesToUpdate.reserve(getRoot()->getSize() + 1);
 	nodesToUpdate.push_back(_pRoot);
 
+	// Nodes are built in the Octree Model's frame, which then follows the model
+	const Matrix nodeWorldMatrix = _pOctreeNodeArena->hasFrame() ? _pOctreeNodeArena->getFrame() * worldMatrix : worldMatrix;
+
 	while (!nodesToUpdate.empty())
 	{
 		OctreeNode* pNode = nodesToUpdate.back(); 
 		nodesToUpdate.pop_back();
 
-		pNode->getOBB().setWorldMatrix(worldMatrix);
+		pNode->getOBB().setWorldMatrix(nodeWorldMatrix);
 
 		for (int i = 0; i < OctreeNode::NUMBER_OF_CHILDREN; i++)
 		{
@@ -133,3 +143,8 @@ int CollisionVolumeOctree::getMaxDepth() const
 {
 	return _maxDepth - 1;
 }
+
+OctreeTools::BuildMode CollisionVolumeOctree::getBuildMode() const
+{
+	return _buildMode;
+}
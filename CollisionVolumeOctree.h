@@ -5,8 +5,10 @@
 #include "CollisionVolume.h"
 #include "CollisionVolumeOBB.h"
 #include "Matrix.h"
+#include "OctreeTools.h"
 
 class OctreeNode;
+class OctreeNodeArena;
 
 class CollisionVolumeOctree : public CollisionVolume
 {
@@ -14,13 +16,13 @@ class CollisionVolumeOctree : public CollisionVolume
 
 public:
 	CollisionVolumeOctree() = delete;
-	CollisionVolumeOctree(const CollisionVolumeOctree&) = default;
-	CollisionVolumeOctree& operator=(const CollisionVolumeOctree&) = default;
-	CollisionVolumeOctree(CollisionVolumeOctree&&) = default;
-	CollisionVolumeOctree& operator=(CollisionVolumeOctree&&) = default;
+	CollisionVolumeOctree(const CollisionVolumeOctree&) = delete;
+	CollisionVolumeOctree& operator=(const CollisionVolumeOctree&) = delete;
+	CollisionVolumeOctree(CollisionVolumeOctree&&) = delete;
+	CollisionVolumeOctree& operator=(CollisionVolumeOctree&&) = delete;
 	~CollisionVolumeOctree();
 
-	CollisionVolumeOctree(Model* pModel, int maxDepth);
+	CollisionVolumeOctree(Model* pModel, int maxDepth, OctreeTools::BuildMode buildMode);
 
 	// Inherited via CollisionVolume
 	virtual void computeData(Model* pModel, const Matrix& worldMatrix) override;
@@ -37,6 +39,7 @@ public:
 	const OctreeNode* getRoot() const;
 
 	virtual int getMaxDepth() const override;
+	OctreeTools::BuildMode getBuildMode() const;
 
 private:
 	OctreeNodeCollection getAllNodes() const;
@@ -45,7 +48,13 @@ private:
 	void drawAt(int depth, const Vect& color, const OctreeNode* pNode) const;
 
 private:
+	// Model of the Octree Model this Octree is an instance of
+	Model* _pModel;
+	OctreeNodeArena* _pOctreeNodeArena;
 	OctreeNode* _pRoot;
+	OctreeTools::BuildMode _buildMode;
+	// Read from OctreeModelManager::GetFrameMode() when created
+	OctreeTools::FrameMode _frameMode;
 	int _maxDepth;
 };
 #endif // !_CollisionVolumeOctree
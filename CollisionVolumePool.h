@@ -0,0 +1,114 @@
+#ifndef _CollisionVolumePool
+#define _CollisionVolumePool
+
+#include <vector>
+#include <cassert>
+#include <cstddef>
+
+/**********************************************************************************************//**
+ * <summary> A pool of elements addressed by a stable index, in fixed size blocks.</summary>
+ *
+ * <remarks> Destroyed indices are reused by the next create(), so indices stay stable for the
+ *			 lifetime of the element. The pool grows a block at a time and never moves its
+ *			 elements: references stay valid until the element is destroyed, even across
+ *			 create() (e.g. a collision callback spawning a collidable). Used by
+ *			 CollisionVolumeStorage. </remarks>
+ *
+ * <typeparam name="Element"> Type of the element (default constructible).</typeparam>
+ **************************************************************************************************/
+template <typename Element>
+class CollisionVolumePool
+{
+private:
+	typedef std::vector<Element*> BlockCollection;
+	typedef std::vector<int> IndexCollection;
+
+	// Elements per block (a power of 2: the block of an index is a shift away)
+	static const int BLOCK_SHIFT = 8;
+	static const int BLOCK_SIZE = 1 << BLOCK_SHIFT;
+
+public:
+	CollisionVolumePool()
+		: _slotCount(0)
+	{}
+
+	CollisionVolumePool(const CollisionVolumePool&) = delete;
+	CollisionVolumePool& operator=(const CollisionVolumePool&) = delete;
+	CollisionVolumePool(CollisionVolumePool&&) = delete;
+	CollisionVolumePool& operator=(CollisionVolumePool&&) = delete;
+
+	~CollisionVolumePool()
+	{
+		for (Element* pBlock : _pBlocks)
+		{
+			delete[] pBlock;
+		}
+	}
+
+	int create()
+	{
+		if (!_freeIndices.empty())
+		{
+			const int index = _freeIndices.back();
+			_freeIndices.pop_back();
+			return index;
+		}
+
+		reserve(_slotCount + 1);
+		return static_cast<int>(_slotCount++);
+	}
+
+	void destroy(int index)
+	{
+		assert(index >= 0 && static_cast<size_t>(index) < _slotCount);
+		getAt(index) = Element();
+		_freeIndices.push_back(index);
+	}
+
+	Element& getAt(int index)
+	{
+		assert(index >= 0 && static_cast<size_t>(index) < _slotCount);
+		return _pBlocks[index >> BLOCK_SHIFT][index & (BLOCK_SIZE - 1)];
+	}
+
+	const Element& getAt(int index) const
+	{
+		assert(index >= 0 && static_cast<size_t>(index) < _slotCount);
+		return _pBlocks[index >> BLOCK_SHIFT][index & (BLOCK_SIZE - 1)];
+	}
+
+	void reserve(size_t capacity)
+	{
+		while (_pBlocks.size() * BLOCK_SIZE < capacity)
+		{
+			_pBlocks.push_back(new Element[BLOCK_SIZE]);
+		}
+	}
+
+	size_t getSize() const
+	{
+		return _slotCount - _freeIndices.size();
+	}
+
+	// Number of slots, including the destroyed ones
+	size_t getSlotCount() const
+	{
+		return _slotCount;
+	}
+
+private:
+	BlockCollection _pBlocks;
+	IndexCollection _freeIndices;
+	size_t _slotCount;
+};
+
+template <typename Element>
+const int CollisionVolumePool<Element>::BLOCK_SHIFT;
+
+template <typename Element>
+const int CollisionVolumePool<Element>::BLOCK_SIZE;
+#endif // !_CollisionVolumePool
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionVolumePool Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
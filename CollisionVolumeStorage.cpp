@@ -0,0 +1,127 @@
+#include "CollisionVolumeStorage.h"
+#include "CollisionVolumeOctree.h"
+#include <cassert>
+
+CollisionVolumeStorage::~CollisionVolumeStorage()
+{
+	// Destroyed slots hold nullptr
+	for (size_t i = 0; i < _pOctrees.getSlotCount(); i++)
+	{
+		delete _pOctrees.getAt(static_cast<int>(i));
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Creation/Destruction
+//-----------------------------------------------------------------------------------------------------------------------------
+CollisionVolumeStorage::Handle CollisionVolumeStorage::create(CollisionVolume::Type type)
+{
+	Handle handle;
+	handle.type = type;
+
+	switch (type)
+	{
+	case CollisionVolume::Type::BSPHERE:
+		handle.index = _BSpheres.create();
+		break;
+	case CollisionVolume::Type::AABB:
+		handle.index = _AABBs.create();
+		break;
+	case CollisionVolume::Type::OBB:
+		handle.index = _OBBs.create();
+		break;
+	default:
+		// Octrees need a model (see createOctree)
+		assert(false);
+		break;
+	}
+
+	return handle;
+}
+
+CollisionVolumeStorage::Handle CollisionVolumeStorage::createOctree(Model* pModel, int maxDepth, OctreeTools::BuildMode buildMode)
+{
+	Handle handle;
+	handle.type = CollisionVolume::Type::OCTREE;
+	handle.index = _pOctrees.create();
+	_pOctrees.getAt(handle.index) = new CollisionVolumeOctree(pModel, maxDepth, buildMode);
+
+	return handle;
+}
+
+void CollisionVolumeStorage::destroy(Handle& handle)
+{
+	assert(handle.isValid());
+
+	switch (handle.type)
+	{
+	case CollisionVolume::Type::BSPHERE:
+		_BSpheres.destroy(handle.index);
+		break;
+	case CollisionVolume::Type::AABB:
+		_AABBs.destroy(handle.index);
+		break;
+	case CollisionVolume::Type::OBB:
+		_OBBs.destroy(handle.index);
+		break;
+	case CollisionVolume::Type::OCTREE:
+		delete _pOctrees.getAt(handle.index);
+		_pOctrees.destroy(handle.index);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	handle = Handle();
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Getters
+//-----------------------------------------------------------------------------------------------------------------------------
+CollisionVolume& CollisionVolumeStorage::get(const Handle& handle)
+{
+	return const_cast<CollisionVolume&>(static_cast<const CollisionVolumeStorage&>(*this).get(handle));
+}
+
+const CollisionVolume& CollisionVolumeStorage::get(const Handle& handle) const
+{
+	assert(handle.isValid());
+
+	switch (handle.type)
+	{
+	case CollisionVolume::Type::BSPHERE:
+		return _BSpheres.getAt(handle.index);
+	case CollisionVolume::Type::AABB:
+		return _AABBs.getAt(handle.index);
+	case CollisionVolume::Type::OBB:
+		return _OBBs.getAt(handle.index);
+	default:
+		assert(handle.type == CollisionVolume::Type::OCTREE);
+		return *_pOctrees.getAt(handle.index);
+	}
+}
+
+CollisionVolumeBSphere& CollisionVolumeStorage::getBSphere(const Handle& handle)
+{
+	assert(handle.type == CollisionVolume::Type::BSPHERE);
+	return _BSpheres.getAt(handle.index);
+}
+
+CollisionVolumeAABB& CollisionVolumeStorage::getAABB(const Handle& handle)
+{
+	assert(handle.type == CollisionVolume::Type::AABB);
+	return _AABBs.getAt(handle.index);
+}
+
+CollisionVolumeOBB& CollisionVolumeStorage::getOBB(const Handle& handle)
+{
+	assert(handle.type == CollisionVolume::Type::OBB);
+	return _OBBs.getAt(handle.index);
+}
+
+CollisionVolumeOctree& CollisionVolumeStorage::getOctree(const Handle& handle)
+{
+	assert(handle.type == CollisionVolume::Type::OCTREE);
+	return *_pOctrees.getAt(handle.index);
+}
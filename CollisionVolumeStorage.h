@@ -0,0 +1,96 @@
+#ifndef _CollisionVolumeStorage
+#define _CollisionVolumeStorage
+
+#include "CollisionVolume.h"
+#include "CollisionVolumePool.h"
+#include "CollisionVolumeBSphere.h"
+#include "CollisionVolumeAABB.h"
+#include "CollisionVolumeOBB.h"
+#include "OctreeTools.h"
+
+class CollisionVolumeOctree;
+class Model;
+
+/**********************************************************************************************//**
+ * <summary> Owns the collision volumes of every Collidable, one contiguous pool per volume type.</summary>
+ *
+ * <remarks> Owned by the CollisionManager, used by the collidables in
+ *			 Collidable::VolumeStorageMode::SCENE. Collidables hold a Handle to release them.
+ *			 Octrees are kept as pointers (their nodes already live in one arena per tree).
+ *			 Collidables must release their handles before the CollisionManager is destroyed. </remarks>
+ **************************************************************************************************/
+class CollisionVolumeStorage
+{
+public:
+	struct Handle
+	{
+		CollisionVolume::Type type = CollisionVolume::Type::COUNT;
+		int index = -1;
+
+		bool isValid() const
+		{
+			return index >= 0;
+		}
+	};
+
+public:
+	CollisionVolumeStorage() = default;
+	CollisionVolumeStorage(const CollisionVolumeStorage&) = delete;
+	CollisionVolumeStorage& operator=(const CollisionVolumeStorage&) = delete;
+	CollisionVolumeStorage(CollisionVolumeStorage&&) = delete;
+	CollisionVolumeStorage& operator=(CollisionVolumeStorage&&) = delete;
+	~CollisionVolumeStorage();
+
+	/**********************************************************************************************//**
+	 * <summary> Creates a BSphere, AABB or OBB collision volume.</summary>
+	 *
+	 * <remarks> References previously returned stay valid (the pools never move their
+	 *			 elements). </remarks>
+	 *
+	 * <param name="type"> The type of volume (not OCTREE).</param>
+	 *
+	 * <returns> The handle of the new volume.</returns>
+	 **************************************************************************************************/
+	Handle create(CollisionVolume::Type type);
+
+	/**********************************************************************************************//**
+	 * <summary> Creates an Octree collision volume for a model.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="pModel"> The model.</param>
+	 * <param name="maxDepth"> The depth of the Octree.</param>
+	 * <param name="buildMode"> How the Octree is subdivided.</param>
+	 *
+	 * <returns> The handle of the new volume.</returns>
+	 **************************************************************************************************/
+	Handle createOctree(Model* pModel, int maxDepth, OctreeTools::BuildMode buildMode);
+
+	/**********************************************************************************************//**
+	 * <summary> Destroys a collision volume, its slot is reused by the next creation.</summary>
+	 *
+	 * <remarks> The handle is reset to invalid. </remarks>
+	 *
+	 * <param name="handle"> [in,out] The handle of the volume.</param>
+	 **************************************************************************************************/
+	void destroy(Handle& handle);
+
+	CollisionVolume& get(const Handle& handle);
+	const CollisionVolume& get(const Handle& handle) const;
+
+	CollisionVolumeBSphere& getBSphere(const Handle& handle);
+	CollisionVolumeAABB& getAABB(const Handle& handle);
+	CollisionVolumeOBB& getOBB(const Handle& handle);
+	CollisionVolumeOctree& getOctree(const Handle& handle);
+
+private:
+	CollisionVolumePool<CollisionVolumeBSphere> _BSpheres;
+	CollisionVolumePool<CollisionVolumeAABB> _AABBs;
+	CollisionVolumePool<CollisionVolumeOBB> _OBBs;
+	CollisionVolumePool<CollisionVolumeOctree*> _pOctrees;
+};
+#endif // !_CollisionVolumeStorage
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionVolumeStorage Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
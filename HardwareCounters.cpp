@@ -0,0 +1,188 @@
+#include "HardwareCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#endif // __linux__
+
+namespace
+{
+	const int EVENT_COUNT = static_cast<int>(HardwareCounters::Event::COUNT);
+
+	// Counters of one thread: one perf event group led by the cycles
+	struct ThreadCounters
+	{
+		int fileDescriptors[EVENT_COUNT] = { -1, -1, -1, -1, -1 };
+
+		// Position of each opened event in the group reads, -1 if not counted
+		int readIndices[EVENT_COUNT] = { -1, -1, -1, -1, -1 };
+		int openedCount = 0;
+
+		const char* error = "";
+	};
+
+	thread_local ThreadCounters Counters;
+
+	void SetValue(HardwareCounterValues& values, int eventIndex, unsigned long long value)
+	{
+		switch (static_cast<HardwareCounters::Event>(eventIndex))
+		{
+		case HardwareCounters::Event::CYCLES:
+			values.cycles = value;
+			break;
+		case HardwareCounters::Event::INSTRUCTIONS:
+			values.instructions = value;
+			break;
+		case HardwareCounters::Event::L1D_MISSES:
+			values.L1DMisses = value;
+			break;
+		case HardwareCounters::Event::LLC_MISSES:
+			values.LLCMisses = value;
+			break;
+		default:
+			values.branchMisses = value;
+			break;
+		}
+	}
+
+#if defined(__linux__)
+	// perf event (type and config) of each HardwareCounters::Event
+	void GetEventConfig(int eventIndex, unsigned int& type, unsigned long long& config)
+	{
+		switch (static_cast<HardwareCounters::Event>(eventIndex))
+		{
+		case HardwareCounters::Event::CYCLES:
+			type = PERF_TYPE_HARDWARE;
+			config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case HardwareCounters::Event::INSTRUCTIONS:
+			type = PERF_TYPE_HARDWARE;
+			config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case HardwareCounters::Event::L1D_MISSES:
+			type = PERF_TYPE_HW_CACHE;
+			config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			break;
+		case HardwareCounters::Event::LLC_MISSES:
+			type = PERF_TYPE_HARDWARE;
+			config = PERF_COUNT_HW_CACHE_MISSES;
+			break;
+		default:
+			type = PERF_TYPE_HARDWARE;
+			config = PERF_COUNT_HW_BRANCH_MISSES;
+			break;
+		}
+	}
+
+	int OpenEvent(int eventIndex, int groupFileDescriptor)
+	{
+		perf_event_attr attributes;
+		memset(&attributes, 0, sizeof(attributes));
+		attributes.size = sizeof(attributes);
+		GetEventConfig(eventIndex, attributes.type, attributes.config);
+		attributes.disabled = (groupFileDescriptor == -1) ? 1 : 0;
+		attributes.exclude_kernel = 1;
+		attributes.exclude_hv = 1;
+		attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+		// This thread, any CPU
+		return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupFileDescriptor, 0));
+	}
+#endif // __linux__
+}
+
+bool HardwareCounters::Open()
+{
+	if (HardwareCounters::IsOpen()) return true;
+
+#if defined(__linux__)
+	Counters = ThreadCounters();
+
+	const int groupFileDescriptor = OpenEvent(static_cast<int>(Event::CYCLES), -1);
+	if (groupFileDescriptor == -1)
+	{
+		Counters.error = (errno == EACCES || errno == EPERM) ? "perf_event_open is not permitted (see kernel.perf_event_paranoid)"
+			: "the CPU cycles event is not available";
+		return false;
+	}
+
+	for (int eventIndex = 0; eventIndex < EVENT_COUNT; eventIndex++)
+	{
+		const int fileDescriptor = (eventIndex == static_cast<int>(Event::CYCLES)) ? groupFileDescriptor : OpenEvent(eventIndex, groupFileDescriptor);
+		if (fileDescriptor == -1) continue;
+
+		Counters.fileDescriptors[eventIndex] = fileDescriptor;
+		Counters.readIndices[eventIndex] = Counters.openedCount++;
+	}
+
+	ioctl(groupFileDescriptor, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(groupFileDescriptor, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	return true;
+#else
+	Counters.error = "hardware counters are only supported on Linux";
+	return false;
+#endif // __linux__
+}
+
+void HardwareCounters::Close()
+{
+#if defined(__linux__)
+	for (int fileDescriptor : Counters.fileDescriptors)
+	{
+		if (fileDescriptor != -1)
+		{
+			close(fileDescriptor);
+		}
+	}
+#endif // __linux__
+	Counters = ThreadCounters();
+}
+
+bool HardwareCounters::IsOpen()
+{
+	return Counters.openedCount > 0;
+}
+
+bool HardwareCounters::IsCounting(Event event)
+{
+	return Counters.readIndices[static_cast<int>(event)] != -1;
+}
+
+const char* HardwareCounters::GetError()
+{
+	return Counters.error;
+}
+
+HardwareCounterValues HardwareCounters::Read()
+{
+	HardwareCounterValues values;
+
+#if defined(__linux__)
+	if (!HardwareCounters::IsOpen()) return values;
+
+	// Group read: event count, time enabled, time running, then one value per event
+	uint64_t buffer[3 + EVENT_COUNT];
+	const ssize_t size = read(Counters.fileDescriptors[static_cast<int>(Event::CYCLES)], buffer, sizeof(buffer));
+	if (size < static_cast<ssize_t>(3 * sizeof(uint64_t)) || buffer[0] != static_cast<uint64_t>(Counters.openedCount)) return values;
+
+	const uint64_t timeEnabled = buffer[1];
+	const uint64_t timeRunning = buffer[2];
+	const double scale = (timeRunning > 0 && timeRunning < timeEnabled) ? static_cast<double>(timeEnabled) / timeRunning : 1.0;
+
+	for (int eventIndex = 0; eventIndex < EVENT_COUNT; eventIndex++)
+	{
+		const int readIndex = Counters.readIndices[eventIndex];
+		if (readIndex == -1) continue;
+
+		const uint64_t value = buffer[3 + readIndex];
+		SetValue(values, eventIndex, (scale == 1.0) ? value : static_cast<unsigned long long>(value * scale));
+	}
+#endif // __linux__
+
+	return values;
+}
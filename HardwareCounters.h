@@ -0,0 +1,107 @@
+#ifndef _HardwareCounters
+#define _HardwareCounters
+
+/**********************************************************************************************//**
+ * <summary> Hardware performance counter values (CPU events) of a span of code.</summary>
+ *
+ * <remarks> Counts of user space events of the thread. When the kernel had to share the counters
+ *			 with other events, they are scaled to the time they were enabled. Events the CPU or
+ *			 the kernel do not provide stay at 0. </remarks>
+ **************************************************************************************************/
+struct HardwareCounterValues
+{
+	unsigned long long cycles = 0;
+	unsigned long long instructions = 0;
+	unsigned long long L1DMisses = 0;
+	unsigned long long LLCMisses = 0;
+	unsigned long long branchMisses = 0;
+
+	double getInstructionsPerCycle() const
+	{
+		return (cycles > 0) ? static_cast<double>(instructions) / cycles : 0.0;
+	}
+
+	HardwareCounterValues& operator+=(const HardwareCounterValues& other)
+	{
+		cycles += other.cycles;
+		instructions += other.instructions;
+		L1DMisses += other.L1DMisses;
+		LLCMisses += other.LLCMisses;
+		branchMisses += other.branchMisses;
+		return *this;
+	}
+
+	// Counts between two reads (scaled counts may go back a little, clamped to 0)
+	HardwareCounterValues operator-(const HardwareCounterValues& start) const
+	{
+		HardwareCounterValues difference;
+		difference.cycles = GetDifference(cycles, start.cycles);
+		difference.instructions = GetDifference(instructions, start.instructions);
+		difference.L1DMisses = GetDifference(L1DMisses, start.L1DMisses);
+		difference.LLCMisses = GetDifference(LLCMisses, start.LLCMisses);
+		difference.branchMisses = GetDifference(branchMisses, start.branchMisses);
+		return difference;
+	}
+
+private:
+	static unsigned long long GetDifference(unsigned long long end, unsigned long long start)
+	{
+		return (end > start) ? end - start : 0;
+	}
+};
+
+/**********************************************************************************************//**
+// namespace: HardwareCounters
+//
+// summary:	Optional hardware performance counters of the calling thread, through Linux
+//			perf_event_open.
+//
+// remarks:	Closed by default. Once opened on the thread running CollisionManager::
+//			processCollisions(), the CollisionFrameStats of every frame hold the counts of each
+//			stage and of each command's execute(). Reading the counters is one system call, so
+//			they are read a few times per command, never per pair. Opening fails on other
+//			platforms, and on Linux when the CPU events are not exposed (e.g. virtual machines)
+//			or kernel.perf_event_paranoid forbids them.
+ **************************************************************************************************/
+namespace HardwareCounters
+{
+	enum class Event
+	{
+		CYCLES,
+		INSTRUCTIONS,
+		L1D_MISSES,
+		LLC_MISSES,
+		BRANCH_MISSES,
+		COUNT
+	};
+
+	/**********************************************************************************************//**
+	 * <summary> Opens the counters of the calling thread.</summary>
+	 *
+	 * <remarks> Succeeds if at least the cycles can be counted. Events that cannot be counted
+	 *			 stay at 0 (see IsCounting()). </remarks>
+	 *
+	 * <returns> False if the counters are not available.</returns>
+	 **************************************************************************************************/
+	bool Open();
+
+	// Closes the counters of the calling thread
+	void Close();
+
+	// True once Open() succeeded on the calling thread
+	bool IsOpen();
+
+	// True if the event is counted on the calling thread
+	bool IsCounting(Event event);
+
+	// Why the last Open() of the calling thread failed, empty if it succeeded
+	const char* GetError();
+
+	// Current counts of the calling thread (all 0 when not open)
+	HardwareCounterValues Read();
+};
+#endif // !_HardwareCounters
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// HardwareCounters Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -7,6 +7,7 @@
 
 #include "OctreeNode.h"
 #include "OctreeTools.h"
+#include "CollisionStats.h"
 
 #include "Triangle.h"
 #include "Colors.h"
@@ -15,13 +16,15 @@
 #include <list>
 #include <array>
 #include <set>
+#include <cfloat>
+#include <cmath>
 
 #ifndef MathTools_DEBUG
 #define	MathTools_DEBUG 0
 #endif // !MathTools_DEBUG
 
 #ifndef MathTools_Octree_DEBUG
-#define	MathTools_Octree_DEBUG 1
+#define	MathTools_Octree_DEBUG 0
 #endif // !MathTools_Octree_DEBUG
 
 void drawTriangleTMP(const Triangle& triangle)
@@ -41,9 +44,63 @@ void drawTriangleTMP(const Triangle& triangle)
 //-----------------------------------------------------------------------------------------------------------------------------
 // Intersection Testing
 //-----------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	typedef bool(*IntersectFunction)(const CollisionVolume&, const CollisionVolume&);
+
+	// Calls the concrete kernel for an ordered pair (volume 1 is the kernel's first argument)
+	template <typename CollisionVolume_1, typename CollisionVolume_2>
+	bool IntersectOrdered(const CollisionVolume& collisionVolume_1, const CollisionVolume& collisionVolume_2)
+	{
+		return MathTools::Intersect(static_cast<const CollisionVolume_1&>(collisionVolume_1), static_cast<const CollisionVolume_2&>(collisionVolume_2));
+	}
+
+	// Calls the concrete kernel for a swapped pair (kernels only exist for one order)
+	template <typename CollisionVolume_1, typename CollisionVolume_2>
+	bool IntersectSwapped(const CollisionVolume& collisionVolume_1, const CollisionVolume& collisionVolume_2)
+	{
+		return MathTools::Intersect(static_cast<const CollisionVolume_2&>(collisionVolume_2), static_cast<const CollisionVolume_1&>(collisionVolume_1));
+	}
+
+	const int NUMBER_OF_TYPES = static_cast<int>(CollisionVolume::Type::COUNT);
+
+	// Indexed by [type 1][type 2], must follow the order of CollisionVolume::Type
+	const IntersectFunction IntersectTable[NUMBER_OF_TYPES][NUMBER_OF_TYPES] =
+	{
+		{
+			IntersectOrdered<CollisionVolumeBSphere, CollisionVolumeBSphere>,
+			IntersectOrdered<CollisionVolumeBSphere, CollisionVolumeAABB>,
+			IntersectOrdered<CollisionVolumeBSphere, CollisionVolumeOBB>,
+			IntersectOrdered<CollisionVolumeBSphere, CollisionVolumeOctree>
+		},
+		{
+			IntersectSwapped<CollisionVolumeAABB, CollisionVolumeBSphere>,
+			IntersectOrdered<CollisionVolumeAABB, CollisionVolumeAABB>,
+			IntersectOrdered<CollisionVolumeAABB, CollisionVolumeOBB>,
+			IntersectOrdered<CollisionVolumeAABB, CollisionVolumeOctree>
+		},
+		{
+			IntersectSwapped<CollisionVolumeOBB, CollisionVolumeBSphere>,
+			IntersectSwapped<CollisionVolumeOBB, CollisionVolumeAABB>,
+			IntersectOrdered<CollisionVolumeOBB, CollisionVolumeOBB>,
+			IntersectOrdered<CollisionVolumeOBB, CollisionVolumeOctree>
+		},
+		{
+			IntersectSwapped<CollisionVolumeOctree, CollisionVolumeBSphere>,
+			IntersectSwapped<CollisionVolumeOctree, CollisionVolumeAABB>,
+			IntersectSwapped<CollisionVolumeOctree, CollisionVolumeOBB>,
+			IntersectOrdered<CollisionVolumeOctree, CollisionVolumeOctree>
+		}
+	};
+}
+
 bool MathTools::Intersect(const CollisionVolume& collisionVolume_1, const CollisionVolume& collisionVolume_2)
 {
-	return collisionVolume_1.intersectAccept(collisionVolume_2);
+	const int typeIndex_1 = static_cast<int>(collisionVolume_1.getType());
+	const int typeIndex_2 = static_cast<int>(collisionVolume_2.getType());
+	assert(typeIndex_1 < NUMBER_OF_TYPES && typeIndex_2 < NUMBER_OF_TYPES);
+
+	return IntersectTable[typeIndex_1][typeIndex_2](collisionVolume_1, collisionVolume_2);
 }
 
 // BSpheres
@@ -92,7 +149,7 @@ bool MathTools::Intersect(const CollisionVolumeBSphere& BSphere, const Collision
 
 bool MathTools::Intersect(const CollisionVolumeBSphere& BSphere, const CollisionVolumeOctree& Octree)
 {
-	return MathTools::Intersect(static_cast<const CollisionVolume&>(BSphere), Octree);
+	return MathTools::IntersectOctree(BSphere, Octree);
 }
 
 // AABBs
@@ -120,6 +177,7 @@ bool MathTools::Intersect(const CollisionVolumeAABB& AABB, const CollisionVolume
 	MathTools::OutputAxesToTest(AABB, OBB, axes);
 
 	bool doesIntersects = true;
+	int axesTested = 0;
 
 	for (int i = 0; i < numberOfAxes && doesIntersects; i++)
 	{
@@ -127,15 +185,22 @@ bool MathTools::Intersect(const CollisionVolumeAABB& AABB, const CollisionVolume
 		if (axis.magSqr() > FLT_EPSILON)
 		{
 			doesIntersects = MathTools::DoesOverlapsOnAxis(AABB, OBB, axis);
+			axesTested++;
 		}
 	}
 
+	CollisionCommandStats* const pStats = CollisionCounters::GetActive();
+	if (pStats != nullptr)
+	{
+		pStats->SATAxes += axesTested;
+	}
+
 	return doesIntersects;
 }
 
 bool MathTools::Intersect(const CollisionVolumeAABB& AABB, const CollisionVolumeOctree& Octree)
 {
-	return MathTools::Intersect(static_cast<const CollisionVolume&>(AABB), Octree);
+	return MathTools::IntersectOctree(AABB, Octree);
 }
 
 // OBBs
@@ -146,6 +211,7 @@ bool MathTools::Intersect(const CollisionVolumeOBB& OBB_1, const CollisionVolume
 	MathTools::OutputAxesToTest(OBB_1, OBB_2, axes);
 
 	bool doesIntersects = true;
+	int axesTested = 0;
 
 	for (int i = 0; i < numberOfAxes && doesIntersects; i++)
 	{
@@ -153,15 +219,22 @@ bool MathTools::Intersect(const CollisionVolumeOBB& OBB_1, const CollisionVolume
 		if (axis.magSqr() > FLT_EPSILON)
 		{
 			doesIntersects = MathTools::DoesOverlapsOnAxis(OBB_1, OBB_2, axis);
+			axesTested++;
 		}
 	}
 
+	CollisionCommandStats* const pStats = CollisionCounters::GetActive();
+	if (pStats != nullptr)
+	{
+		pStats->SATAxes += axesTested;
+	}
+
 	return doesIntersects;
 }
 
 bool MathTools::Intersect(const CollisionVolumeOBB& OBB, const CollisionVolumeOctree& Octree)
 {
-	return MathTools::Intersect(static_cast<const CollisionVolume&>(OBB), Octree);
+	return MathTools::IntersectOctree(OBB, Octree);
 }
 
 // Octrees
@@ -171,6 +244,7 @@ bool MathTools::Intersect(const CollisionVolumeOctree& Octree_1, const Collision
 	std::set<const OctreeNode*> nodesThatCollide;
 #endif // MathTools_Octree_DEBUG
 
+	CollisionCommandStats* const pStats = CollisionCounters::GetActive();
 	OctreeTools::NodePairStack nodePairsToTest;
 
 	// Add first node pair (Root node of Octree 1 and of Octree 2) to test
@@ -179,8 +253,12 @@ bool MathTools::Intersect(const CollisionVolumeOctree& Octree_1, const Collision
 	while (!nodePairsToTest.empty())
 	{
 		// Get get node pair to test and...
-		const OctreeTools::NodePair& nodePair = nodePairsToTest.top();
+		const OctreeTools::NodePair nodePair = nodePairsToTest.top();
 		nodePairsToTest.pop();
+		if (pStats != nullptr)
+		{
+			pStats->octreeNodePairVisits++;
+		}
 
 		// Get node 1 and node 2
 		const OctreeNode* pNode_1 = nodePair.first;
@@ -236,20 +314,46 @@ bool MathTools::Intersect(const CollisionVolumeOctree& Octree_1, const Collision
 }
 
 bool MathTools::Intersect(const CollisionVolume& collisionVolume, const CollisionVolumeOctree& Octree)
+{
+	switch (collisionVolume.getType())
+	{
+	case CollisionVolume::Type::BSPHERE:
+		return MathTools::IntersectOctree(static_cast<const CollisionVolumeBSphere&>(collisionVolume), Octree);
+	case CollisionVolume::Type::AABB:
+		return MathTools::IntersectOctree(static_cast<const CollisionVolumeAABB&>(collisionVolume), Octree);
+	case CollisionVolume::Type::OBB:
+		return MathTools::IntersectOctree(static_cast<const CollisionVolumeOBB&>(collisionVolume), Octree);
+	case CollisionVolume::Type::OCTREE:
+		return MathTools::Intersect(static_cast<const CollisionVolumeOctree&>(collisionVolume), Octree);
+	default:
+		assert(false);
+		return false;
+	}
+}
+
+template <typename CollisionVolumeType>
+bool MathTools::IntersectOctree(const CollisionVolumeType& collisionVolume, const CollisionVolumeOctree& Octree)
 {
 #if MathTools_Octree_DEBUG
 	// Create list for rendering collision volumes for debugging
 	std::list<const OctreeNode*> nodesThatCollide;
 #endif // MathTools_Octree_DEBUG
 
-	OctreeTools::NodeStack nodesToTest;
+	assert(Octree.getMaxDepth() <= OctreeTools::MAX_DEPTH);
+
+	CollisionCommandStats* const pStats = CollisionCounters::GetActive();
+	OctreeTools::FixedNodeStack nodesToTest;
 	nodesToTest.push(Octree.getRoot());
 
 	while (!nodesToTest.empty())
 	{
-		const OctreeNode* pNode = nodesToTest.top();
-		nodesToTest.pop();
+		const OctreeNode* pNode = nodesToTest.pop();
+		if (pStats != nullptr)
+		{
+			pStats->octreeNodeVisits++;
+		}
 
+		// Resolved at compile time for each collision volume type (no virtual call per node)
 		if (MathTools::Intersect(collisionVolume, pNode->getOBB()))
 		{
 #if MathTools_Octree_DEBUG
@@ -286,6 +390,10 @@ bool MathTools::Intersect(const CollisionVolume& collisionVolume, const Collisio
 	return false;
 }
 
+template bool MathTools::IntersectOctree<CollisionVolumeBSphere>(const CollisionVolumeBSphere&, const CollisionVolumeOctree&);
+template bool MathTools::IntersectOctree<CollisionVolumeAABB>(const CollisionVolumeAABB&, const CollisionVolumeOctree&);
+template bool MathTools::IntersectOctree<CollisionVolumeOBB>(const CollisionVolumeOBB&, const CollisionVolumeOctree&);
+
 // Points
 bool MathTools::Intersect(const CollisionVolumeAABB& AABB, const Vect& point)
 {
@@ -358,7 +466,7 @@ void MathTools::OutputAxesToTest(const CollisionVolumeAABB& AABB, const Collisio
 
 bool MathTools::DoesOverlapsOnAxis(const CollisionVolumeOBB& OBB_1, const CollisionVolumeOBB& OBB_2, const Vect& axis)
 {
-	float d = abs(MathTools::ProjectionLength(OBB_2.getWorldCenter() - OBB_1.getWorldCenter(), axis));
+	float d = std::abs(MathTools::ProjectionLength(OBB_2.getWorldCenter() - OBB_1.getWorldCenter(), axis));
 	float p1 = getMaxBoxProjectionLength(OBB_1, axis);
 	float p2 = getMaxBoxProjectionLength(OBB_2, axis);
 
@@ -383,7 +491,7 @@ bool MathTools::DoesOverlapsOnAxis(const CollisionVolumeOBB& OBB_1, const Collis
 
 bool MathTools::DoesOverlapsOnAxis(const CollisionVolumeAABB& AABB, const CollisionVolumeOBB& OBB, const Vect& axis)
 {
-	float d = abs(MathTools::ProjectionLength(AABB.getWorldCenter() - OBB.getWorldCenter(), axis));
+	float d = std::abs(MathTools::ProjectionLength(AABB.getWorldCenter() - OBB.getWorldCenter(), axis));
 	float p1 = getMaxBoxProjectionLength(AABB, axis);
 	float p2 = getMaxBoxProjectionLength(OBB, axis);
 
@@ -453,6 +561,7 @@ bool MathTools::Intersect(const CollisionVolumeOBB& OBB, const Triangle& triangl
 	MathTools::OutputAxesToTest(OBB, adjustTriangle, axes);
 
 	bool doesIntersects = true;
+	int axesTested = 0;
 
 	for (int i = 0; i < numberOfAxes && doesIntersects; i++)
 	{
@@ -460,9 +569,16 @@ bool MathTools::Intersect(const CollisionVolumeOBB& OBB, const Triangle& triangl
 		if (axis.magSqr() > FLT_EPSILON)
 		{
 			doesIntersects = MathTools::DoesOverlapsOnAxis(OBB, adjustTriangle, axis);
+			axesTested++;
 		}
 	}
 
+	CollisionCommandStats* const pStats = CollisionCounters::GetActive();
+	if (pStats != nullptr)
+	{
+		pStats->SATAxes += axesTested;
+	}
+
 	return doesIntersects;
 }
 
@@ -519,6 +635,76 @@ bool MathTools::DoesOverlapsOnAxis(const CollisionVolumeOBB& OBB, const Triangle
 	return !(std::max(-max, min) > r);
 }
 
+namespace
+{
+	float GetMaxAbsoluteComponent(const Vect& vect)
+	{
+		return std::max(std::abs(vect[x]), std::max(std::abs(vect[y]), std::abs(vect[z])));
+	}
+
+	// Projections of the triangle's vertices [min, max] miss [-r, r]
+	bool IsSeparated(float p0, float p1, float p2, float r)
+	{
+		return std::min(p0, std::min(p1, p2)) > r || std::max(p0, std::max(p1, p2)) < -r;
+	}
+
+	// Tests the cross products of the box axes with a triangle edge (vertices relative to the box center)
+	bool IsSeparatedOnEdgeAxes(const Vect& edge, const Vect& vertex0, const Vect& vertex1, const Vect& vertex2, const Vect& halfSize)
+	{
+		const float absoluteX = std::abs(edge[x]);
+		const float absoluteY = std::abs(edge[y]);
+		const float absoluteZ = std::abs(edge[z]);
+
+		// x cross edge = (0, -edge z, edge y)
+		if (IsSeparated(edge[y] * vertex0[z] - edge[z] * vertex0[y], edge[y] * vertex1[z] - edge[z] * vertex1[y],
+			edge[y] * vertex2[z] - edge[z] * vertex2[y], halfSize[y] * absoluteZ + halfSize[z] * absoluteY)) return true;
+
+		// y cross edge = (edge z, 0, -edge x)
+		if (IsSeparated(edge[z] * vertex0[x] - edge[x] * vertex0[z], edge[z] * vertex1[x] - edge[x] * vertex1[z],
+			edge[z] * vertex2[x] - edge[x] * vertex2[z], halfSize[x] * absoluteZ + halfSize[z] * absoluteX)) return true;
+
+		// z cross edge = (-edge y, edge x, 0)
+		return IsSeparated(edge[x] * vertex0[y] - edge[y] * vertex0[x], edge[x] * vertex1[y] - edge[y] * vertex1[x],
+			edge[x] * vertex2[y] - edge[y] * vertex2[x], halfSize[x] * absoluteY + halfSize[y] * absoluteX);
+	}
+}
+
+bool MathTools::IntersectBoxTriangle(const Vect& minVertex, const Vect& maxVertex, const Triangle& triangle)
+{
+	// Box face axes: the triangle's bounds against the box (before centering, so touching is exact)
+	const Vect minTriangleVertex = MathTools::Min(triangle.getVertex0(), MathTools::Min(triangle.getVertex1(), triangle.getVertex2()));
+	const Vect maxTriangleVertex = MathTools::Max(triangle.getVertex0(), MathTools::Max(triangle.getVertex1(), triangle.getVertex2()));
+	if (minTriangleVertex[x] > maxVertex[x] || maxTriangleVertex[x] < minVertex[x]) return false;
+	if (minTriangleVertex[y] > maxVertex[y] || maxTriangleVertex[y] < minVertex[y]) return false;
+	if (minTriangleVertex[z] > maxVertex[z] || maxTriangleVertex[z] < minVertex[z]) return false;
+
+	// Centering rounds by up to a few ulps of the box's coordinates: the other axes use the box
+	// grown by that much, so rounding never separates a touching triangle
+	const Vect center = (minVertex + maxVertex) * 0.5f;
+	const float roundingError = 4.0f * FLT_EPSILON * std::max(GetMaxAbsoluteComponent(minVertex), GetMaxAbsoluteComponent(maxVertex));
+	const Vect halfSize = (maxVertex - minVertex) * 0.5f + Vect(roundingError, roundingError, roundingError, 0.0f);
+
+	const Vect vertex0 = triangle.getVertex0() - center;
+	const Vect vertex1 = triangle.getVertex1() - center;
+	const Vect vertex2 = triangle.getVertex2() - center;
+
+	// Edge axes (a degenerate axis projects everything to 0 and never separates)
+	const Vect edge01 = vertex1 - vertex0;
+	const Vect edge12 = vertex2 - vertex1;
+	const Vect edge20 = vertex0 - vertex2;
+	if (IsSeparatedOnEdgeAxes(edge01, vertex0, vertex1, vertex2, halfSize)) return false;
+	if (IsSeparatedOnEdgeAxes(edge12, vertex0, vertex1, vertex2, halfSize)) return false;
+	if (IsSeparatedOnEdgeAxes(edge20, vertex0, vertex1, vertex2, halfSize)) return false;
+
+	// Triangle plane against the box. A sliver's normal is mostly rounding error: skip it, the
+	// edge axes already hold the segment it nearly is.
+	const Vect normal = edge01.cross(edge12);
+	if (normal.magSqr() <= FLT_EPSILON * edge01.magSqr() * edge12.magSqr()) return true;
+
+	const float r = halfSize[x] * std::abs(normal[x]) + halfSize[y] * std::abs(normal[y]) + halfSize[z] * std::abs(normal[z]);
+	return !(std::abs(normal.dot(vertex0)) > r);
+}
+
 //-----------------------------------------------------------------------------------------------------------------------------
 // World Matrix Decomposition
 //-----------------------------------------------------------------------------------------------------------------------------
@@ -25,7 +25,8 @@ namespace MathTools
 	/**********************************************************************************************//**
 	* <summary> Test intersection between two collision volumes.</summary>
 	*
-	* <remarks> </remarks>
+	* <remarks> Dispatches on the volume type tags through a table of the concrete tests
+	*			 (no visitor double dispatch). </remarks>
 	*
 	* <param name="collisionVolume_1"> The first collision volume.</param>
 	* <param name="collisionVolume_2"> The second collision volume.</param>
@@ -154,8 +155,33 @@ namespace MathTools
 	**************************************************************************************************/
 	bool Intersect(const CollisionVolumeOctree& Octree_1, const CollisionVolumeOctree& Octree_2);
 
+	/**********************************************************************************************//**
+	* <summary> Test intersection between any collision volume and an Octree.</summary>
+	*	\ingroup MATHTOOLS
+	* <remarks> Dispatches once on the volume type, then traverses with IntersectOctree(). </remarks>
+	*
+	* <param name="collisionVolume"> A collision volume.</param>
+	* <param name="Octree"> An Octree.</param>
+	*
+	* <returns> True if it succeeds, false if it fails.</returns>
+	**************************************************************************************************/
 	bool Intersect(const CollisionVolume& collisionVolume, const CollisionVolumeOctree& Octree);
 
+	/**********************************************************************************************//**
+	* <summary> Test intersection between a concrete collision volume and an Octree.</summary>
+	*	\ingroup MATHTOOLS
+	* <remarks> Traversal is specialized per volume type so the test against each node's OBB
+	*			 is resolved at compile time. Uses a fixed size stack (Octrees up to
+	*			 OctreeTools::MAX_DEPTH). Instantiated for BSphere, AABB and OBB. </remarks>
+	*
+	* <param name="collisionVolume"> A BSphere, AABB or OBB.</param>
+	* <param name="Octree"> An Octree.</param>
+	*
+	* <returns> True if it succeeds, false if it fails.</returns>
+	**************************************************************************************************/
+	template <typename CollisionVolumeType>
+	bool IntersectOctree(const CollisionVolumeType& collisionVolume, const CollisionVolumeOctree& Octree);
+
 	/**********************************************************************************************//**
 	* <summary> Test intersection between an AABB and a point.</summary>
 	*	\ingroup MATHTOOLS
@@ -296,6 +322,23 @@ namespace MathTools
 	**************************************************************************************************/
 	bool DoesOverlapsOnAxis(const CollisionVolumeOBB& OBB, const Triangle& triangle, const Vect& axis);
 
+	/**********************************************************************************************//**
+	* <summary> Test intersection between an axis aligned box and a Triangle, in the same space.</summary>
+	*	\ingroup MATHTOOLS
+	* <remarks> Separating axis test in the style of Akenine-Moller: the box's 3 face axes against
+	*			 the triangle's bounds, the 9 edge axes unnormalized (each projection only uses two
+	*			 components) and the triangle's plane against the box. No matrix and no square
+	*			 root, so it suits boxes built in model space (e.g. Octree nodes while building).
+	*			 Touching counts as intersecting. Not counted in CollisionCommandStats. </remarks>
+	*
+	* <param name="minVertex"> The min vertex of the box.</param>
+	* <param name="maxVertex"> The max vertex of the box.</param>
+	* <param name="triangle"> A triangle.</param>
+	*
+	* <returns> True if it succeeds, false if it fails.</returns>
+	**************************************************************************************************/
+	bool IntersectBoxTriangle(const Vect& minVertex, const Vect& maxVertex, const Triangle& triangle);
+
 	// World Matrix Decomposition
 
 	/**********************************************************************************************//**
@@ -0,0 +1,207 @@
+#include "NarrowPhase.h"
+#include "CollisionDispatch.h"
+#include "Collidable.h"
+#include "CollisionRecorder.h"
+#include "CollisionStats.h"
+#include "CollisionVolumeBSphere.h"
+#include "CollisionVolumeAABB.h"
+#include "CollisionVolumeOBB.h"
+#include "CollisionVolumeOctree.h"
+#include "MathTools.h"
+#include "Visualizer.h"
+#include "Colors.h"
+
+#ifndef NarrowPhase_DEBUG
+#define NarrowPhase_DEBUG 0
+#endif // !NarrowPhase_DEBUG
+
+NarrowPhase::NarrowPhase()
+	: _testCount(0), _collisionCount(0), _isCounting(false), _pRecorder(nullptr)
+{}
+
+void NarrowPhase::addPair(Collidable* pCollidable_1, Collidable* pCollidable_2, CollisionDispatchBase* pCollisionDispatch, CollisionCommandStats* pStats)
+{
+	const CollisionVolume::Type type_1 = pCollidable_1->getCollisionVolume().getType();
+	const CollisionVolume::Type type_2 = pCollidable_2->getCollisionVolume().getType();
+
+	// Kernels only exist with the lower type first
+	const bool isSwapped = type_2 < type_1;
+	const int bucketIndex = isSwapped ? GetBucketIndex(type_2, type_1) : GetBucketIndex(type_1, type_2);
+
+	_buckets[bucketIndex].push_back({ pCollidable_1, pCollidable_2, pCollisionDispatch, pStats, isSwapped });
+}
+
+int NarrowPhase::GetBucketIndex(CollisionVolume::Type type_1, CollisionVolume::Type type_2)
+{
+	return static_cast<int>(type_1) * NUMBER_OF_TYPES + static_cast<int>(type_2);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Process
+//-----------------------------------------------------------------------------------------------------------------------------
+template <typename CollisionVolume_1, typename CollisionVolume_2>
+void NarrowPhase::processBucket(const PairCollection& pairs)
+{
+	for (const CandidatePair& pair : pairs)
+	{
+		const CollisionVolume& collisionVolume_1 = pair.pCollidable_1->getCollisionVolume();
+		const CollisionVolume& collisionVolume_2 = pair.pCollidable_2->getCollisionVolume();
+
+		const CollisionVolume_1& kernelVolume_1 = static_cast<const CollisionVolume_1&>(pair.isSwapped ? collisionVolume_2 : collisionVolume_1);
+		const CollisionVolume_2& kernelVolume_2 = static_cast<const CollisionVolume_2&>(pair.isSwapped ? collisionVolume_1 : collisionVolume_2);
+
+		if (_isCounting)
+		{
+			CollisionCounters::SetActive(pair.pStats);
+		}
+
+		// If collidables's collision volume 1 collides with collidables's collision volume 2 then..
+		const bool isHit = MathTools::Intersect(kernelVolume_1, kernelVolume_2);
+
+		if (_isCounting)
+		{
+			countTest(pair, kernelVolume_1.getType(), kernelVolume_2.getType(), isHit);
+		}
+
+		if (isHit)
+		{
+			reportCollision(pair);
+		}
+		else
+		{
+#if NarrowPhase_DEBUG
+			Visualizer::ShowCollisionVolume(collisionVolume_1, Colors::Green);
+			Visualizer::ShowCollisionVolume(collisionVolume_2, Colors::Green);
+#endif // NarrowPhase_DEBUG
+		}
+	}
+}
+
+void NarrowPhase::process()
+{
+	typedef CollisionVolume::Type Type;
+
+	_testCount = 0;
+	_collisionCount = 0;
+	_isCounting = CollisionCounters::IsEnabled();
+	for (const PairCollection& pairs : _buckets)
+	{
+		_testCount += static_cast<unsigned int>(pairs.size());
+	}
+
+	processBSpheres(_buckets[GetBucketIndex(Type::BSPHERE, Type::BSPHERE)]);
+	processBucket<CollisionVolumeBSphere, CollisionVolumeAABB>(_buckets[GetBucketIndex(Type::BSPHERE, Type::AABB)]);
+	processBucket<CollisionVolumeBSphere, CollisionVolumeOBB>(_buckets[GetBucketIndex(Type::BSPHERE, Type::OBB)]);
+	processBucket<CollisionVolumeBSphere, CollisionVolumeOctree>(_buckets[GetBucketIndex(Type::BSPHERE, Type::OCTREE)]);
+
+	processBucket<CollisionVolumeAABB, CollisionVolumeAABB>(_buckets[GetBucketIndex(Type::AABB, Type::AABB)]);
+	processBucket<CollisionVolumeAABB, CollisionVolumeOBB>(_buckets[GetBucketIndex(Type::AABB, Type::OBB)]);
+	processBucket<CollisionVolumeAABB, CollisionVolumeOctree>(_buckets[GetBucketIndex(Type::AABB, Type::OCTREE)]);
+
+	processBucket<CollisionVolumeOBB, CollisionVolumeOBB>(_buckets[GetBucketIndex(Type::OBB, Type::OBB)]);
+	processBucket<CollisionVolumeOBB, CollisionVolumeOctree>(_buckets[GetBucketIndex(Type::OBB, Type::OCTREE)]);
+
+	processBucket<CollisionVolumeOctree, CollisionVolumeOctree>(_buckets[GetBucketIndex(Type::OCTREE, Type::OCTREE)]);
+
+	for (PairCollection& pairs : _buckets)
+	{
+		pairs.clear();
+	}
+
+	if (_isCounting)
+	{
+		CollisionCounters::SetActive(nullptr);
+	}
+}
+
+void NarrowPhase::processBSpheres(const PairCollection& pairs)
+{
+	if (pairs.empty()) return;
+
+	// Gather both sides into structure-of-arrays then...
+	_BSpheres_1.clear();
+	_BSpheres_2.clear();
+	_BSpheres_1.reserve(pairs.size());
+	_BSpheres_2.reserve(pairs.size());
+
+	for (const CandidatePair& pair : pairs)
+	{
+		_BSpheres_1.add(static_cast<const CollisionVolumeBSphere&>(pair.pCollidable_1->getCollisionVolume()), pair.pCollidable_1);
+		_BSpheres_2.add(static_cast<const CollisionVolumeBSphere&>(pair.pCollidable_2->getCollisionVolume()), pair.pCollidable_2);
+	}
+
+	// test every pair at once
+	_hits.clear();
+	BatchTools::IntersectBSpherePairs(_BSpheres_1, _BSpheres_2, _hits);
+
+	if (_isCounting)
+	{
+		for (const CandidatePair& pair : pairs)
+		{
+			countTest(pair, CollisionVolume::Type::BSPHERE, CollisionVolume::Type::BSPHERE, false);
+		}
+		const int typeIndex = static_cast<int>(CollisionVolume::Type::BSPHERE);
+		for (int index : _hits)
+		{
+			pairs[index].pStats->narrowPhaseHits[typeIndex][typeIndex]++;
+		}
+	}
+
+	for (int index : _hits)
+	{
+		reportCollision(pairs[index]);
+	}
+}
+
+void NarrowPhase::countTest(const CandidatePair& pair, CollisionVolume::Type type_1, CollisionVolume::Type type_2, bool isHit) const
+{
+	const int typeIndex_1 = static_cast<int>(type_1);
+	const int typeIndex_2 = static_cast<int>(type_2);
+
+	pair.pStats->narrowPhaseTests[typeIndex_1][typeIndex_2]++;
+	if (isHit)
+	{
+		pair.pStats->narrowPhaseHits[typeIndex_1][typeIndex_2]++;
+	}
+}
+
+unsigned int NarrowPhase::getLastTestCount() const
+{
+	return _testCount;
+}
+
+unsigned int NarrowPhase::getLastCollisionCount() const
+{
+	return _collisionCount;
+}
+
+void NarrowPhase::setRecorder(CollisionRecorder* pRecorder)
+{
+	_pRecorder = pRecorder;
+}
+
+void NarrowPhase::reportCollision(const CandidatePair& pair)
+{
+	_collisionCount++;
+
+	if (_pRecorder != nullptr)
+	{
+		_pRecorder->recordCollision(*pair.pCollidable_1, *pair.pCollidable_2);
+	}
+
+#if NarrowPhase_DEBUG
+	Visualizer::ShowCollisionVolume(pair.pCollidable_1->getCollisionVolume(), Colors::Red);
+	Visualizer::ShowCollisionVolume(pair.pCollidable_2->getCollisionVolume(), Colors::Red);
+#endif // NarrowPhase_DEBUG
+
+	// Touching wakes collidables that are asleep
+	pair.pCollidable_1->wake();
+	pair.pCollidable_2->wake();
+
+	if (_isCounting)
+	{
+		pair.pStats->callbacks += 2;
+	}
+
+	pair.pCollisionDispatch->processCallBacks(pair.pCollidable_1, pair.pCollidable_2);
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#ifndef _NarrowPhase
+#define _NarrowPhase
+
+#include <vector>
+#include "CollisionVolume.h"
+#include "BSphereCollection.h"
+#include "BatchTools.h"
+
+class Collidable;
+class CollisionDispatchBase;
+class CollisionRecorder;
+struct CollisionCommandStats;
+
+/**********************************************************************************************//**
+ * <summary> Collects the candidate pairs of a frame and tests their collision volumes.</summary>
+ *
+ * <remarks> Owned by the CollisionManager. The test commands only add the pairs whose BSpheres
+ *			 collide. Pairs are bucketed by their pair of volume types, then each bucket runs
+ *			 through a single kernel (batched SIMD for BSphere/BSphere) in process(). </remarks>
+ **************************************************************************************************/
+class NarrowPhase
+{
+private:
+	struct CandidatePair
+	{
+		Collidable* pCollidable_1;
+		Collidable* pCollidable_2;
+		CollisionDispatchBase* pCollisionDispatch;
+
+		// Stats of the command that added the pair
+		CollisionCommandStats* pStats;
+
+		// Set when the volume types were swapped to match the bucket's kernel order
+		bool isSwapped;
+	};
+
+	typedef std::vector<CandidatePair> PairCollection;
+
+	static const int NUMBER_OF_TYPES = static_cast<int>(CollisionVolume::Type::COUNT);
+	static const int NUMBER_OF_BUCKETS = NUMBER_OF_TYPES * NUMBER_OF_TYPES;
+
+public:
+	NarrowPhase();
+	NarrowPhase(const NarrowPhase&) = delete;
+	NarrowPhase& operator=(const NarrowPhase&) = delete;
+	NarrowPhase(NarrowPhase&&) = delete;
+	NarrowPhase& operator=(NarrowPhase&&) = delete;
+	~NarrowPhase() = default;
+
+	/**********************************************************************************************//**
+	 * <summary> Adds a pair of collidables whose collision volumes must be tested.</summary>
+	 *
+	 * <remarks> Callbacks are called with the collidables in the same order. </remarks>
+	 *
+	 * <param name="pCollidable_1"> The first collidable.</param>
+	 * <param name="pCollidable_2"> The second collidable.</param>
+	 * <param name="pCollisionDispatch"> The dispatch to call when they collide.</param>
+	 * <param name="pStats"> The stats of the command adding the pair (detailed counters).</param>
+	 **************************************************************************************************/
+	void addPair(Collidable* pCollidable_1, Collidable* pCollidable_2, CollisionDispatchBase* pCollisionDispatch, CollisionCommandStats* pStats);
+
+	/**********************************************************************************************//**
+	 * <summary> Tests every pair added since the last call, bucket by bucket.</summary>
+	 *
+	 * <remarks> Called only by CollisionManager::processCollisions(), after every command executed.
+	 *			 Collidables that collide are woken and their callbacks are called. While
+	 *			 CollisionCounters is enabled, each pair is counted in its command's stats. </remarks>
+	 **************************************************************************************************/
+	void process();
+
+	// Pairs tested and pairs that collided in the last process()
+	unsigned int getLastTestCount() const;
+	unsigned int getLastCollisionCount() const;
+
+	// Collisions are also reported to the recorder (nullptr when not recording)
+	void setRecorder(CollisionRecorder* pRecorder);
+
+private:
+	// Process helpers
+	void processBSpheres(const PairCollection& pairs);
+
+	template <typename CollisionVolume_1, typename CollisionVolume_2>
+	void processBucket(const PairCollection& pairs);
+
+	void reportCollision(const CandidatePair& pair);
+	void countTest(const CandidatePair& pair, CollisionVolume::Type type_1, CollisionVolume::Type type_2, bool isHit) const;
+
+	static int GetBucketIndex(CollisionVolume::Type type_1, CollisionVolume::Type type_2);
+
+private:
+	PairCollection _buckets[NUMBER_OF_BUCKETS];
+
+	// BSphere/BSphere batch scratch data (kept to reuse their storage)
+	BSphereCollection _BSpheres_1;
+	BSphereCollection _BSpheres_2;
+	BatchTools::IndexCollection _hits;
+
+	unsigned int _testCount;
+	unsigned int _collisionCount;
+	bool _isCounting;
+
+	CollisionRecorder* _pRecorder;
+};
+#endif // !_NarrowPhase
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// NarrowPhase Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
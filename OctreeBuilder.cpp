@@ -1,5 +1,6 @@
 #include "OctreeBuilder.h"
 #include "OctreeNode.h"
+#include "OctreeNodeArena.h"
 
 #include "Matrix.h"
 #include "Vect.h"
@@ -8,30 +9,510 @@
 #include "GpuVertTypes.h"
 
 #include "MathTools.h"
+#include "BatchTools.h"
+#include "TriangleBatch.h"
 
-#include "CollisionVolumeAABB.h"
-#include "CollisionVolumeBSphere.h"
+#include "CollisionVolumeOBB.h"
+#include "CollisionTimeline.h"
 
 #include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <thread>
+#include <algorithm>
 
-OctreeNode* OctreeBuilder::buildOctree(Model* pModel, int depth)
+const int OctreeBuilder::MIN_TRIANGLES_PER_FILTER_THREAD;
+
+OctreeBuilder::OctreeBuilder()
+	: _frameMode(OctreeTools::FrameMode::MODEL), _leafGridResolution(0), _pOctreeNodeArena(nullptr)
+{}
+
+namespace
+{
+	float GetBoxVolume(const CollisionVolumeOBB& obb)
+	{
+		const Vect size = obb.getMaxLocalVertex() - obb.getMinLocalVertex();
+		return size[x] * size[y] * size[z];
+	}
+
+	// Leaf cells of one axis covering [minOffset, maxOffset] (offsets from the grid's origin)
+	void GetCellRange(float minOffset, float maxOffset, float cellsPerUnit, int lastCell, int& minCell, int& maxCell)
+	{
+		// A flat axis has a single row of (flat) cells: every cell covers it
+		if (cellsPerUnit <= 0.0f)
+		{
+			minCell = 0;
+			maxCell = lastCell;
+			return;
+		}
+
+		// Widened a little, so a triangle touching a cell's face still gets tested against it
+		const float cellMargin = 1.0f / 1024.0f;
+		minCell = std::max(0, std::min(lastCell, static_cast<int>(floorf(minOffset * cellsPerUnit - cellMargin))));
+		maxCell = std::max(0, std::min(lastCell, static_cast<int>(floorf(maxOffset * cellsPerUnit + cellMargin))));
+	}
+
+	// Largest fraction of the model's AABB volume the box of a fitted frame may take to be kept
+	const float FITTED_VOLUME_RATIO = 0.95f;
+
+	// Eigenvectors (columns) of a symmetric 3x3 matrix, by cyclic Jacobi rotations, sorted by
+	// decreasing eigenvalue
+	void GetEigenvectors(double matrix[3][3], double eigenvectors[3][3])
+	{
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				eigenvectors[row][column] = (row == column) ? 1.0 : 0.0;
+			}
+		}
+
+		const int MAX_SWEEPS = 32;
+		for (int sweep = 0; sweep < MAX_SWEEPS; sweep++)
+		{
+			const double offDiagonal = fabs(matrix[0][1]) + fabs(matrix[0][2]) + fabs(matrix[1][2]);
+			const double diagonal = fabs(matrix[0][0]) + fabs(matrix[1][1]) + fabs(matrix[2][2]);
+			if (offDiagonal <= DBL_EPSILON * diagonal) break;
+
+			for (int p = 0; p < 2; p++)
+			{
+				for (int q = p + 1; q < 3; q++)
+				{
+					if (matrix[p][q] == 0.0) continue;
+
+					// Rotation zeroing matrix[p][q]
+					const double theta = (matrix[q][q] - matrix[p][p]) / (2.0 * matrix[p][q]);
+					const double t = ((theta >= 0.0) ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+					const double c = 1.0 / sqrt(t * t + 1.0);
+					const double s = t * c;
+
+					for (int k = 0; k < 3; k++)
+					{
+						const double kp = matrix[k][p];
+						const double kq = matrix[k][q];
+						matrix[k][p] = c * kp - s * kq;
+						matrix[k][q] = s * kp + c * kq;
+					}
+					for (int k = 0; k < 3; k++)
+					{
+						const double pk = matrix[p][k];
+						const double qk = matrix[q][k];
+						matrix[p][k] = c * pk - s * qk;
+						matrix[q][k] = s * pk + c * qk;
+					}
+					for (int k = 0; k < 3; k++)
+					{
+						const double kp = eigenvectors[k][p];
+						const double kq = eigenvectors[k][q];
+						eigenvectors[k][p] = c * kp - s * kq;
+						eigenvectors[k][q] = s * kp + c * kq;
+					}
+				}
+			}
+		}
+
+		// Selection sort of the columns by eigenvalue
+		for (int i = 0; i < 2; i++)
+		{
+			int largest = i;
+			for (int j = i + 1; j < 3; j++)
+			{
+				if (matrix[j][j] > matrix[largest][largest])
+				{
+					largest = j;
+				}
+			}
+			if (largest == i) continue;
+
+			std::swap(matrix[i][i], matrix[largest][largest]);
+			for (int k = 0; k < 3; k++)
+			{
+				std::swap(eigenvectors[k][i], eigenvectors[k][largest]);
+			}
+		}
+	}
+
+	// Unit axis from an eigenvector, pointing along its largest component
+	Vect GetFrameAxis(double eigenvectors[3][3], int column)
+	{
+		Vect axis(static_cast<float>(eigenvectors[0][column]), static_cast<float>(eigenvectors[1][column]),
+			static_cast<float>(eigenvectors[2][column]), 0.0f);
+		axis = axis.getNorm();
+
+		const float largest = (fabsf(axis[x]) >= fabsf(axis[y]) && fabsf(axis[x]) >= fabsf(axis[z])) ? axis[x]
+			: (fabsf(axis[y]) >= fabsf(axis[z])) ? axis[y] : axis[z];
+		axis = (largest < 0.0f) ? -axis : axis;
+		axis[w] = 0.0f;
+		return axis;
+	}
+
+	// Candidate angles of the smallest rectangle search, per pass over the vertices: the first pass
+	// spans a quarter turn (a rectangle repeats every quarter turn), each next one two steps of
+	// the previous around its best angle
+	const int FIT_ANGLE_COUNT = 32;
+	const int FIT_PASS_COUNT = 3;
+	const double QUARTER_TURN = 1.57079632679490;
+
+	// Angle, among FIT_ANGLE_COUNT ones from firstAngle, of the smallest rectangle around the
+	// vertices seen along the thinnest axis (one pass over the vertices, nothing kept per vertex)
+	double GetMinAreaRectangleAngle(const Vect* pVects, int vertexCount, const double mean[3], double eigenvectors[3][3], double firstAngle, double angleStep)
+	{
+		double cosines[FIT_ANGLE_COUNT];
+		double sines[FIT_ANGLE_COUNT];
+		double minAlong[FIT_ANGLE_COUNT];
+		double maxAlong[FIT_ANGLE_COUNT];
+		double minAcross[FIT_ANGLE_COUNT];
+		double maxAcross[FIT_ANGLE_COUNT];
+		for (int i = 0; i < FIT_ANGLE_COUNT; i++)
+		{
+			cosines[i] = cos(firstAngle + i * angleStep);
+			sines[i] = sin(firstAngle + i * angleStep);
+			minAlong[i] = DBL_MAX;
+			maxAlong[i] = -DBL_MAX;
+			minAcross[i] = DBL_MAX;
+			maxAcross[i] = -DBL_MAX;
+		}
+
+		for (int vertex = 0; vertex < vertexCount; vertex++)
+		{
+			const double offset[3] = { pVects[vertex][x] - mean[0], pVects[vertex][y] - mean[1], pVects[vertex][z] - mean[2] };
+			const double u = offset[0] * eigenvectors[0][0] + offset[1] * eigenvectors[1][0] + offset[2] * eigenvectors[2][0];
+			const double v = offset[0] * eigenvectors[0][1] + offset[1] * eigenvectors[1][1] + offset[2] * eigenvectors[2][1];
+			for (int i = 0; i < FIT_ANGLE_COUNT; i++)
+			{
+				const double along = u * cosines[i] + v * sines[i];
+				const double across = v * cosines[i] - u * sines[i];
+				minAlong[i] = std::min(minAlong[i], along);
+				maxAlong[i] = std::max(maxAlong[i], along);
+				minAcross[i] = std::min(minAcross[i], across);
+				maxAcross[i] = std::max(maxAcross[i], across);
+			}
+		}
+
+		int minAreaIndex = 0;
+		double minArea = DBL_MAX;
+		for (int i = 0; i < FIT_ANGLE_COUNT; i++)
+		{
+			const double area = (maxAlong[i] - minAlong[i]) * (maxAcross[i] - minAcross[i]);
+			if (area < minArea)
+			{
+				minArea = area;
+				minAreaIndex = i;
+			}
+		}
+		return firstAngle + minAreaIndex * angleStep;
+	}
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Frame
+//-----------------------------------------------------------------------------------------------------------------------------
+void OctreeBuilder::setFrameMode(OctreeTools::FrameMode frameMode)
 {
+	_frameMode = frameMode;
+}
+
+OctreeTools::FrameMode OctreeBuilder::getFrameMode() const
+{
+	return _frameMode;
+}
+
+Matrix OctreeBuilder::fitFrame(Model* pModel, Vect& minVertex, Vect& maxVertex) const
+{
+	minVertex = pModel->getMinAABB();
+	maxVertex = pModel->getMaxAABB();
+
+	const int vertexCount = pModel->getVectNum();
+	const Vect modelSize = maxVertex - minVertex;
+	const float modelVolume = modelSize[x] * modelSize[y] * modelSize[z];
+	if (_frameMode == OctreeTools::FrameMode::MODEL || vertexCount < 3 || modelVolume <= 0.0f) return Matrix(IDENTITY);
+
+	// Covariance of the vertices about their mean (in double: large meshes sum millions of terms)
+	const Vect* pVects = pModel->getVectList();
+	double mean[3] = { 0.0, 0.0, 0.0 };
+	for (int i = 0; i < vertexCount; i++)
+	{
+		mean[0] += pVects[i][x];
+		mean[1] += pVects[i][y];
+		mean[2] += pVects[i][z];
+	}
+	for (double& component : mean)
+	{
+		component /= vertexCount;
+	}
+
+	double covariance[3][3] = {};
+	for (int i = 0; i < vertexCount; i++)
+	{
+		const double offset[3] = { pVects[i][x] - mean[0], pVects[i][y] - mean[1], pVects[i][z] - mean[2] };
+		for (int row = 0; row < 3; row++)
+		{
+			for (int column = row; column < 3; column++)
+			{
+				covariance[row][column] += offset[row] * offset[column];
+			}
+		}
+	}
+	covariance[1][0] = covariance[0][1];
+	covariance[2][0] = covariance[0][2];
+	covariance[2][1] = covariance[1][2];
+
+	double eigenvectors[3][3];
+	GetEigenvectors(covariance, eigenvectors);
+
+	// The principal axes of a nearly square spread are arbitrary: keep the thinnest one and turn
+	// the other two to the smallest rectangle around the vertices, seen along it
+	double angleStep = QUARTER_TURN / FIT_ANGLE_COUNT;
+	double angle = GetMinAreaRectangleAngle(pVects, vertexCount, mean, eigenvectors, 0.0, angleStep);
+	for (int pass = 1; pass < FIT_PASS_COUNT; pass++)
+	{
+		const double firstAngle = angle - angleStep;
+		angleStep *= 2.0 / FIT_ANGLE_COUNT;
+		angle = GetMinAreaRectangleAngle(pVects, vertexCount, mean, eigenvectors, firstAngle, angleStep);
+	}
+
+	const double cosine = cos(angle);
+	const double sine = sin(angle);
+	for (int row = 0; row < 3; row++)
+	{
+		const double axis0 = eigenvectors[row][0];
+		const double axis1 = eigenvectors[row][1];
+		eigenvectors[row][0] = cosine * axis0 + sine * axis1;
+		eigenvectors[row][1] = cosine * axis1 - sine * axis0;
+	}
+
+	// Right handed frame
+	const Vect axis0 = GetFrameAxis(eigenvectors, 0);
+	const Vect axis1 = GetFrameAxis(eigenvectors, 1);
+	Vect axis2 = axis0.cross(axis1).getNorm();
+	axis2[w] = 0.0f;
+
+	// Frame to model space, centered on the mean so the frame's coordinates stay small
+	const Vect origin(static_cast<float>(mean[0]), static_cast<float>(mean[1]), static_cast<float>(mean[2]));
+	const Matrix frame(axis0, axis1, axis2, origin);
+	const Matrix modelToFrame = frame.getInv();
+
+	// Bounds in the frame, the vertices themselves are moved into it triangle by triangle by the build
+	Vect minFrameVertex = pVects[0] * modelToFrame;
+	Vect maxFrameVertex = minFrameVertex;
+	for (int i = 1; i < vertexCount; i++)
+	{
+		const Vect frameVertex = pVects[i] * modelToFrame;
+		minFrameVertex = MathTools::Min(minFrameVertex, frameVertex);
+		maxFrameVertex = MathTools::Max(maxFrameVertex, frameVertex);
+	}
+
+	// Only worth it when the box shrinks noticeably (e.g. not for a model already axis aligned)
+	const Vect frameSize = maxFrameVertex - minFrameVertex;
+	const float frameVolume = frameSize[x] * frameSize[y] * frameSize[z];
+	if (frameVolume > FITTED_VOLUME_RATIO * modelVolume) return Matrix(IDENTITY);
+
+	Trace::out("\tFitted frame: %.1f%% of the model's AABB volume\n", 100.0f * frameVolume / modelVolume);
+	minVertex = minFrameVertex;
+	maxVertex = maxFrameVertex;
+	return frame;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Build
+//-----------------------------------------------------------------------------------------------------------------------------
+
+OctreeNodeArena* OctreeBuilder::buildOctree(Model* pModel, int depth)
+{
+	assert(pModel != nullptr);
+
+	Vect minVertex;
+	Vect maxVertex;
+	const Matrix frame = fitFrame(pModel, minVertex, maxVertex);
+	return buildOctreeInFrame(pModel->getVectList(), pModel->getTriangleList(), pModel->getTriNum(), frame, minVertex, maxVertex, depth);
+}
+
+OctreeNodeArena* OctreeBuilder::buildOctree(const Vect* pVects, const TriangleIndex* pTriangleIndices, int triangleCount, const Vect& minVertex, const Vect& maxVertex, int depth)
+{
+	return buildOctreeInFrame(pVects, pTriangleIndices, triangleCount, Matrix(IDENTITY), minVertex, maxVertex, depth);
+}
+
+OctreeNodeArena* OctreeBuilder::buildOctreeInFrame(const Vect* pVects, const TriangleIndex* pTriangleIndices, int triangleCount, const Matrix& frame, const Vect& minVertex, const Vect& maxVertex, int depth)
+{
+	depth = OctreeTools::ClampDepth(depth);
+	CollisionTimelineScope buildScope("OctreeBuilder::buildOctree", "depth", depth);
 	Trace::out("\nOctreeBuilder (buildOctree)\n");
 	Trace::out("\tOctree depth: %d\n", depth);
-	assert(pModel != nullptr && depth >= 1);
+	assert(pVects != nullptr && pTriangleIndices != nullptr && triangleCount >= 0 && depth >= 1);
 	Trace::out("\tStart Octree Build\n");
-	_leafNodeHolder.clear();
-	_leafNodeHolder.reserve(maxNumberOfLeafNodes(depth));
+	_pOctreeNodeArena = new OctreeNodeArena(maxNumberOfNodes(depth));
 
 	OctreeNode* pRootNode = nullptr;
-	buildNode(pRootNode, pModel->getMinAABB(), pModel->getMaxAABB(), depth);
-	assert(pRootNode != nullptr);
+	buildNode(pRootNode, minVertex, maxVertex, depth);
+	assert(pRootNode != nullptr && pRootNode == _pOctreeNodeArena->getRoot());
 
-	filterNodes(pModel);
+	// Vertices are moved into a fitted frame as their triangle is filtered
+	const Matrix modelToFrame = frame.getInv();
+	const bool isFitted = !frame.isEqual(Matrix(IDENTITY));
+	filterNodes(pVects, pTriangleIndices, triangleCount, isFitted ? &modelToFrame : nullptr, minVertex, maxVertex, depth);
 	pRootNode->recalculateSize();
+	_pOctreeNodeArena->setFrame(frame);
+
+	OctreeNodeArena* pOctreeNodeArena = _pOctreeNodeArena;
+	_pOctreeNodeArena = nullptr;
 
 	Trace::out("\tFinished Octree Build\n");
-	return pRootNode;
+	return pOctreeNodeArena;
+}
+
+OctreeNodeArena* OctreeBuilder::buildOctreeAdaptive(Model* pModel, int maxDepth, const OctreeAdaptiveCriteria& criteria)
+{
+	maxDepth = OctreeTools::ClampDepth(maxDepth);
+	CollisionTimelineScope buildScope("OctreeBuilder::buildOctreeAdaptive", "depth", maxDepth);
+	Trace::out("\nOctreeBuilder (buildOctreeAdaptive)\n");
+	Trace::out("\tOctree max depth: %d\n", maxDepth);
+	assert(pModel != nullptr && maxDepth >= 1);
+	assert(criteria.maxTrianglesPerLeaf >= 1 && criteria.planarTolerance >= 0.0f);
+	_adaptiveCriteria = criteria;
+
+	Vect minVertex;
+	Vect maxVertex;
+	const Matrix frame = fitFrame(pModel, minVertex, maxVertex);
+	const Matrix modelToFrame = frame.getInv();
+	const bool isFitted = !frame.isEqual(Matrix(IDENTITY));
+
+	// Step 1: subdivide the octants that need it (on a copy of the triangles, in the frame)
+	const TriangleCollection triangles = getModelTriangles(pModel->getVectList(), pModel->getTriangleList(), pModel->getTriNum(), isFitted ? &modelToFrame : nullptr);
+	TriangleIndexCollection triangleIndices(triangles.size());
+	for (size_t i = 0; i < triangles.size(); i++)
+	{
+		triangleIndices[i] = static_cast<int>(i);
+	}
+
+	_adaptiveNodes.clear();
+	buildAdaptiveNode(triangles, triangleIndices, minVertex, maxVertex, maxDepth);
+
+	// Step 2: make the nodes, in one arena of the exact size
+	_pOctreeNodeArena = new OctreeNodeArena(static_cast<int>(_adaptiveNodes.size()));
+	OctreeNode* pRootNode = createAdaptiveNode(0);
+	assert(pRootNode == _pOctreeNodeArena->getRoot());
+	pRootNode->recalculateSize();
+	_adaptiveNodes.clear();
+	_pOctreeNodeArena->setFrame(frame);
+
+	OctreeNodeArena* pOctreeNodeArena = _pOctreeNodeArena;
+	_pOctreeNodeArena = nullptr;
+
+	buildScope.setValue(pOctreeNodeArena->getSize());
+	Trace::out("\tFinished Octree Build: %d nodes\n", pOctreeNodeArena->getSize());
+	return pOctreeNodeArena;
+}
+
+OctreeNodeArena* OctreeBuilder::buildOctreeAutoDepth(Model* pModel, const OctreeDepthCriteria& criteria, OctreeMeasure& chosenMeasure)
+{
+	assert(pModel != nullptr && criteria.minDepth >= 1 && criteria.minDepth <= criteria.maxDepth);
+	CollisionTimelineScope autoDepthScope("OctreeBuilder::buildOctreeAutoDepth");
+
+	const int minDepth = OctreeTools::ClampDepth(criteria.minDepth);
+	const int maxDepth = std::max(minDepth, OctreeTools::ClampDepth(criteria.maxDepth));
+
+	// The frame does not depend on the depth: fitted once for every candidate
+	Vect minVertex;
+	Vect maxVertex;
+	const Matrix frame = fitFrame(pModel, minVertex, maxVertex);
+
+	OctreeNodeArena* pChosenArena = nullptr;
+	for (int depth = minDepth; depth <= maxDepth; depth++)
+	{
+		OctreeNodeArena* pArena = buildOctreeInFrame(pModel->getVectList(), pModel->getTriangleList(), pModel->getTriNum(), frame, minVertex, maxVertex, depth);
+		const OctreeMeasure measure = measureOctree(*pArena, depth);
+		Trace::out("\tDepth %d: %d valid nodes, fit error %.3f, estimated query cost %.1f\n",
+			depth, measure.validNodeCount, measure.fitError, measure.estimatedQueryCost);
+
+		// Over the budget: keep the previous depth (the first one is kept anyway)
+		const bool isOverBudget = measure.validNodeCount > criteria.nodeBudget;
+		if (isOverBudget && pChosenArena != nullptr)
+		{
+			delete pArena;
+			break;
+		}
+
+		delete pChosenArena;
+		pChosenArena = pArena;
+		chosenMeasure = measure;
+
+		if (isOverBudget || measure.fitError <= criteria.fitTolerance) break;
+	}
+
+	autoDepthScope.setValue(chosenMeasure.depth);
+	Trace::out("\tChosen Octree depth: %d\n", chosenMeasure.depth);
+	return pChosenArena;
+}
+
+OctreeMeasure OctreeBuilder::measureOctree(const OctreeNodeArena& octreeNodeArena, int depth) const
+{
+	OctreeMeasure measure;
+	measure.depth = depth;
+	measure.nodeCount = octreeNodeArena.getSize();
+	measure.isFrameFitted = octreeNodeArena.hasFrame();
+
+	for (int i = 0; i < octreeNodeArena.getSize(); i++)
+	{
+		const OctreeNode& node = octreeNodeArena.getNodeAt(i);
+		if (!node.isLeafNode()) continue;
+
+		measure.leafNodeCount++;
+		measure.validLeafNodeCount += node.getIsValid() ? 1 : 0;
+	}
+
+	// Leaves of an adaptive build differ in size: compare volumes (counts if the model is flat)
+	// The frame is rigid: volumes are the same in model units
+	for (int i = 0; i < octreeNodeArena.getSize(); i++)
+	{
+		const OctreeNode& node = octreeNodeArena.getNodeAt(i);
+		if (node.isLeafNode() && node.getIsValid())
+		{
+			measure.validLeafVolume += GetBoxVolume(node.getOBB());
+		}
+	}
+
+	const float rootVolume = GetBoxVolume(octreeNodeArena.getRoot()->getOBB());
+	if (rootVolume > FLT_EPSILON)
+	{
+		measure.fitError = measure.validLeafVolume / rootVolume;
+	}
+	else
+	{
+		measure.fitError = (measure.leafNodeCount > 0) ? static_cast<float>(measure.validLeafNodeCount) / measure.leafNodeCount : 0.0f;
+	}
+
+	std::vector<int> validNodesPerLevel(depth, 0);
+	if (octreeNodeArena.getRoot()->getIsValid())
+	{
+		countValidNodesPerLevel(octreeNodeArena.getRoot(), 0, validNodesPerLevel);
+	}
+
+	for (int validNodes : validNodesPerLevel)
+	{
+		measure.validNodeCount += validNodes;
+	}
+
+	// The root, then the valid children of a valid node of each level
+	measure.estimatedQueryCost = (validNodesPerLevel[0] > 0) ? 1.0f : 0.0f;
+	for (int level = 1; level < depth && validNodesPerLevel[level - 1] > 0; level++)
+	{
+		measure.estimatedQueryCost += static_cast<float>(validNodesPerLevel[level]) / validNodesPerLevel[level - 1];
+	}
+
+	return measure;
+}
+
+void OctreeBuilder::countValidNodesPerLevel(const OctreeNode* pNode, int level, std::vector<int>& validNodesPerLevel) const
+{
+	validNodesPerLevel[level]++;
+	for (int i = 0; i < OctreeNode::NUMBER_OF_CHILDREN; i++)
+	{
+		const OctreeNode* pChild = pNode->getChildAt(i);
+		if (pChild != nullptr && pChild->getIsValid())
+		{
+			countValidNodesPerLevel(pChild, level + 1, validNodesPerLevel);
+		}
+	}
 }
 
 int OctreeBuilder::maxNumberOfLeafNodes(const int depth) const
@@ -42,12 +523,18 @@ int OctreeBuilder::maxNumberOfLeafNodes(const int depth) const
 	return 1 << (3 * (depth - 1));
 }
 
+int OctreeBuilder::maxNumberOfNodes(const int depth) const
+{
+	// Sum of the nodes of every level: f(depth) = (8 ^ depth - 1) / 7
+	return ((1 << (3 * depth)) - 1) / 7;
+}
+
 // Step 1: Build nodes
 void OctreeBuilder::buildNode(OctreeNode*& pNode, const Vect& minVertex, const Vect& maxVertex, int depth)
 {
 	if (depth == 0) return;
 
-	pNode = new OctreeNode();
+	pNode = _pOctreeNodeArena->createNode();
 
 	CollisionVolumeOBB& obb = pNode->getOBB();
 	obb.computeData(minVertex, maxVertex, Matrix(IDENTITY));
@@ -62,11 +549,6 @@ void OctreeBuilder::buildNode(OctreeNode*& pNode, const Vect& minVertex, const V
 			pChild->setParent(pNode);
 		}
 	}
-
-	if (pNode->isLeafNode())
-	{
-		_leafNodeHolder.push_back(pNode);
-	}
 }
 
 // -+ Build nodes helper
@@ -121,38 +603,103 @@ Vect OctreeBuilder::computeOffset(const int index) const
 }
 
 // Step 2: Filter nodes
-void OctreeBuilder::filterNodes(Model* pModel)
+void OctreeBuilder::filterNodes(const Vect* pVects, const TriangleIndex* pTriangleIndices, int triangleCount, const Matrix* pModelToFrame, const Vect& minVertex, const Vect& maxVertex, int depth)
 {
-	TriangleCollection triangles = getModelTriangles(pModel);
+	_leafGridResolution = 1 << (depth - 1);
+	_leafNodeGrid.assign(maxNumberOfLeafNodes(depth), nullptr);
+	mapLeafNodes(_pOctreeNodeArena->getRoot(), 0, 0, 0, _leafGridResolution);
 
-	// Using tier testing with BSpheres and AABB (in the order of fastest collision testing)
-	// first before finally testing triangle face with OBB collision volume (which is the slowest)
-	CollisionVolumeBSphere proxyOBB_BSphere;
-	CollisionVolumeBSphere proxyTriangle_BSphere;
+	// Leaf cells per unit on each axis (0 on a flat axis)
+	const Vect size = maxVertex - minVertex;
+	const Vect cellsPerUnit((size[x] > 0.0f) ? _leafGridResolution / size[x] : 0.0f,
+		(size[y] > 0.0f) ? _leafGridResolution / size[y] : 0.0f,
+		(size[z] > 0.0f) ? _leafGridResolution / size[z] : 0.0f);
 
-	CollisionVolumeAABB proxyOBB_AABB;
-	CollisionVolumeAABB proxyTriangle_AABB;
+	// Leaves holding a triangle, set by the filter threads
+	std::vector<std::atomic<unsigned char>> hitLeaves(_leafNodeGrid.size());
+	for (std::atomic<unsigned char>& hitLeaf : hitLeaves)
+	{
+		hitLeaf.store(0, std::memory_order_relaxed);
+	}
 
-	for (OctreeNode* pLeafNode : _leafNodeHolder)
+	// Contiguous ranges of triangles, the calling thread taking the first one
+	const size_t totalTriangles = static_cast<size_t>(triangleCount);
+	const int threadCount = getFilterThreadCount(totalTriangles);
+	const size_t trianglesPerThread = (totalTriangles + threadCount - 1) / threadCount;
+	std::vector<std::thread> threads;
+	for (int i = 1; i < threadCount; i++)
 	{
-		// Convert OBB volume into a close approximation of a BSphere and AABB volume
-		proxyOBB_BSphere.computeData(pLeafNode->getOBB());
-		proxyOBB_AABB.computeData(pLeafNode->getOBB());
-		for (const Triangle& triangle : triangles)
+		const size_t firstTriangle = std::min(totalTriangles, i * trianglesPerThread);
+		const size_t lastTriangle = std::min(totalTriangles, firstTriangle + trianglesPerThread);
+		threads.emplace_back(&OctreeBuilder::filterTriangles, this, pVects, pTriangleIndices, firstTriangle, lastTriangle,
+			pModelToFrame, std::cref(minVertex), std::cref(cellsPerUnit), hitLeaves.data());
+	}
+	filterTriangles(pVects, pTriangleIndices, 0, std::min(totalTriangles, trianglesPerThread), pModelToFrame, minVertex, cellsPerUnit, hitLeaves.data());
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	for (size_t i = 0; i < _leafNodeGrid.size(); i++)
+	{
+		if (hitLeaves[i].load(std::memory_order_relaxed) != 0)
 		{
-			// Convert Triangle volume into a close approximation of a BSphere volume
-			proxyTriangle_BSphere.computeData(triangle);
-			if (MathTools::Intersect(proxyOBB_BSphere, proxyTriangle_BSphere))
+			validateNode(_leafNodeGrid[i]);
+		}
+	}
+	_leafNodeGrid.clear();
+}
+
+void OctreeBuilder::mapLeafNodes(OctreeNode* pNode, int cellX, int cellY, int cellZ, int cellSpan)
+{
+	if (cellSpan == 1)
+	{
+		assert(pNode->isLeafNode());
+		_leafNodeGrid[cellX + _leafGridResolution * (cellY + _leafGridResolution * cellZ)] = pNode;
+		return;
+	}
+
+	// A child takes the upper half of an axis where its offset is positive
+	const int childSpan = cellSpan / 2;
+	for (int i = 0; i < OctreeNode::NUMBER_OF_CHILDREN; ++i)
+	{
+		const Vect offset = computeOffset(i);
+		mapLeafNodes(pNode->getChildAt(i), cellX + ((offset[x] > 0.0f) ? childSpan : 0), cellY + ((offset[y] > 0.0f) ? childSpan : 0),
+			cellZ + ((offset[z] > 0.0f) ? childSpan : 0), childSpan);
+	}
+}
+
+void OctreeBuilder::filterTriangles(const Vect* pVects, const TriangleIndex* pTriangleIndices, size_t firstTriangle, size_t lastTriangle, const Matrix* pModelToFrame, const Vect& minVertex, const Vect& cellsPerUnit, std::atomic<unsigned char>* pHitLeaves) const
+{
+	const int lastCell = _leafGridResolution - 1;
+
+	for (size_t triangleIndex = firstTriangle; triangleIndex < lastTriangle; triangleIndex++)
+	{
+		// Read straight from the buffers (and moved into a fitted frame): no copy of the mesh is kept
+		const Triangle triangle = createTriangle(pTriangleIndices[triangleIndex], pVects, pModelToFrame);
+		const Vect minTriangleVertex = MathTools::Min(triangle.getVertex0(), MathTools::Min(triangle.getVertex1(), triangle.getVertex2()));
+		const Vect maxTriangleVertex = MathTools::Max(triangle.getVertex0(), MathTools::Max(triangle.getVertex1(), triangle.getVertex2()));
+
+		// Range of leaf cells covered by the triangle's bounding box
+		int minCellX, maxCellX, minCellY, maxCellY, minCellZ, maxCellZ;
+		GetCellRange(minTriangleVertex[x] - minVertex[x], maxTriangleVertex[x] - minVertex[x], cellsPerUnit[x], lastCell, minCellX, maxCellX);
+		GetCellRange(minTriangleVertex[y] - minVertex[y], maxTriangleVertex[y] - minVertex[y], cellsPerUnit[y], lastCell, minCellY, maxCellY);
+		GetCellRange(minTriangleVertex[z] - minVertex[z], maxTriangleVertex[z] - minVertex[z], cellsPerUnit[z], lastCell, minCellZ, maxCellZ);
+
+		for (int cellZ = minCellZ; cellZ <= maxCellZ; cellZ++)
+		{
+			for (int cellY = minCellY; cellY <= maxCellY; cellY++)
 			{
-				// Convert Triangle volume into a close approximation of a AABB volume
-				proxyTriangle_AABB.computeData(triangle);
-				if (MathTools::Intersect(proxyOBB_AABB, proxyTriangle_AABB))
+				for (int cellX = minCellX; cellX <= maxCellX; cellX++)
 				{
-					// Testing Triangle and OBB collision
-					if (MathTools::Intersect(pLeafNode->getOBB(), triangle))
+					const int cellIndex = cellX + _leafGridResolution * (cellY + _leafGridResolution * cellZ);
+					if (pHitLeaves[cellIndex].load(std::memory_order_relaxed) != 0) continue;
+
+					// Leaves are axis aligned in the build's frame (identity world)
+					const CollisionVolumeOBB& leafOBB = _leafNodeGrid[cellIndex]->getOBB();
+					if (MathTools::IntersectBoxTriangle(leafOBB.getMinLocalVertex(), leafOBB.getMaxLocalVertex(), triangle))
 					{
-						validateNode(pLeafNode);
-						break;
+						pHitLeaves[cellIndex].store(1, std::memory_order_relaxed);
 					}
 				}
 			}
@@ -160,25 +707,35 @@ void OctreeBuilder::filterNodes(Model* pModel)
 	}
 }
 
+int OctreeBuilder::getFilterThreadCount(size_t triangleCount) const
+{
+	const int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	const int usefulThreads = std::max(1, static_cast<int>(triangleCount / MIN_TRIANGLES_PER_FILTER_THREAD));
+	return std::min(hardwareThreads, usefulThreads);
+}
+
 // Filter nodes helpers
-OctreeBuilder::TriangleCollection OctreeBuilder::getModelTriangles(Model* pModel) const
+OctreeBuilder::TriangleCollection OctreeBuilder::getModelTriangles(const Vect* pVects, const TriangleIndex* pTriangleIndices, int triangleCount, const Matrix* pModelToFrame) const
 {
-	const int numberOfTriangles = pModel->getTriNum();
-	TriangleIndex* pTriangleIndices = pModel->getTriangleList();
-	TriangleCollection triangles; triangles.reserve(numberOfTriangles);
+	TriangleCollection triangles; triangles.reserve(triangleCount);
 
-	for (int i = 0; i < numberOfTriangles; i++)
+	for (int i = 0; i < triangleCount; i++)
 	{
 		const TriangleIndex& triangleIndex = pTriangleIndices[i];
-		triangles.push_back(createTriangle(triangleIndex, pModel->getVectList()));
+		triangles.push_back(createTriangle(triangleIndex, pVects, pModelToFrame));
 	}
 
 	return triangles;
 }
 
-Triangle OctreeBuilder::createTriangle(const TriangleIndex& triangleIndex, const Vect* const vects) const
+Triangle OctreeBuilder::createTriangle(const TriangleIndex& triangleIndex, const Vect* const vects, const Matrix* pModelToFrame) const
 {
-	return Triangle(vects[triangleIndex.v0], vects[triangleIndex.v1], vects[triangleIndex.v2]);
+	if (pModelToFrame == nullptr)
+	{
+		return Triangle(vects[triangleIndex.v0], vects[triangleIndex.v1], vects[triangleIndex.v2]);
+	}
+
+	return Triangle(vects[triangleIndex.v0] * *pModelToFrame, vects[triangleIndex.v1] * *pModelToFrame, vects[triangleIndex.v2] * *pModelToFrame);
 }
 
 void OctreeBuilder::validateNode(OctreeNode* pNode)
@@ -189,4 +746,142 @@ void OctreeBuilder::validateNode(OctreeNode* pNode)
 	{
 		validateNode(pParent);
 	}
-}
\ No newline at end of file
+}
+//-----------------------------------------------------------------------------------------------------------------------------
+// Adaptive Build
+//-----------------------------------------------------------------------------------------------------------------------------
+int OctreeBuilder::buildAdaptiveNode(const TriangleCollection& triangles, const TriangleIndexCollection& triangleIndices, const Vect& minVertex, const Vect& maxVertex, int depth)
+{
+	static_assert(sizeof(AdaptiveNode::children) / sizeof(int) == OctreeNode::NUMBER_OF_CHILDREN, "One child index per octant");
+
+	// The node's box: its octant clipped to the bounds of its triangles
+	Vect minBoxVertex = maxVertex;
+	Vect maxBoxVertex = minVertex;
+	for (int triangleIndex : triangleIndices)
+	{
+		const Triangle& triangle = triangles[triangleIndex];
+		minBoxVertex = MathTools::Min(minBoxVertex, MathTools::Min(triangle.getVertex0(), MathTools::Min(triangle.getVertex1(), triangle.getVertex2())));
+		maxBoxVertex = MathTools::Max(maxBoxVertex, MathTools::Max(triangle.getVertex0(), MathTools::Max(triangle.getVertex1(), triangle.getVertex2())));
+	}
+
+	const int nodeIndex = static_cast<int>(_adaptiveNodes.size());
+	_adaptiveNodes.push_back(AdaptiveNode());
+	AdaptiveNode& adaptiveNode = _adaptiveNodes.back();
+	adaptiveNode.isValid = !triangleIndices.empty();
+	adaptiveNode.minVertex = adaptiveNode.isValid ? MathTools::Max(minBoxVertex, minVertex) : minVertex;
+	adaptiveNode.maxVertex = adaptiveNode.isValid ? MathTools::Min(maxBoxVertex, maxVertex) : maxVertex;
+	for (int& childIndex : adaptiveNode.children)
+	{
+		childIndex = -1;
+	}
+
+	// Per region termination: deep enough, few triangles, or a (nearly) flat patch
+	const float maxPlaneDistance = _adaptiveCriteria.planarTolerance * (0.5f * (maxVertex - minVertex)).mag();
+	if (depth <= 1 || static_cast<int>(triangleIndices.size()) <= _adaptiveCriteria.maxTrianglesPerLeaf
+		|| isNearlyPlanar(triangles, triangleIndices, maxPlaneDistance))
+	{
+		return nodeIndex;
+	}
+
+	// The node's triangles, laid out for the batched octant tests
+	TriangleBatch nodeTriangles;
+	nodeTriangles.reserve(triangleIndices.size());
+	for (int triangleIndex : triangleIndices)
+	{
+		nodeTriangles.add(triangles[triangleIndex]);
+	}
+
+	TriangleIndexCollection octantTriangleIndices;
+	for (int i = 0; i < OctreeNode::NUMBER_OF_CHILDREN; ++i)
+	{
+		const Matrix transform = transformOffset(minVertex, maxVertex, i);
+		const Vect minOctantVertex = minVertex * transform;
+		const Vect maxOctantVertex = maxVertex * transform;
+
+		getOctantTriangles(nodeTriangles, triangleIndices, minOctantVertex, maxOctantVertex, octantTriangleIndices);
+		if (octantTriangleIndices.empty()) continue;
+
+		// Children are pushed after the node: it is referenced by index, not by address
+		const int childIndex = buildAdaptiveNode(triangles, octantTriangleIndices, minOctantVertex, maxOctantVertex, depth - 1);
+		_adaptiveNodes[nodeIndex].children[i] = childIndex;
+	}
+
+	return nodeIndex;
+}
+
+void OctreeBuilder::getOctantTriangles(const TriangleBatch& parentTriangles, const TriangleIndexCollection& parentTriangleIndices, const Vect& minVertex, const Vect& maxVertex, TriangleIndexCollection& octantTriangleIndices) const
+{
+	octantTriangleIndices.clear();
+	BatchTools::IntersectTriangles(parentTriangles, minVertex, maxVertex, octantTriangleIndices);
+
+	// Batch indices to model triangle indices
+	for (int& triangleIndex : octantTriangleIndices)
+	{
+		triangleIndex = parentTriangleIndices[triangleIndex];
+	}
+}
+
+bool OctreeBuilder::isNearlyPlanar(const TriangleCollection& triangles, const TriangleIndexCollection& triangleIndices, float maxDistance) const
+{
+	// Facing of the average plane: the largest triangle's (both faces of a thin wall are one plane)
+	Vect referenceNormal(0.0f, 0.0f, 0.0f, 0.0f);
+	for (int triangleIndex : triangleIndices)
+	{
+		const Vect normal = triangles[triangleIndex].computeNormal();
+		if (normal.magSqr() > referenceNormal.magSqr())
+		{
+			referenceNormal = normal;
+		}
+	}
+	if (referenceNormal.magSqr() <= FLT_EPSILON * FLT_EPSILON) return false;
+
+	// Area weighted normal and centroid (a normal's length is twice its triangle's area)
+	Vect planeNormal(0.0f, 0.0f, 0.0f, 0.0f);
+	Vect planePoint(0.0f, 0.0f, 0.0f);
+	float totalWeight = 0.0f;
+	for (int triangleIndex : triangleIndices)
+	{
+		const Triangle& triangle = triangles[triangleIndex];
+		const Vect normal = triangle.computeNormal();
+		const float weight = normal.mag();
+
+		planeNormal = (normal.dot(referenceNormal) >= 0.0f) ? planeNormal + normal : planeNormal - normal;
+		planePoint = planePoint + (triangle.getVertex0() + triangle.getVertex1() + triangle.getVertex2()) * (weight / 3.0f);
+		totalWeight += weight;
+	}
+	planeNormal[w] = 0.0f;
+	planeNormal = planeNormal.getNorm();
+	planePoint = planePoint / totalWeight;
+
+	for (int triangleIndex : triangleIndices)
+	{
+		const Triangle& triangle = triangles[triangleIndex];
+		if (fabsf((triangle.getVertex0() - planePoint).dot(planeNormal)) > maxDistance
+			|| fabsf((triangle.getVertex1() - planePoint).dot(planeNormal)) > maxDistance
+			|| fabsf((triangle.getVertex2() - planePoint).dot(planeNormal)) > maxDistance)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+OctreeNode* OctreeBuilder::createAdaptiveNode(int adaptiveNodeIndex)
+{
+	const AdaptiveNode& adaptiveNode = _adaptiveNodes[adaptiveNodeIndex];
+
+	OctreeNode* pNode = _pOctreeNodeArena->createNode();
+	pNode->getOBB().computeData(adaptiveNode.minVertex, adaptiveNode.maxVertex, Matrix(IDENTITY));
+	pNode->setIsValid(adaptiveNode.isValid);
+
+	for (int i = 0; i < OctreeNode::NUMBER_OF_CHILDREN; ++i)
+	{
+		if (adaptiveNode.children[i] == -1) continue;
+
+		OctreeNode*& pChild = pNode->getChildReferenceAt(i);
+		pChild = createAdaptiveNode(adaptiveNode.children[i]);
+		pChild->setParent(pNode);
+	}
+
+	return pNode;
+}
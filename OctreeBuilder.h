@@ -3,14 +3,73 @@
 
 #include <list>
 #include <vector>
+#include <atomic>
+#include <cstddef>
+#include "Vect.h"
+#include "OctreeTools.h"
 
 class OctreeNode;
+class OctreeNodeArena;
 class Model;
 class Matrix;
-class Vect;
 class Triangle;
+class TriangleBatch;
 struct TriangleIndex;
 
+/**********************************************************************************************//**
+ * <summary> Shape and estimated cost of a built Octree Model.</summary>
+ **************************************************************************************************/
+struct OctreeMeasure
+{
+	int depth = 0;
+
+	int nodeCount = 0;
+	int validNodeCount = 0;
+	int leafNodeCount = 0;
+	int validLeafNodeCount = 0;
+
+	// Fraction of the root's box covered by valid leaves: an upper bound of the volume where a
+	// query is reported colliding without touching a triangle
+	float fitError = 0.0f;
+
+	// Volume of the valid leaves, in model units: comparable across frames, unlike the fit error
+	float validLeafVolume = 0.0f;
+
+	// True if the Octree was built in a fitted frame (see OctreeTools::FrameMode)
+	bool isFrameFitted = false;
+
+	// Nodes tested by a query descending to one leaf (the valid children of every valid node
+	// on the way, averaged per level)
+	float estimatedQueryCost = 0.0f;
+};
+
+/**********************************************************************************************//**
+ * <summary> How OctreeBuilder::buildOctreeAutoDepth() picks a depth.</summary>
+ *
+ * <remarks> The smallest depth whose fit error is within the tolerance, unless its valid nodes
+ *			 exceed the budget: then the deepest depth within the budget (or minDepth). </remarks>
+ **************************************************************************************************/
+struct OctreeDepthCriteria
+{
+	float fitTolerance = 0.5f;
+	int nodeBudget = 1024;
+	int minDepth = 2;
+	int maxDepth = 6;
+};
+
+/**********************************************************************************************//**
+ * <summary> When OctreeBuilder::buildOctreeAdaptive() stops subdividing an octant.</summary>
+ *
+ * <remarks> An octant becomes a leaf when it holds at most maxTrianglesPerLeaf triangles, or when
+ *			 its triangles are nearly planar: every vertex within planarTolerance (a fraction of
+ *			 the octant's half diagonal) of their average plane. </remarks>
+ **************************************************************************************************/
+struct OctreeAdaptiveCriteria
+{
+	int maxTrianglesPerLeaf = 4;
+	float planarTolerance = 0.05f;
+};
+
 /**********************************************************************************************//**
 * <summary> Octree builder builds Octree Model (all the octree nodes)
 *			 based on model and depth requested </summary>
@@ -23,32 +82,166 @@ class OctreeBuilder
 	typedef OctreeNodeCollection::iterator OctreeNodeIterator;
 
 	typedef std::vector<Triangle> TriangleCollection;
+	typedef std::vector<int> TriangleIndexCollection;
+
+	// Octant of an adaptive build, before its node is made (child index -1 for no child)
+	struct AdaptiveNode
+	{
+		Vect minVertex;
+		Vect maxVertex;
+		bool isValid;
+		int children[8];
+	};
+	typedef std::vector<AdaptiveNode> AdaptiveNodeCollection;
 
 public:
-	OctreeBuilder() = default;
+	OctreeBuilder();
 	OctreeBuilder(const OctreeBuilder&) = delete;
 	OctreeBuilder& operator=(const OctreeBuilder&) = delete;
 	OctreeBuilder(OctreeBuilder&&) = delete;
 	OctreeBuilder& operator=(OctreeBuilder&&) = delete;
 	~OctreeBuilder() = default;
 
-	OctreeNode* buildOctree(Model* pModel, int depth);
+	/**********************************************************************************************//**
+	 * <summary> Sets the frame the Octree Models of models are built in.</summary>
+	 *
+	 * <remarks> A FITTED build takes the principal axes of the model's vertices (their
+	 *			 covariance), turns the two widest to the smallest rectangle around the vertices
+	 *			 seen along the thinnest (searched among a fixed set of angles, streaming the
+	 *			 vertices), and keeps that frame when its box is at most 95% of the
+	 *			 model's AABB, else it builds in the model's axes. The vertices are moved into the
+	 *			 frame as their triangles are read. Meshes given by their buffers are always built
+	 *			 in their own axes. </remarks>
+	 *
+	 * <param name="frameMode"> The frame mode (MODEL by default).</param>
+	 **************************************************************************************************/
+	void setFrameMode(OctreeTools::FrameMode frameMode);
+	OctreeTools::FrameMode getFrameMode() const;
+
+	/**********************************************************************************************//**
+	 * <summary> Builds the Octree Model of a model.</summary>
+	 *
+	 * <remarks> Every node comes from a single arena sized for a full tree of that depth. The
+	 *			 leaves form a regular grid: each triangle is only tested against the leaves its
+	 *			 bounding box covers, in parallel across triangles on large models. The build cost
+	 *			 follows the surface of the model rather than leaves times triangles.
+	 *
+	 *			 Triangles are streamed from the model's index and vertex buffers as they are
+	 *			 filtered (in a fitted frame, their vertices are moved into it one triangle at a
+	 *			 time), never copied: the build's memory follows the depth, not the mesh. </remarks>
+	 *
+	 * <param name="pModel"> The model.</param>
+	 * <param name="depth"> The depth of the Octree (clamped to 1 to OctreeTools::MAX_DEPTH).</param>
+	 *
+	 * <returns> The arena holding the nodes, its first node is the root (owned by the caller).</returns>
+	 **************************************************************************************************/
+	OctreeNodeArena* buildOctree(Model* pModel, int depth);
+
+	/**********************************************************************************************//**
+	 * <summary> Builds the Octree Model of a mesh given by its index and vertex buffers.</summary>
+	 *
+	 * <remarks> Same build as buildOctree(Model*, int) in the mesh's own axes, for meshes that
+	 *			 are not loaded as a Model (e.g. buffers of a memory-mapped file). The buffers are
+	 *			 only read, each filter thread walking its own contiguous range of triangles once,
+	 *			 so the pages of a mapped file are touched sequentially and can be dropped
+	 *			 behind. </remarks>
+	 *
+	 * <param name="pVects"> The vertex buffer.</param>
+	 * <param name="pTriangleIndices"> The index buffer (three vertex indices per triangle).</param>
+	 * <param name="triangleCount"> The number of triangles of the index buffer.</param>
+	 * <param name="minVertex"> The min vertex of the mesh's bounds.</param>
+	 * <param name="maxVertex"> The max vertex of the mesh's bounds.</param>
+	 * <param name="depth"> The depth of the Octree (clamped to 1 to OctreeTools::MAX_DEPTH).</param>
+	 *
+	 * <returns> The arena holding the nodes, its first node is the root (owned by the caller).</returns>
+	 **************************************************************************************************/
+	OctreeNodeArena* buildOctree(const Vect* pVects, const TriangleIndex* pTriangleIndices, int triangleCount, const Vect& minVertex, const Vect& maxVertex, int depth);
+
+	/**********************************************************************************************//**
+	 * <summary> Builds the Octree Model of a model at a depth picked for it.</summary>
+	 *
+	 * <remarks> Builds and measures the Octree at increasing depths, from criteria.minDepth to
+	 *			 criteria.maxDepth, until one meets the criteria. Each depth costs about 8 times
+	 *			 the previous one, so the search costs a little more than the chosen build. </remarks>
+	 *
+	 * <param name="pModel"> The model.</param>
+	 * <param name="criteria"> The fit tolerance, node budget and depth range.</param>
+	 * <param name="chosenMeasure"> [out] The measure of the chosen depth.</param>
+	 *
+	 * <returns> The arena holding the nodes of the chosen depth (owned by the caller).</returns>
+	 **************************************************************************************************/
+	OctreeNodeArena* buildOctreeAutoDepth(Model* pModel, const OctreeDepthCriteria& criteria, OctreeMeasure& chosenMeasure);
+
+	/**********************************************************************************************//**
+	 * <summary> Builds an Octree Model whose leaves sit at the depth each region needs.</summary>
+	 *
+	 * <remarks> Subdivides top-down, passing each octant the triangles of its parent that it
+	 *			 intersects. Octants without triangles are not made, and an octant meeting the
+	 *			 criteria (or at maxDepth) becomes a leaf, so every node is valid. Each node's box
+	 *			 is its octant clipped to the bounds of its triangles, which makes the leaves of
+	 *			 axis aligned walls thin. The arena is sized for the nodes made. Unlike
+	 *			 buildOctree(), it keeps a copy of the model's triangles for the whole
+	 *			 build. </remarks>
+	 *
+	 * <param name="pModel"> The model.</param>
+	 * <param name="maxDepth"> The deepest a leaf can be (clamped to 1 to OctreeTools::MAX_DEPTH).</param>
+	 * <param name="criteria"> When an octant stops being subdivided.</param>
+	 *
+	 * <returns> The arena holding the nodes, its first node is the root (owned by the caller).</returns>
+	 **************************************************************************************************/
+	OctreeNodeArena* buildOctreeAdaptive(Model* pModel, int maxDepth, const OctreeAdaptiveCriteria& criteria);
+
+	/**********************************************************************************************//**
+	 * <summary> Measures a built Octree Model.</summary>
+	 *
+	 * <param name="octreeNodeArena"> The arena returned by buildOctree() or buildOctreeAdaptive().</param>
+	 * <param name="depth"> The depth it was built at (the max depth of an adaptive build).</param>
+	 *
+	 * <returns> The node counts, fit error and estimated query cost.</returns>
+	 **************************************************************************************************/
+	OctreeMeasure measureOctree(const OctreeNodeArena& octreeNodeArena, int depth) const;
 
 private:
+	Matrix fitFrame(Model* pModel, Vect& minVertex, Vect& maxVertex) const;
+	OctreeNodeArena* buildOctreeInFrame(const Vect* pVects, const TriangleIndex* pTriangleIndices, int triangleCount, const Matrix& frame, const Vect& minVertex, const Vect& maxVertex, int depth);
+
 	int maxNumberOfLeafNodes(const int depth) const;
+	int maxNumberOfNodes(const int depth) const;
 
 	void buildNode(OctreeNode*& pNode, const Vect& minVertex, const Vect& maxVertex, int depth);
 	Matrix transformOffset(const Vect& minVertex, const Vect& maxVertex, int index) const;
 	Vect computeOffset(const int index) const;
 
-	void filterNodes(Model*);
-	TriangleCollection getModelTriangles(Model*) const;
-	Triangle createTriangle(const TriangleIndex&, const Vect* const vects) const;
+	void mapLeafNodes(OctreeNode* pNode, int cellX, int cellY, int cellZ, int cellSpan);
+	void filterNodes(const Vect* pVects, const TriangleIndex* pTriangleIndices, int triangleCount, const Matrix* pModelToFrame, const Vect& minVertex, const Vect& maxVertex, int depth);
+	void filterTriangles(const Vect* pVects, const TriangleIndex* pTriangleIndices, size_t firstTriangle, size_t lastTriangle, const Matrix* pModelToFrame, const Vect& minVertex, const Vect& cellsPerUnit, std::atomic<unsigned char>* pHitLeaves) const;
+	int getFilterThreadCount(size_t triangleCount) const;
+	TriangleCollection getModelTriangles(const Vect* pVects, const TriangleIndex* pTriangleIndices, int triangleCount, const Matrix* pModelToFrame) const;
+	Triangle createTriangle(const TriangleIndex&, const Vect* const vects, const Matrix* pModelToFrame) const;
+
+	int buildAdaptiveNode(const TriangleCollection& triangles, const TriangleIndexCollection& triangleIndices, const Vect& minVertex, const Vect& maxVertex, int depth);
+	void getOctantTriangles(const TriangleBatch& parentTriangles, const TriangleIndexCollection& parentTriangleIndices, const Vect& minVertex, const Vect& maxVertex, TriangleIndexCollection& octantTriangleIndices) const;
+	bool isNearlyPlanar(const TriangleCollection& triangles, const TriangleIndexCollection& triangleIndices, float maxDistance) const;
+	OctreeNode* createAdaptiveNode(int adaptiveNodeIndex);
 
 	void validateNode(OctreeNode* pNode);
 
+	void countValidNodesPerLevel(const OctreeNode* pNode, int level, std::vector<int>& validNodesPerLevel) const;
+
 private:
-	OctreeNodeCollection _leafNodeHolder;
+	// Triangles a filter thread gets at least (smaller models are filtered on the calling thread)
+	static const int MIN_TRIANGLES_PER_FILTER_THREAD = 256;
+
+	OctreeTools::FrameMode _frameMode;
+
+	// Leaves of the build in progress, indexed by grid cell: x + resolution * (y + resolution * z)
+	OctreeNodeCollection _leafNodeGrid;
+	int _leafGridResolution;
+	OctreeNodeArena* _pOctreeNodeArena;
+
+	// State of the adaptive build in progress
+	AdaptiveNodeCollection _adaptiveNodes;
+	OctreeAdaptiveCriteria _adaptiveCriteria;
 };
 #endif // !_OctreeBuilder
 
@@ -1,12 +1,17 @@
 #include "OctreeModelManager.h"
 #include "OctreeNode.h"
+#include "OctreeNodeArena.h"
 #include "CollisionVolumeBSphere.h"
 #include "CollisionVolumeAABB.h"
 #include "Triangle.h"
 #include "GpuVertTypes.h"
 #include "MathTools.h"
 #include "OctreeBuilder.h"
+#include "OctreeTools.h"
+#include "CollisionTimeline.h"
 #include <cassert>
+#include <chrono>
+#include <algorithm>
 
 OctreeModelManager* OctreeModelManager::pInstance = nullptr;
 
@@ -21,29 +26,172 @@ OctreeModelManager& OctreeModelManager::GetInstance()
 }
 
 OctreeModelManager::OctreeModelManager()
-	: _pOctreeBuilder(new OctreeBuilder())
+	: _frameMode(OctreeTools::FrameMode::MODEL), _pOctreeBuilder(new OctreeBuilder())
 {}
 
-OctreeNode* OctreeModelManager::privGetOctreeModel(Model* pModel, int maxDepth)
+OctreeNodeArena* OctreeModelManager::privGetOctreeModel(Model* pModel, int maxDepth, OctreeTools::BuildMode buildMode, OctreeTools::FrameMode frameMode)
 {
-	OctreeNode* pRoot = tryToGetOctreeModel(pModel, maxDepth);
-	OctreeNode* pRoot_Copy = new OctreeNode(*pRoot);
-	return pRoot_Copy;
+	CollisionTimelineScope lookupScope("OctreeModelManager::GetOctreeModel", "depth", maxDepth);
+	OctreeModel& octreeModel = tryToGetOctreeModel(MapKey{ pModel, maxDepth, buildMode, frameMode });
+	octreeModel.report.instanceCount++;
+	return octreeModel.pOctreeNodeArena->copyValidNodes();
 }
 
-OctreeNode* OctreeModelManager::tryToGetOctreeModel(Model* pModel, int maxDepth)
+OctreeModelManager::OctreeModel& OctreeModelManager::tryToGetOctreeModel(const MapKey& key)
 {
-	OctreeModelIterator octreeNodeIt = _octreeModelMap.find(pModel);
+	OctreeModelIterator octreeNodeIt = _octreeModelMap.find(key);
 
 	if (octreeNodeIt == _octreeModelMap.end())
 	{
-		OctreeNode* pNode = _pOctreeBuilder->buildOctree(pModel, maxDepth);
-		octreeNodeIt = _octreeModelMap.insert(std::make_pair(pModel, pNode)).first;
+		octreeNodeIt = _octreeModelMap.insert(std::make_pair(key, buildOctreeModel(key))).first;
 	}
 
 	return octreeNodeIt->second;
 }
 
+OctreeModelManager::OctreeModel OctreeModelManager::buildOctreeModel(const MapKey& key)
+{
+	_pOctreeBuilder->setFrameMode(key.frameMode);
+	const std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+	OctreeNodeArena* pOctreeNodeArena = (key.buildMode == OctreeTools::BuildMode::ADAPTIVE)
+		? _pOctreeBuilder->buildOctreeAdaptive(key.pModel, key.maxDepth, _adaptiveCriteria)
+		: _pOctreeBuilder->buildOctree(key.pModel, key.maxDepth);
+	const double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count();
+
+	return createOctreeModel(key, pOctreeNodeArena, _pOctreeBuilder->measureOctree(*pOctreeNodeArena, key.maxDepth), buildSeconds);
+}
+
+OctreeModelManager::OctreeModel OctreeModelManager::createOctreeModel(const MapKey& key, OctreeNodeArena* pOctreeNodeArena, const OctreeMeasure& measure, double buildSeconds) const
+{
+	OctreeModel octreeModel;
+	octreeModel.pOctreeNodeArena = pOctreeNodeArena;
+
+	OctreeModelReport& report = octreeModel.report;
+	report.pModel = key.pModel;
+	report.depth = measure.depth;
+	report.buildMode = key.buildMode;
+	report.frameMode = key.frameMode;
+	report.triangleCount = key.pModel->getTriNum();
+	report.nodeCount = measure.nodeCount;
+	report.validNodeCount = measure.validNodeCount;
+	report.leafNodeCount = measure.leafNodeCount;
+	report.validLeafNodeCount = measure.validLeafNodeCount;
+	report.fitError = measure.fitError;
+	report.estimatedQueryCost = measure.estimatedQueryCost;
+	report.isFrameFitted = measure.isFrameFitted;
+	report.buildSeconds = buildSeconds;
+
+	report.sharedBytes = sizeof(OctreeNodeArena) + pOctreeNodeArena->getCapacity() * sizeof(OctreeNode);
+	report.instanceBytes = sizeof(OctreeNodeArena) + report.validNodeCount * sizeof(OctreeNode);
+	return octreeModel;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Automatic Depth
+//-----------------------------------------------------------------------------------------------------------------------------
+int OctreeModelManager::privGetAutoDepth(Model* pModel, OctreeTools::BuildMode buildMode, OctreeTools::FrameMode frameMode)
+{
+	if (buildMode == OctreeTools::BuildMode::ADAPTIVE) return _autoDepthCriteria.maxDepth;
+
+	const AutoDepthMap::key_type autoDepthKey(pModel, frameMode);
+	const AutoDepthMap::const_iterator autoDepthIt = _autoDepths.find(autoDepthKey);
+	if (autoDepthIt != _autoDepths.end()) return autoDepthIt->second;
+
+	// Every depth tried is timed, as they are all needed to pick one
+	_pOctreeBuilder->setFrameMode(frameMode);
+	const std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+	OctreeMeasure measure;
+	OctreeNodeArena* pOctreeNodeArena = _pOctreeBuilder->buildOctreeAutoDepth(pModel, _autoDepthCriteria, measure);
+	const double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - buildStart).count();
+
+	const MapKey key{ pModel, measure.depth, OctreeTools::BuildMode::UNIFORM, frameMode };
+	OctreeModelIterator octreeNodeIt = _octreeModelMap.find(key);
+	if (octreeNodeIt == _octreeModelMap.end())
+	{
+		octreeNodeIt = _octreeModelMap.insert(std::make_pair(key, createOctreeModel(key, pOctreeNodeArena, measure, buildSeconds))).first;
+	}
+	else
+	{
+		// Already built at that depth on request
+		delete pOctreeNodeArena;
+	}
+	octreeNodeIt->second.report.isAutoDepth = true;
+
+	_autoDepths.insert(std::make_pair(autoDepthKey, measure.depth));
+	return measure.depth;
+}
+
+void OctreeModelManager::SetAutoDepthCriteria(const OctreeDepthCriteria& criteria)
+{
+	assert(criteria.minDepth >= 1 && criteria.minDepth <= criteria.maxDepth && criteria.maxDepth <= OctreeTools::MAX_DEPTH);
+	OctreeDepthCriteria& autoDepthCriteria = GetInstance()._autoDepthCriteria;
+	autoDepthCriteria = criteria;
+	autoDepthCriteria.minDepth = OctreeTools::ClampDepth(criteria.minDepth);
+	autoDepthCriteria.maxDepth = std::max(autoDepthCriteria.minDepth, OctreeTools::ClampDepth(criteria.maxDepth));
+}
+
+void OctreeModelManager::SetAdaptiveCriteria(const OctreeAdaptiveCriteria& criteria)
+{
+	assert(criteria.maxTrianglesPerLeaf >= 1 && criteria.planarTolerance >= 0.0f);
+	GetInstance()._adaptiveCriteria = criteria;
+}
+
+void OctreeModelManager::SetFrameMode(OctreeTools::FrameMode frameMode)
+{
+	GetInstance()._frameMode = frameMode;
+}
+
+OctreeTools::FrameMode OctreeModelManager::GetFrameMode()
+{
+	return GetInstance()._frameMode;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Reports
+//-----------------------------------------------------------------------------------------------------------------------------
+void OctreeModelManager::ReleaseOctreeModel(Model* pModel, int maxDepth, OctreeTools::BuildMode buildMode, OctreeTools::FrameMode frameMode)
+{
+	// The manager may be deleted before the last collidables
+	if (OctreeModelManager::pInstance == nullptr) return;
+
+	OctreeModelManager::pInstance->privReleaseOctreeModel(MapKey{ pModel, maxDepth, buildMode, frameMode });
+}
+
+void OctreeModelManager::privReleaseOctreeModel(const MapKey& key)
+{
+	OctreeModelIterator octreeNodeIt = _octreeModelMap.find(key);
+	if (octreeNodeIt == _octreeModelMap.end()) return;
+
+	assert(octreeNodeIt->second.report.instanceCount > 0);
+	octreeNodeIt->second.report.instanceCount--;
+}
+
+size_t OctreeModelManager::GetReports(ReportCollection& reports)
+{
+	reports.clear();
+	if (OctreeModelManager::pInstance == nullptr) return 0;
+
+	size_t totalBytes = 0;
+	for (const OctreeModelMapValue& octreeModel : OctreeModelManager::pInstance->_octreeModelMap)
+	{
+		reports.push_back(octreeModel.second.report);
+		totalBytes += octreeModel.second.report.getTotalBytes();
+	}
+	return totalBytes;
+}
+
+size_t OctreeModelManager::GetTotalBytes()
+{
+	if (OctreeModelManager::pInstance == nullptr) return 0;
+
+	size_t totalBytes = 0;
+	for (const OctreeModelMapValue& octreeModel : OctreeModelManager::pInstance->_octreeModelMap)
+	{
+		totalBytes += octreeModel.second.report.getTotalBytes();
+	}
+	return totalBytes;
+}
+
 void OctreeModelManager::Delete()
 {
 	delete OctreeModelManager::pInstance;
@@ -54,13 +202,14 @@ OctreeModelManager::~OctreeModelManager()
 {
 	delete _pOctreeBuilder;
 	clearMap();
+	_autoDepths.clear();
 }
 
 void OctreeModelManager::clearMap()
 {
-	for (OctreeModelMapValue& pOctreeNode : _octreeModelMap)
+	for (OctreeModelMapValue& octreeModel : _octreeModelMap)
 	{
-		delete pOctreeNode.second;
+		delete octreeModel.second.pOctreeNodeArena;
 	}
 	_octreeModelMap.clear();
 }
@@ -2,11 +2,66 @@
 #define _OctreeModelManager
 
 #include <map>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include "OctreeBuilder.h"
+#include "OctreeTools.h"
 
-class OctreeNode;
-class OctreeBuilder;
+class OctreeNodeArena;
 class Model;
 
+/**********************************************************************************************//**
+ * <summary> Memory and build cost of one cached Octree Model (a model at one depth, build mode
+ *			 and frame mode).</summary>
+ *
+ * <remarks> The cached build holds the tree of its depth and is shared by every instance.
+ *			 Each CollisionVolumeOctree owns an instance: a copy of the valid nodes only.
+ *			 </remarks>
+ **************************************************************************************************/
+struct OctreeModelReport
+{
+	const Model* pModel = nullptr;
+	int depth = 0;
+	OctreeTools::BuildMode buildMode = OctreeTools::BuildMode::UNIFORM;
+	OctreeTools::FrameMode frameMode = OctreeTools::FrameMode::MODEL;
+	int triangleCount = 0;
+
+	// Nodes of the cached build, and the valid ones (holding triangles) copied by each instance
+	int nodeCount = 0;
+	int validNodeCount = 0;
+	int leafNodeCount = 0;
+	int validLeafNodeCount = 0;
+
+	// See OctreeMeasure
+	float fitError = 0.0f;
+	float estimatedQueryCost = 0.0f;
+
+	// True if the depth was picked for the model (OctreeTools::AUTO_DEPTH)
+	bool isAutoDepth = false;
+
+	// True if a FITTED build kept its fitted frame (see OctreeBuilder::setFrameMode())
+	bool isFrameFitted = false;
+
+	size_t sharedBytes = 0;
+	size_t instanceBytes = 0;
+	int instanceCount = 0;
+
+	double buildSeconds = 0.0;
+
+	// Fraction of the leaf nodes holding triangles
+	double getLeafOccupancy() const
+	{
+		return (leafNodeCount > 0) ? static_cast<double>(validLeafNodeCount) / leafNodeCount : 0.0;
+	}
+
+	// Shared build plus every live instance
+	size_t getTotalBytes() const
+	{
+		return sharedBytes + instanceBytes * instanceCount;
+	}
+};
+
 /**********************************************************************************************//**
  * <summary> Manager for Octree Models.
  * 			 For loading Octree Models and accessing them within Collidable when requesting the use
@@ -17,9 +72,35 @@ class Model;
  **************************************************************************************************/
 class OctreeModelManager
 {
+public:
+	typedef std::vector<OctreeModelReport> ReportCollection;
+
 private:
-	typedef Model* MapKey;
-	typedef std::map<MapKey, OctreeNode*> OctreeModelMap;
+	// A model is cached once per depth, build mode and frame mode
+	struct MapKey
+	{
+		Model* pModel;
+		int maxDepth;
+		OctreeTools::BuildMode buildMode;
+		OctreeTools::FrameMode frameMode;
+
+		bool operator<(const MapKey& other) const
+		{
+			if (pModel != other.pModel) return pModel < other.pModel;
+			if (maxDepth != other.maxDepth) return maxDepth < other.maxDepth;
+			if (buildMode != other.buildMode) return buildMode < other.buildMode;
+			return frameMode < other.frameMode;
+		}
+	};
+
+	struct OctreeModel
+	{
+		OctreeNodeArena* pOctreeNodeArena;
+		OctreeModelReport report;
+	};
+
+	typedef std::map<MapKey, OctreeModel> OctreeModelMap;
+	typedef std::map<std::pair<Model*, OctreeTools::FrameMode>, int> AutoDepthMap;
 	typedef OctreeModelMap::iterator OctreeModelIterator;
 	typedef OctreeModelMap::value_type OctreeModelMapValue;
 
@@ -36,22 +117,98 @@ private:
 	// Getting Model Manager
 	static OctreeModelManager& GetInstance();
 
-	OctreeNode* privGetOctreeModel(Model*, int maxDepth);
-	OctreeNode* tryToGetOctreeModel(Model*, int maxDepth);
+	OctreeNodeArena* privGetOctreeModel(Model*, int maxDepth, OctreeTools::BuildMode, OctreeTools::FrameMode);
+	OctreeModel& tryToGetOctreeModel(const MapKey&);
+	OctreeModel buildOctreeModel(const MapKey&);
+	OctreeModel createOctreeModel(const MapKey&, OctreeNodeArena*, const OctreeMeasure&, double buildSeconds) const;
+	int privGetAutoDepth(Model*, OctreeTools::BuildMode, OctreeTools::FrameMode);
+	void privReleaseOctreeModel(const MapKey&);
 
 	void clearMap();
 
 public:
-	static OctreeNode* GetOctreeModel(Model* pModel, int maxDepth)
+	/**********************************************************************************************//**
+	 * <summary> Gets a copy of the Octree Model of a model (built on first request).</summary>
+	 *
+	 * <remarks> The copy only holds the valid nodes, in one arena owned by the caller. </remarks>
+	 *
+	 * <param name="pModel"> The model.</param>
+	 * <param name="maxDepth"> The depth of the Octree (the deepest leaf of an adaptive one).</param>
+	 * <param name="buildMode"> How the Octree is subdivided.</param>
+	 * <param name="frameMode"> The frame the Octree is built in.</param>
+	 *
+	 * <returns> The arena holding the copied nodes.</returns>
+	 **************************************************************************************************/
+	static OctreeNodeArena* GetOctreeModel(Model* pModel, int maxDepth, OctreeTools::BuildMode buildMode, OctreeTools::FrameMode frameMode)
 	{
-		return GetInstance().privGetOctreeModel(pModel, maxDepth);
+		return GetInstance().privGetOctreeModel(pModel, maxDepth, buildMode, frameMode);
 	}
 
+	/**********************************************************************************************//**
+	 * <summary> Counts an instance of an Octree Model as released.</summary>
+	 *
+	 * <remarks> Called by CollisionVolumeOctree, which deletes its copy. Only updates the
+	 *			 reports, the cached build is kept until Delete(). </remarks>
+	 *
+	 * <param name="pModel"> The model.</param>
+	 * <param name="maxDepth"> The depth of the Octree.</param>
+	 * <param name="buildMode"> How the Octree is subdivided.</param>
+	 * <param name="frameMode"> The frame the Octree was built in.</param>
+	 **************************************************************************************************/
+	static void ReleaseOctreeModel(Model* pModel, int maxDepth, OctreeTools::BuildMode buildMode, OctreeTools::FrameMode frameMode);
+
+	/**********************************************************************************************//**
+	 * <summary> Gets the depth picked for a model (OctreeTools::AUTO_DEPTH).</summary>
+	 *
+	 * <remarks> On the first request, builds the model at increasing depths until one meets the
+	 *			 criteria (see OctreeBuilder::buildOctreeAutoDepth()) and caches that build. The
+	 *			 choice is kept for later requests, per frame mode. An adaptive Octree already
+	 *			 stops each region where it needs to, so it gets the deepest depth of the
+	 *			 criteria. </remarks>
+	 *
+	 * <param name="pModel"> The model.</param>
+	 * <param name="buildMode"> How the Octree is subdivided.</param>
+	 * <param name="frameMode"> The frame the Octree is built in.</param>
+	 *
+	 * <returns> The depth of the model's Octree.</returns>
+	 **************************************************************************************************/
+	static int GetAutoDepth(Model* pModel, OctreeTools::BuildMode buildMode, OctreeTools::FrameMode frameMode)
+	{
+		return GetInstance().privGetAutoDepth(pModel, buildMode, frameMode);
+	}
+
+	// Criteria of the depths picked from now on (models already picked keep their depth)
+	static void SetAutoDepthCriteria(const OctreeDepthCriteria& criteria);
+
+	// Criteria of the adaptive Octree Models built from now on (cached ones are kept)
+	static void SetAdaptiveCriteria(const OctreeAdaptiveCriteria& criteria);
+
+	// Frame of the Octree volumes created from now on (cached models of the other mode are kept)
+	static void SetFrameMode(OctreeTools::FrameMode frameMode);
+	static OctreeTools::FrameMode GetFrameMode();
+
+	/**********************************************************************************************//**
+	 * <summary> Gets the report of every cached Octree Model.</summary>
+	 *
+	 * <param name="reports"> [out] The reports, ordered by model address, depth, build mode then
+	 *						frame mode.</param>
+	 *
+	 * <returns> The bytes used by every Octree Model and instance of the process.</returns>
+	 **************************************************************************************************/
+	static size_t GetReports(ReportCollection& reports);
+
+	// Bytes used by every Octree Model and instance of the process
+	static size_t GetTotalBytes();
+
 	// Termination
 	static void Delete();
 
 private:
 	OctreeModelMap _octreeModelMap;
+	AutoDepthMap _autoDepths;
+	OctreeDepthCriteria _autoDepthCriteria;
+	OctreeAdaptiveCriteria _adaptiveCriteria;
+	OctreeTools::FrameMode _frameMode;
 	OctreeBuilder* _pOctreeBuilder;
 
 };
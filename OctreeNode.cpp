@@ -13,53 +13,11 @@ OctreeNode::OctreeNode()
 	}
 }
 
-OctreeNode::OctreeNode(const OctreeNode& octreeNode)
-	: OctreeNode()
+void OctreeNode::copyNodeData(const OctreeNode& octreeNode)
 {
-	if (&octreeNode == this) return;
-
 	copyOBBData(octreeNode);
 	_isValid = octreeNode._isValid;
 	_size = octreeNode._size;
-
-	if (octreeNode.isLeafNode()) return;
-
-	for (int i = 0; i < 8; i++)
-	{
-		OctreeNode*& pMyChild = _children[i];
-		const OctreeNode& otherChild = *octreeNode._children[i];
-
-		if (otherChild._isValid)
-		{
-			pMyChild = new OctreeNode(otherChild);
-			pMyChild->_pParent = this;
-		}
-	}
-}
-
-OctreeNode& OctreeNode::operator=(const OctreeNode& octreeNode)
-{
-	if (&octreeNode == this) return *this;
-
-	copyOBBData(octreeNode);
-	_isValid = octreeNode._isValid;
-	_size = octreeNode._size;
-
-	if (octreeNode.isLeafNode()) return *this;
-
-	for (int i = 0; i < 8; i++)
-	{
-		OctreeNode*& pMyChild = _children[i];
-		const OctreeNode& otherChild = *octreeNode._children[i];
-
-		if (otherChild._isValid)
-		{
-			pMyChild = new OctreeNode(otherChild);
-			pMyChild->_pParent = this;
-		}
-	}
-
-	return *this;
 }
 
 const OctreeNode* OctreeNode::getChildAt(int index) const
@@ -147,14 +105,6 @@ void OctreeNode::copyOBBData(const OctreeNode& octreeNode)
 	_obb.setMinMaxLocalVertex(octreeNode._obb.getMinLocalVertex(), octreeNode._obb.getMaxLocalVertex());
 }
 
-OctreeNode::~OctreeNode()
-{
-	for (auto& pChild : _children)
-	{
-		delete pChild;
-	}
-}
-
 bool OctreeNode::isLeafNode() const
 {
 	for (auto& pChild : _children)
@@ -7,7 +7,8 @@
  * <summary> Octree Node contains a Collision OBB along with 8 child Octree Nodes and a parent.
  *			 Part of the CollisionVolumeOctree which hold a pointer to a root Octree Node. </summary>
  *
- * <remarks> </remarks>
+ * <remarks> Nodes are stored in an OctreeNodeArena which owns them, so a node never deletes
+ *			 its children. </remarks>
  **************************************************************************************************/
 class OctreeNode
 {
@@ -16,11 +17,11 @@ public:
 
 public:
 	OctreeNode();
-	OctreeNode(const OctreeNode&);
-	OctreeNode& operator=(const OctreeNode&);
+	OctreeNode(const OctreeNode&) = delete;
+	OctreeNode& operator=(const OctreeNode&) = delete;
 	OctreeNode(OctreeNode&&) = delete;
 	OctreeNode& operator=(OctreeNode&&) = delete;
-	~OctreeNode();
+	~OctreeNode() = default;
 
 	bool isLeafNode() const;
 
@@ -44,6 +45,15 @@ public:
 
 	void recalculateSize();
 
+	/**********************************************************************************************//**
+	 * <summary> Copies the OBB, size and validity of another node (not its parent or children).</summary>
+	 *
+	 * <remarks> Used by OctreeNodeArena when copying a tree. </remarks>
+	 *
+	 * <param name="octreeNode"> The node to copy from.</param>
+	 **************************************************************************************************/
+	void copyNodeData(const OctreeNode& octreeNode);
+
 private:
 	OctreeNode* _pParent;
 	CollisionVolumeOBB _obb;
@@ -0,0 +1,105 @@
+#include "OctreeNodeArena.h"
+#include "OctreeNode.h"
+#include <cassert>
+
+OctreeNodeArena::OctreeNodeArena(int capacity)
+	: _pNodes(nullptr), _size(0), _capacity(capacity), _frame(IDENTITY), _hasFrame(false)
+{
+	assert(capacity >= 1);
+	_pNodes = new OctreeNode[capacity];
+}
+
+OctreeNodeArena::~OctreeNodeArena()
+{
+	delete[] _pNodes;
+}
+
+OctreeNode* OctreeNodeArena::createNode()
+{
+	assert(_size < _capacity);
+	return &_pNodes[_size++];
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Copy
+//-----------------------------------------------------------------------------------------------------------------------------
+OctreeNodeArena* OctreeNodeArena::copyValidNodes() const
+{
+	const OctreeNode* pRoot = getRoot();
+
+	// Size of a node is the number of valid nodes below it
+	OctreeNodeArena* pArena = new OctreeNodeArena(pRoot->getSize() + 1);
+	pArena->copyNode(*pRoot, nullptr);
+	pArena->_frame = _frame;
+	pArena->_hasFrame = _hasFrame;
+
+	return pArena;
+}
+
+OctreeNode* OctreeNodeArena::copyNode(const OctreeNode& node, OctreeNode* pParent)
+{
+	OctreeNode* pNode = createNode();
+	pNode->copyNodeData(node);
+	pNode->setParent(pParent);
+
+	for (int i = 0; i < OctreeNode::NUMBER_OF_CHILDREN; i++)
+	{
+		const OctreeNode* pChild = node.getChildAt(i);
+		if (pChild != nullptr && pChild->getIsValid())
+		{
+			pNode->getChildReferenceAt(i) = copyNode(*pChild, pNode);
+		}
+	}
+
+	return pNode;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Getters
+//-----------------------------------------------------------------------------------------------------------------------------
+const OctreeNode* OctreeNodeArena::getRoot() const
+{
+	assert(_size > 0);
+	return &_pNodes[0];
+}
+
+OctreeNode* OctreeNodeArena::getRoot()
+{
+	assert(_size > 0);
+	return &_pNodes[0];
+}
+
+const OctreeNode& OctreeNodeArena::getNodeAt(int index) const
+{
+	assert(index >= 0 && index < _size);
+	return _pNodes[index];
+}
+
+int OctreeNodeArena::getSize() const
+{
+	return _size;
+}
+
+int OctreeNodeArena::getCapacity() const
+{
+	return _capacity;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Frame
+//-----------------------------------------------------------------------------------------------------------------------------
+void OctreeNodeArena::setFrame(const Matrix& frame)
+{
+	_frame = frame;
+	_hasFrame = !frame.isEqual(Matrix(IDENTITY));
+}
+
+const Matrix& OctreeNodeArena::getFrame() const
+{
+	return _frame;
+}
+
+bool OctreeNodeArena::hasFrame() const
+{
+	return _hasFrame;
+}
\ No newline at end of file
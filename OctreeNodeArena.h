@@ -0,0 +1,90 @@
+#ifndef _OctreeNodeArena
+#define _OctreeNodeArena
+
+#include "Matrix.h"
+
+class OctreeNode;
+
+/**********************************************************************************************//**
+ * <summary> Owns every node of one Octree in a single contiguous allocation.</summary>
+ *
+ * <remarks> The capacity is fixed on creation. Nodes are handed out in order, the first one
+ *			 being the root. Nodes never delete their children, releasing the arena releases
+ *			 the whole tree at once. </remarks>
+ **************************************************************************************************/
+class OctreeNodeArena
+{
+public:
+	OctreeNodeArena() = delete;
+	OctreeNodeArena(const OctreeNodeArena&) = delete;
+	OctreeNodeArena& operator=(const OctreeNodeArena&) = delete;
+	OctreeNodeArena(OctreeNodeArena&&) = delete;
+	OctreeNodeArena& operator=(OctreeNodeArena&&) = delete;
+	~OctreeNodeArena();
+
+	/**********************************************************************************************//**
+	 * <summary> Creates an arena able to hold capacity nodes.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="capacity"> The maximum number of nodes.</param>
+	 **************************************************************************************************/
+	explicit OctreeNodeArena(int capacity);
+
+	/**********************************************************************************************//**
+	 * <summary> Hands out the next unused node.</summary>
+	 *
+	 * <remarks> Asserts the capacity is not exceeded. </remarks>
+	 *
+	 * <returns> The node.</returns>
+	 **************************************************************************************************/
+	OctreeNode* createNode();
+
+	/**********************************************************************************************//**
+	 * <summary> Copies the valid nodes of this tree into a new arena sized to fit them.</summary>
+	 *
+	 * <remarks> Used to give each Collidable its own copy of an Octree Model. </remarks>
+	 *
+	 * <returns> The new arena (owned by the caller).</returns>
+	 **************************************************************************************************/
+	OctreeNodeArena* copyValidNodes() const;
+
+	const OctreeNode* getRoot() const;
+	OctreeNode* getRoot();
+
+	// Nodes in the order they were handed out (index 0 is the root)
+	const OctreeNode& getNodeAt(int index) const;
+
+	int getSize() const;
+	int getCapacity() const;
+
+	/**********************************************************************************************//**
+	 * <summary> Sets the frame the nodes were built in.</summary>
+	 *
+	 * <remarks> Rigid transform from the frame to model space (identity by default). Node boxes
+	 *			 are in the frame: their world matrix is the frame times the model's. Copies keep
+	 *			 the frame. </remarks>
+	 *
+	 * <param name="frame"> The frame.</param>
+	 **************************************************************************************************/
+	void setFrame(const Matrix& frame);
+	const Matrix& getFrame() const;
+
+	// True if the nodes were built in a frame other than the model's
+	bool hasFrame() const;
+
+private:
+	OctreeNode* copyNode(const OctreeNode& node, OctreeNode* pParent);
+
+private:
+	OctreeNode* _pNodes;
+	int _size;
+	int _capacity;
+	Matrix _frame;
+	bool _hasFrame;
+};
+#endif // !_OctreeNodeArena
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// OctreeNodeArena Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
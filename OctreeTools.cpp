@@ -1,5 +1,18 @@
 #include "OctreeTools.h"
 #include "OctreeNode.h"
+#include "AzulCore.h"
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Depth
+//-----------------------------------------------------------------------------------------------------------------------------
+int OctreeTools::ClampDepth(int depth)
+{
+	if (depth >= 1 && depth <= OctreeTools::MAX_DEPTH) return depth;
+
+	const int clampedDepth = (depth < 1) ? 1 : OctreeTools::MAX_DEPTH;
+	Trace::out("OctreeTools WARNING (ClampDepth): Octree depth %d is not supported, using %d\n", depth, clampedDepth);
+	return clampedDepth;
+}
 
 //-----------------------------------------------------------------------------------------------------------------------------
 // Octree-Single Volume Intersection
@@ -16,6 +29,18 @@ void OctreeTools::AddChildNodesToTest(const OctreeNode* const* pChildren, NodeSt
 	}
 }
 
+void OctreeTools::AddChildNodesToTest(const OctreeNode* const* pChildren, FixedNodeStack& nodeStack)
+{
+	for (int i = 0; i < OctreeNode::NUMBER_OF_CHILDREN; i++)
+	{
+		const OctreeNode* pChild = pChildren[i];
+		if (pChild != nullptr)
+		{
+			nodeStack.push(pChild);
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------------------------------------------------------
 // Octree-Octree Intersections
 //-----------------------------------------------------------------------------------------------------------------------------
@@ -26,10 +51,22 @@ bool OctreeTools::AreBothLeafNodes(const OctreeNode* pNode_1, const OctreeNode*
 
 bool OctreeTools::ShouldDescendFirstNode(const OctreeNode* pNode_1, const OctreeNode* pNode_2)
 {
-	// Basically choosing the larger size when possible 
+	// Basically choosing the larger node when possible 
 	// - if second node is a leaf node we choose we return true so we traverse down the first node
-	// - if first node contains more nodes than the second than we return true so travers the first node 
-	return pNode_2->isLeafNode() || (!pNode_1->isLeafNode() && pNode_1->getSize() >= pNode_2->getSize());
+	// - if first node is a leaf node we return false so we traverse down the second node
+	// - else we traverse down the node with the larger box in world space. Leaves may sit at any
+	//   depth (adaptive Octrees) and the Octrees may be scaled differently, so neither the depth
+	//   nor the node count of a subtree tells which box is larger.
+	if (pNode_2->isLeafNode()) return true;
+	if (pNode_1->isLeafNode()) return false;
+
+	return GetWorldHalfDiagonalSquared(pNode_1) >= GetWorldHalfDiagonalSquared(pNode_2);
+}
+
+float OctreeTools::GetWorldHalfDiagonalSquared(const OctreeNode* pNode)
+{
+	const CollisionVolumeOBB& obb = pNode->getOBB();
+	return obb.getLocalHalfDiagonal().magSqr() * obb.getScalingFactorSquared();
 }
 
 void OctreeTools::AddChildNodesToTest(const OctreeNode* const* pChildren, const OctreeNode* pNode, NodePairStack& nodePairStack)
@@ -3,8 +3,8 @@
 
 #include <stack>
 #include <queue>
-
-class OctreeNode;
+#include <cassert>
+#include "OctreeNode.h"
 
 /**********************************************************************************************//**
 // namespace: OctreeTools
@@ -17,6 +17,95 @@ namespace OctreeTools
 
 	void AddChildNodesToTest(const OctreeNode* const* pChildren, NodeStack& nodeStack);
 
+	// Deepest Octree supported by the fixed traversal stack
+	const int MAX_DEPTH = 10;
+
+	// Depth asking OctreeModelManager to pick the depth of each model (see OctreeDepthCriteria)
+	const int AUTO_DEPTH = 0;
+
+	/**********************************************************************************************//**
+	 * <summary> Clamps an Octree depth to the supported range, 1 to MAX_DEPTH.</summary>
+	 *
+	 * <remarks> Checked in every build, not only by asserts: the fixed traversal stack and the
+	 *			 node counts of the builder only hold up to MAX_DEPTH. Traces the depths it
+	 *			 changes. </remarks>
+	 *
+	 * <param name="depth"> The requested depth.</param>
+	 *
+	 * <returns> The depth to build.</returns>
+	 **************************************************************************************************/
+	int ClampDepth(int depth);
+
+	/**********************************************************************************************//**
+	 * <summary> How the Octree Model of a model is subdivided.</summary>
+	 *
+	 * <remarks> UNIFORM subdivides every octant down to the depth and keeps the leaves holding
+	 *			 triangles. ADAPTIVE stops each octant as soon as it holds few triangles or nearly
+	 *			 planar ones (see OctreeAdaptiveCriteria): leaves sit at mixed depths, up to the
+	 *			 depth. </remarks>
+	 **************************************************************************************************/
+	enum class BuildMode : unsigned char
+	{
+		UNIFORM,
+		ADAPTIVE
+	};
+
+	/**********************************************************************************************//**
+	 * <summary> Frame the Octree Model of a model is built in.</summary>
+	 *
+	 * <remarks> MODEL builds in the model's axes, the root being the model's AABB. FITTED builds
+	 *			 in a frame fitted to the model's vertices, when its box is tighter than the
+	 *			 model's AABB: meshes modeled at an angle then fill their octants. The frame is
+	 *			 kept with the Octree Model and folded into the world matrix of each
+	 *			 CollisionVolumeOctree. </remarks>
+	 **************************************************************************************************/
+	enum class FrameMode : unsigned char
+	{
+		MODEL,
+		FITTED
+	};
+
+	/**********************************************************************************************//**
+	 * <summary> A node stack with a fixed capacity, for depth-first traversal of an Octree.</summary>
+	 *
+	 * <remarks> Every level below the root adds at most (NUMBER_OF_CHILDREN - 1) nodes to the stack,
+	 *			 so the capacity is enough for any Octree up to MAX_DEPTH. Lives on the call stack
+	 *			 (no allocations). </remarks>
+	 **************************************************************************************************/
+	class FixedNodeStack
+	{
+	public:
+		static const int CAPACITY = MAX_DEPTH * (OctreeNode::NUMBER_OF_CHILDREN - 1) + 1;
+
+	public:
+		FixedNodeStack()
+			: _size(0)
+		{}
+
+		void push(const OctreeNode* pNode)
+		{
+			assert(_size < CAPACITY);
+			_nodes[_size++] = pNode;
+		}
+
+		const OctreeNode* pop()
+		{
+			assert(_size > 0);
+			return _nodes[--_size];
+		}
+
+		bool empty() const
+		{
+			return _size == 0;
+		}
+
+	private:
+		const OctreeNode* _nodes[CAPACITY];
+		int _size;
+	};
+
+	void AddChildNodesToTest(const OctreeNode* const* pChildren, FixedNodeStack& nodeStack);
+
 	// Octree-Octree Intersection
 	typedef std::pair<const OctreeNode*, const OctreeNode*> NodePair;
 	typedef std::stack<NodePair> NodePairStack;
@@ -25,6 +114,9 @@ namespace OctreeTools
 	bool AreBothLeafNodes(const OctreeNode* pNode_1, const OctreeNode* pNode_2);
 	bool ShouldDescendFirstNode(const OctreeNode* pNode_1, const OctreeNode* pNode_2);
 
+	// Squared half diagonal of a node's box in world space (uniform scale)
+	float GetWorldHalfDiagonalSquared(const OctreeNode* pNode);
+
 	void AddChildNodesToTest(const OctreeNode* const* pChildren, const OctreeNode* pNode, NodePairStack& nodePairStack);
 
 };
@@ -0,0 +1,15 @@
+#ifndef _AzulCore
+#define _AzulCore
+
+// Headless stand-in for the AzulCore umbrella header
+#include "Vect.h"
+#include "Matrix.h"
+#include "Model.h"
+#include "GpuVertTypes.h"
+#include "Trace.h"
+
+#endif // !_AzulCore
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// AzulCore Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
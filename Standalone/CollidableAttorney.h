@@ -0,0 +1,26 @@
+#ifndef _CollidableAttorney
+#define _CollidableAttorney
+
+#include "Collidable.h"
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine attorney giving the registration commands access
+ *			 to Collidable.</summary>
+ **************************************************************************************************/
+class CollidableAttorney
+{
+public:
+	class Registration
+	{
+		friend class CollisionRegisterCommand;
+		friend class CollisionDeregisterCommand;
+	private:
+		static void RegisterToScene(Collidable* pCollidable) { pCollidable->registerToScene(); }
+		static void DeregisterFromScene(Collidable* pCollidable) { pCollidable->deregisterFromScene(); }
+	};
+};
+#endif // !_CollidableAttorney
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollidableAttorney Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
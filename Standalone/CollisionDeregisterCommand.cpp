@@ -0,0 +1,11 @@
+#include "CollisionDeregisterCommand.h"
+#include "CollidableAttorney.h"
+
+CollisionDeregisterCommand::CollisionDeregisterCommand(Collidable* pCollidable)
+	: _pCollidable(pCollidable)
+{}
+
+void CollisionDeregisterCommand::execute()
+{
+	CollidableAttorney::Registration::DeregisterFromScene(_pCollidable);
+}
@@ -0,0 +1,33 @@
+#ifndef _CollisionDeregisterCommand
+#define _CollisionDeregisterCommand
+
+#include "SceneRegistrationCommand.h"
+
+class Collidable;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine command that deregisters a Collidable for collisions.</summary>
+ **************************************************************************************************/
+class CollisionDeregisterCommand : public SceneRegistrationCommand
+{
+public:
+	CollisionDeregisterCommand() = delete;
+	CollisionDeregisterCommand(const CollisionDeregisterCommand&) = default;
+	CollisionDeregisterCommand& operator=(const CollisionDeregisterCommand&) = default;
+	CollisionDeregisterCommand(CollisionDeregisterCommand&&) = default;
+	CollisionDeregisterCommand& operator=(CollisionDeregisterCommand&&) = default;
+	~CollisionDeregisterCommand() = default;
+
+	explicit CollisionDeregisterCommand(Collidable* pCollidable);
+
+	// Inherited via SceneRegistrationCommand
+	virtual void execute() override;
+
+private:
+	Collidable* _pCollidable;
+};
+#endif // !_CollisionDeregisterCommand
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionDeregisterCommand Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,46 @@
+#ifndef _CollisionDispatch
+#define _CollisionDispatch
+
+class Collidable;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine collision dispatch: calls the collision callbacks
+ *			 of a colliding pair.</summary>
+ **************************************************************************************************/
+class CollisionDispatchBase
+{
+public:
+	CollisionDispatchBase() = default;
+	CollisionDispatchBase(const CollisionDispatchBase&) = default;
+	CollisionDispatchBase& operator=(const CollisionDispatchBase&) = default;
+	CollisionDispatchBase(CollisionDispatchBase&&) = default;
+	CollisionDispatchBase& operator=(CollisionDispatchBase&&) = default;
+	virtual ~CollisionDispatchBase() = default;
+
+	virtual void processCallBacks(Collidable* pCollidable_1, Collidable* pCollidable_2) = 0;
+};
+
+/**********************************************************************************************//**
+ * <summary> Calls UserClass1::collision(UserClass2*) and UserClass2::collision(UserClass1*).</summary>
+ *
+ * <typeparam name="UserClass1"> Type of the first user class.</typeparam>
+ * <typeparam name="UserClass2"> Type of the second user class.</typeparam>
+ **************************************************************************************************/
+template<class UserClass1, class UserClass2>
+class CollisionDispatch : public CollisionDispatchBase
+{
+public:
+	virtual void processCallBacks(Collidable* pCollidable_1, Collidable* pCollidable_2) override
+	{
+		UserClass1* pUserClass_1 = static_cast<UserClass1*>(pCollidable_1);
+		UserClass2* pUserClass_2 = static_cast<UserClass2*>(pCollidable_2);
+
+		pUserClass_1->collision(pUserClass_2);
+		pUserClass_2->collision(pUserClass_1);
+	}
+};
+#endif // !_CollisionDispatch
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionDispatch Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,11 @@
+#include "CollisionRegisterCommand.h"
+#include "CollidableAttorney.h"
+
+CollisionRegisterCommand::CollisionRegisterCommand(Collidable* pCollidable)
+	: _pCollidable(pCollidable)
+{}
+
+void CollisionRegisterCommand::execute()
+{
+	CollidableAttorney::Registration::RegisterToScene(_pCollidable);
+}
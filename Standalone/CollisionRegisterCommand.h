@@ -0,0 +1,33 @@
+#ifndef _CollisionRegisterCommand
+#define _CollisionRegisterCommand
+
+#include "SceneRegistrationCommand.h"
+
+class Collidable;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine command that registers a Collidable for collisions.</summary>
+ **************************************************************************************************/
+class CollisionRegisterCommand : public SceneRegistrationCommand
+{
+public:
+	CollisionRegisterCommand() = delete;
+	CollisionRegisterCommand(const CollisionRegisterCommand&) = default;
+	CollisionRegisterCommand& operator=(const CollisionRegisterCommand&) = default;
+	CollisionRegisterCommand(CollisionRegisterCommand&&) = default;
+	CollisionRegisterCommand& operator=(CollisionRegisterCommand&&) = default;
+	~CollisionRegisterCommand() = default;
+
+	explicit CollisionRegisterCommand(Collidable* pCollidable);
+
+	// Inherited via SceneRegistrationCommand
+	virtual void execute() override;
+
+private:
+	Collidable* _pCollidable;
+};
+#endif // !_CollisionRegisterCommand
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionRegisterCommand Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,37 @@
+#ifndef _CollisionTestTerrainCommand
+#define _CollisionTestTerrainCommand
+
+#include "CollisionTestCommand.h"
+
+class CollidableGroup;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine terrain test command.</summary>
+ *
+ * <remarks> There is no terrain outside the engine, so execute() does nothing. </remarks>
+ **************************************************************************************************/
+class CollisionTestTerrainCommand : public CollisionTestCommand
+{
+public:
+	CollisionTestTerrainCommand() = delete;
+	CollisionTestTerrainCommand(const CollisionTestTerrainCommand&) = default;
+	CollisionTestTerrainCommand& operator=(const CollisionTestTerrainCommand&) = default;
+	CollisionTestTerrainCommand(CollisionTestTerrainCommand&&) = default;
+	CollisionTestTerrainCommand& operator=(CollisionTestTerrainCommand&&) = default;
+	~CollisionTestTerrainCommand() = default;
+
+	explicit CollisionTestTerrainCommand(CollidableGroup* pCollidableGroup)
+		: _pCollidableGroup(pCollidableGroup)
+	{}
+
+	// Inherited via CollisionTestCommand
+	virtual void execute() override {}
+
+private:
+	CollidableGroup* _pCollidableGroup;
+};
+#endif // !_CollisionTestTerrainCommand
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// CollisionTestTerrainCommand Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,21 @@
+#ifndef _Colors
+#define _Colors
+
+#include "Vect.h"
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine color constants used by the debug drawing.</summary>
+ **************************************************************************************************/
+namespace Colors
+{
+	const Vect Red(1.0f, 0.0f, 0.0f);
+	const Vect Green(0.0f, 1.0f, 0.0f);
+	const Vect Blue(0.0f, 0.0f, 1.0f);
+	const Vect Orange(1.0f, 0.65f, 0.0f);
+	const Vect AliceBlue(0.94f, 0.97f, 1.0f);
+}
+#endif // !_Colors
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Colors Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,18 @@
+#ifndef _GpuVertTypes
+#define _GpuVertTypes
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the AzulCore triangle index: three indices into the vertex
+ *			 list of a Model.</summary>
+ **************************************************************************************************/
+struct TriangleIndex
+{
+	unsigned int v0;
+	unsigned int v1;
+	unsigned int v2;
+};
+#endif // !_GpuVertTypes
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// GpuVertTypes Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,171 @@
+#include "Matrix.h"
+#include <cmath>
+
+Matrix::Matrix()
+	: Matrix(IDENTITY)
+{}
+
+Matrix::Matrix(const Vect& row0, const Vect& row1, const Vect& row2, const Vect& row3)
+	: _rows{ row0, row1, row2, row3 }
+{}
+
+Matrix::Matrix(MatrixSpecialType type)
+{
+	const float diagonal = (type == IDENTITY) ? 1.0f : 0.0f;
+	_rows[0].set(diagonal, 0.0f, 0.0f, 0.0f);
+	_rows[1].set(0.0f, diagonal, 0.0f, 0.0f);
+	_rows[2].set(0.0f, 0.0f, diagonal, 0.0f);
+	_rows[3].set(0.0f, 0.0f, 0.0f, diagonal);
+}
+
+Matrix::Matrix(MatrixTransType, const Vect& translation)
+	: Matrix(TRANS, translation[x], translation[y], translation[z])
+{}
+
+Matrix::Matrix(MatrixTransType, float x, float y, float z)
+	: Matrix(IDENTITY)
+{
+	_rows[3].set(x, y, z, 1.0f);
+}
+
+Matrix::Matrix(MatrixScaleType, const Vect& scale)
+	: Matrix(SCALE, scale[x], scale[y], scale[z])
+{}
+
+Matrix::Matrix(MatrixScaleType, float x, float y, float z)
+	: Matrix(IDENTITY)
+{
+	_rows[0].set(x, 0.0f, 0.0f, 0.0f);
+	_rows[1].set(0.0f, y, 0.0f, 0.0f);
+	_rows[2].set(0.0f, 0.0f, z, 0.0f);
+}
+
+Matrix::Matrix(RotAxisAngleType, const Vect& axis, float angle)
+	: Matrix(IDENTITY)
+{
+	const Vect a = axis.getNorm();
+	const float c = std::cos(angle);
+	const float s = std::sin(angle);
+	const float t = 1.0f - c;
+
+	_rows[0].set(t * a[x] * a[x] + c, t * a[x] * a[y] + s * a[z], t * a[x] * a[z] - s * a[y], 0.0f);
+	_rows[1].set(t * a[x] * a[y] - s * a[z], t * a[y] * a[y] + c, t * a[y] * a[z] + s * a[x], 0.0f);
+	_rows[2].set(t * a[x] * a[z] + s * a[y], t * a[y] * a[z] - s * a[x], t * a[z] * a[z] + c, 0.0f);
+}
+
+void Matrix::set(MatrixRowType row, const Vect& vect)
+{
+	_rows[row] = vect;
+}
+
+const Vect& Matrix::get(MatrixRowType row) const
+{
+	return _rows[row];
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Arithmetic
+//-----------------------------------------------------------------------------------------------------------------------------
+Matrix Matrix::operator*(const Matrix& other) const
+{
+	// Row i of the product is row i transformed by the other matrix
+	return Matrix(_rows[0] * other, _rows[1] * other, _rows[2] * other, _rows[3] * other);
+}
+
+Matrix& Matrix::operator*=(const Matrix& other)
+{
+	return *this = *this * other;
+}
+
+Matrix Matrix::getT() const
+{
+	Matrix transpose;
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			transpose._rows[column][static_cast<VectComponent>(row)] = _rows[row][static_cast<VectComponent>(column)];
+		}
+	}
+	return transpose;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Inverse (cofactor expansion)
+//-----------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	void ToArray(const Matrix& matrix, float m[16])
+	{
+		for (int row = 0; row < 4; row++)
+		{
+			const Vect& matrixRow = matrix.get(static_cast<MatrixRowType>(row));
+			m[row * 4 + 0] = matrixRow[x];
+			m[row * 4 + 1] = matrixRow[y];
+			m[row * 4 + 2] = matrixRow[z];
+			m[row * 4 + 3] = matrixRow[w];
+		}
+	}
+
+	void ComputeAdjugate(const float m[16], float adjugate[16])
+	{
+		adjugate[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+		adjugate[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+		adjugate[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+		adjugate[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+		adjugate[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+		adjugate[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+		adjugate[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+		adjugate[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+		adjugate[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+		adjugate[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+		adjugate[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+		adjugate[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+		adjugate[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+		adjugate[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+		adjugate[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11] - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+		adjugate[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10] + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+	}
+}
+
+float Matrix::det() const
+{
+	float m[16];
+	float adjugate[16];
+	ToArray(*this, m);
+	ComputeAdjugate(m, adjugate);
+	return m[0] * adjugate[0] + m[1] * adjugate[4] + m[2] * adjugate[8] + m[3] * adjugate[12];
+}
+
+Matrix Matrix::getInv() const
+{
+	float m[16];
+	float adjugate[16];
+	ToArray(*this, m);
+	ComputeAdjugate(m, adjugate);
+
+	const float determinant = m[0] * adjugate[0] + m[1] * adjugate[4] + m[2] * adjugate[8] + m[3] * adjugate[12];
+	const float inverseDeterminant = (determinant != 0.0f) ? 1.0f / determinant : 0.0f;
+
+	Matrix inverse;
+	for (int row = 0; row < 4; row++)
+	{
+		inverse._rows[row].set(adjugate[row * 4 + 0] * inverseDeterminant,
+							   adjugate[row * 4 + 1] * inverseDeterminant,
+							   adjugate[row * 4 + 2] * inverseDeterminant,
+							   adjugate[row * 4 + 3] * inverseDeterminant);
+	}
+	return inverse;
+}
+
+bool Matrix::isEqual(const Matrix& other, float tolerance) const
+{
+	for (int row = 0; row < 4; row++)
+	{
+		if (!_rows[row].isEqual(other._rows[row], tolerance))
+		{
+			return false;
+		}
+	}
+	return true;
+}
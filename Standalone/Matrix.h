@@ -0,0 +1,78 @@
+#ifndef _Matrix
+#define _Matrix
+
+#include "Vect.h"
+
+enum MatrixSpecialType
+{
+	IDENTITY,
+	ZERO
+};
+
+enum MatrixTransType
+{
+	TRANS
+};
+
+enum MatrixScaleType
+{
+	SCALE
+};
+
+enum RotAxisAngleType
+{
+	ROT_AXIS_ANGLE
+};
+
+enum MatrixRowType
+{
+	ROW_0,
+	ROW_1,
+	ROW_2,
+	ROW_3
+};
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the AzulCore Matrix: a 4x4 matrix of row vectors.</summary>
+ *
+ * <remarks> Row vector convention as in Azul (v' = v * M): rows 0 to 2 hold the transformed
+ *			 basis and row 3 the translation. </remarks>
+ **************************************************************************************************/
+class Matrix
+{
+public:
+	Matrix();
+	Matrix(const Matrix&) = default;
+	Matrix& operator=(const Matrix&) = default;
+	Matrix(Matrix&&) = default;
+	Matrix& operator=(Matrix&&) = default;
+	~Matrix() = default;
+
+	Matrix(const Vect& row0, const Vect& row1, const Vect& row2, const Vect& row3);
+	explicit Matrix(MatrixSpecialType type);
+	Matrix(MatrixTransType, const Vect& translation);
+	Matrix(MatrixTransType, float x, float y, float z);
+	Matrix(MatrixScaleType, const Vect& scale);
+	Matrix(MatrixScaleType, float x, float y, float z);
+	Matrix(RotAxisAngleType, const Vect& axis, float angle);
+
+	void set(MatrixRowType row, const Vect& vect);
+	const Vect& get(MatrixRowType row) const;
+
+	Matrix operator*(const Matrix&) const;
+	Matrix& operator*=(const Matrix&);
+
+	float det() const;
+	Matrix getInv() const;
+	Matrix getT() const;
+
+	bool isEqual(const Matrix&, float tolerance = 0.0001f) const;
+
+private:
+	Vect _rows[4];
+};
+#endif // !_Matrix
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Matrix Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+#include "Model.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+Model::Model(const Vect* pVects, int numVects, const TriangleIndex* pTriangles, int numTriangles)
+	: _vects(pVects, pVects + numVects),
+	_triangles(pTriangles, pTriangles + numTriangles),
+	_radius(0.0f)
+{
+	assert(numVects > 0);
+	computeBounds();
+}
+
+void Model::computeBounds()
+{
+	_minAABB = _vects.front();
+	_maxAABB = _vects.front();
+	for (const Vect& vect : _vects)
+	{
+		_minAABB.set(std::min(_minAABB[x], vect[x]), std::min(_minAABB[y], vect[y]), std::min(_minAABB[z], vect[z]));
+		_maxAABB.set(std::max(_maxAABB[x], vect[x]), std::max(_maxAABB[y], vect[y]), std::max(_maxAABB[z], vect[z]));
+	}
+
+	// Sphere around the box center: not minimal, but always bounding
+	_center = 0.5f * (_minAABB + _maxAABB);
+	float radiusSqr = 0.0f;
+	for (const Vect& vect : _vects)
+	{
+		radiusSqr = std::max(radiusSqr, (vect - _center).magSqr());
+	}
+	_radius = std::sqrt(radiusSqr);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Getters
+//-----------------------------------------------------------------------------------------------------------------------------
+int Model::getVectNum() const
+{
+	return static_cast<int>(_vects.size());
+}
+
+Vect* Model::getVectList()
+{
+	return _vects.data();
+}
+
+const Vect* Model::getVectList() const
+{
+	return _vects.data();
+}
+
+int Model::getTriNum() const
+{
+	return static_cast<int>(_triangles.size());
+}
+
+TriangleIndex* Model::getTriangleList()
+{
+	return _triangles.data();
+}
+
+const TriangleIndex* Model::getTriangleList() const
+{
+	return _triangles.data();
+}
+
+const Vect& Model::getMinAABB() const
+{
+	return _minAABB;
+}
+
+const Vect& Model::getMaxAABB() const
+{
+	return _maxAABB;
+}
+
+const Vect& Model::getCenter() const
+{
+	return _center;
+}
+
+float Model::getRadius() const
+{
+	return _radius;
+}
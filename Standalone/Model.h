@@ -0,0 +1,67 @@
+#ifndef _Model
+#define _Model
+
+#include "Vect.h"
+#include "GpuVertTypes.h"
+#include <vector>
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the AzulCore Model: a triangle mesh kept on the CPU.</summary>
+ *
+ * <remarks> Built from vertex and triangle index arrays instead of a model file. The bounds
+ *			 (min/max AABB, center and radius) are computed once, when the model is created. </remarks>
+ **************************************************************************************************/
+class Model
+{
+private:
+	typedef std::vector<Vect> VectCollection;
+	typedef std::vector<TriangleIndex> TriangleIndexCollection;
+
+public:
+	Model() = delete;
+	Model(const Model&) = default;
+	Model& operator=(const Model&) = default;
+	Model(Model&&) = default;
+	Model& operator=(Model&&) = default;
+	~Model() = default;
+
+	/**********************************************************************************************//**
+	 * <summary> Creates a model from a copy of the mesh data.</summary>
+	 *
+	 * <param name="pVects"> The vertices (model space).</param>
+	 * <param name="numVects"> Number of vertices.</param>
+	 * <param name="pTriangles"> The triangles, indexing the vertices.</param>
+	 * <param name="numTriangles"> Number of triangles.</param>
+	 **************************************************************************************************/
+	Model(const Vect* pVects, int numVects, const TriangleIndex* pTriangles, int numTriangles);
+
+	int getVectNum() const;
+	Vect* getVectList();
+	const Vect* getVectList() const;
+
+	int getTriNum() const;
+	TriangleIndex* getTriangleList();
+	const TriangleIndex* getTriangleList() const;
+
+	const Vect& getMinAABB() const;
+	const Vect& getMaxAABB() const;
+	const Vect& getCenter() const;
+	float getRadius() const;
+
+private:
+	void computeBounds();
+
+private:
+	VectCollection _vects;
+	TriangleIndexCollection _triangles;
+
+	Vect _minAABB;
+	Vect _maxAABB;
+	Vect _center;
+	float _radius;
+};
+#endif // !_Model
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Model Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,16 @@
+#ifndef _RegistrationStates
+#define _RegistrationStates
+
+// Headless stand-in for the engine registration states
+enum class RegistrationState
+{
+	CURRENTLY_DEREGISTERED,
+	PENDING_REGISTRATION,
+	CURRENTLY_REGISTERED,
+	PENDING_DEREGISTRATION
+};
+#endif // !_RegistrationStates
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// RegistrationStates Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
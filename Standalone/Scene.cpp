@@ -0,0 +1,39 @@
+#include "Scene.h"
+#include "SceneRegistrationCommand.h"
+#include "CollisionManager.h"
+
+Scene::Scene()
+	: _pCollisionManager(new CollisionManager())
+{}
+
+Scene::~Scene()
+{
+	delete _pCollisionManager;
+}
+
+void Scene::submitCommand(SceneRegistrationCommand* pCommand)
+{
+	_pendingCommands.push_back(pCommand);
+}
+
+void Scene::executeRegistrationCommands()
+{
+	// Commands may submit new ones, those run on the next update
+	CommandCollection commands;
+	commands.swap(_pendingCommands);
+	for (SceneRegistrationCommand* pCommand : commands)
+	{
+		pCommand->execute();
+	}
+}
+
+void Scene::update()
+{
+	executeRegistrationCommands();
+	_pCollisionManager->processCollisions();
+}
+
+CollisionManager& Scene::getCollisionManager()
+{
+	return *_pCollisionManager;
+}
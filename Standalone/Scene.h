@@ -0,0 +1,44 @@
+#ifndef _Scene
+#define _Scene
+
+#include <vector>
+
+class CollisionManager;
+class SceneRegistrationCommand;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine Scene: owns a CollisionManager and the queue of
+ *			 registration commands.</summary>
+ *
+ * <remarks> update() runs the part of the engine frame the collision code depends on:
+ *			 pending registration commands first, then the collisions. </remarks>
+ **************************************************************************************************/
+class Scene
+{
+private:
+	typedef std::vector<SceneRegistrationCommand*> CommandCollection;
+
+public:
+	Scene();
+	Scene(const Scene&) = delete;
+	Scene& operator=(const Scene&) = delete;
+	Scene(Scene&&) = delete;
+	Scene& operator=(Scene&&) = delete;
+	~Scene();
+
+	void submitCommand(SceneRegistrationCommand* pCommand);
+	void executeRegistrationCommands();
+
+	void update();
+
+	CollisionManager& getCollisionManager();
+
+private:
+	CollisionManager* _pCollisionManager;
+	CommandCollection _pendingCommands;
+};
+#endif // !_Scene
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Scene Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,13 @@
+#include "SceneAttorney.h"
+#include "SceneManager.h"
+#include "Scene.h"
+
+CollisionManager& SceneAttorney::RegistrationAccess::GetCollisionManager()
+{
+	return SceneManager::GetCurrentScene()->getCollisionManager();
+}
+
+void SceneAttorney::RegistrationAccess::SubmitCommand(Scene* pScene, SceneRegistrationCommand* pCommand)
+{
+	pScene->submitCommand(pCommand);
+}
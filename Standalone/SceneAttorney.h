@@ -0,0 +1,26 @@
+#ifndef _SceneAttorney
+#define _SceneAttorney
+
+class Scene;
+class CollisionManager;
+class SceneRegistrationCommand;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine attorney giving the collision code access to the
+ *			 current Scene.</summary>
+ **************************************************************************************************/
+class SceneAttorney
+{
+public:
+	class RegistrationAccess
+	{
+	public:
+		static CollisionManager& GetCollisionManager();
+		static void SubmitCommand(Scene* pScene, SceneRegistrationCommand* pCommand);
+	};
+};
+#endif // !_SceneAttorney
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// SceneAttorney Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
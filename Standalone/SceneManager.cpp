@@ -0,0 +1,15 @@
+#include "SceneManager.h"
+#include <cassert>
+
+Scene* SceneManager::pCurrentScene = nullptr;
+
+Scene* SceneManager::GetCurrentScene()
+{
+	assert(pCurrentScene != nullptr);
+	return pCurrentScene;
+}
+
+void SceneManager::SetCurrentScene(Scene* pScene)
+{
+	pCurrentScene = pScene;
+}
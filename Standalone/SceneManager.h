@@ -0,0 +1,26 @@
+#ifndef _SceneManager
+#define _SceneManager
+
+class Scene;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine SceneManager: holds the current Scene.</summary>
+ *
+ * <remarks> The current scene is set by the caller (tools, tests), it is not owned. </remarks>
+ **************************************************************************************************/
+class SceneManager
+{
+public:
+	SceneManager() = delete;
+
+	static Scene* GetCurrentScene();
+	static void SetCurrentScene(Scene* pScene);
+
+private:
+	static Scene* pCurrentScene;
+};
+#endif // !_SceneManager
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// SceneManager Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,24 @@
+#ifndef _SceneRegistrationCommand
+#define _SceneRegistrationCommand
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine command submitted to a Scene and executed at
+ *			 the start of its next update.</summary>
+ **************************************************************************************************/
+class SceneRegistrationCommand
+{
+public:
+	SceneRegistrationCommand() = default;
+	SceneRegistrationCommand(const SceneRegistrationCommand&) = default;
+	SceneRegistrationCommand& operator=(const SceneRegistrationCommand&) = default;
+	SceneRegistrationCommand(SceneRegistrationCommand&&) = default;
+	SceneRegistrationCommand& operator=(SceneRegistrationCommand&&) = default;
+	virtual ~SceneRegistrationCommand() = default;
+
+	virtual void execute() = 0;
+};
+#endif // !_SceneRegistrationCommand
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// SceneRegistrationCommand Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
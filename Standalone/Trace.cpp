@@ -0,0 +1,20 @@
+#include "Trace.h"
+#include <cstdarg>
+#include <cstdio>
+
+bool Trace::isEnabled = true;
+
+void Trace::out(const char* format, ...)
+{
+	if (!isEnabled) return;
+
+	va_list arguments;
+	va_start(arguments, format);
+	vfprintf(stderr, format, arguments);
+	va_end(arguments);
+}
+
+void Trace::SetEnabled(bool enabled)
+{
+	isEnabled = enabled;
+}
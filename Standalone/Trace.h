@@ -0,0 +1,26 @@
+#ifndef _Trace
+#define _Trace
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the AzulCore Trace: printf style debug output.</summary>
+ *
+ * <remarks> Writes to stderr, so it never mixes with the output of the tools. Tools that time
+ *			 engine code can turn it off with SetEnabled(false). </remarks>
+ **************************************************************************************************/
+class Trace
+{
+public:
+	Trace() = delete;
+
+	static void out(const char* format, ...);
+
+	static void SetEnabled(bool isEnabled);
+
+private:
+	static bool isEnabled;
+};
+#endif // !_Trace
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Trace Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
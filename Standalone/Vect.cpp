@@ -0,0 +1,159 @@
+#include "Vect.h"
+#include "Matrix.h"
+#include <cmath>
+
+Vect::Vect()
+	: _v{ 0.0f, 0.0f, 0.0f, 1.0f }
+{}
+
+Vect::Vect(float x, float y, float z, float w)
+	: _v{ x, y, z, w }
+{}
+
+void Vect::set(float x, float y, float z, float w)
+{
+	_v[0] = x;
+	_v[1] = y;
+	_v[2] = z;
+	_v[3] = w;
+}
+
+float& Vect::operator[](VectComponent component)
+{
+	return _v[component];
+}
+
+float Vect::operator[](VectComponent component) const
+{
+	return _v[component];
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Arithmetic
+//-----------------------------------------------------------------------------------------------------------------------------
+Vect Vect::operator+(const Vect& other) const
+{
+	return Vect(_v[0] + other._v[0], _v[1] + other._v[1], _v[2] + other._v[2]);
+}
+
+Vect Vect::operator-(const Vect& other) const
+{
+	return Vect(_v[0] - other._v[0], _v[1] - other._v[1], _v[2] - other._v[2]);
+}
+
+Vect Vect::operator-() const
+{
+	return Vect(-_v[0], -_v[1], -_v[2]);
+}
+
+Vect Vect::operator+() const
+{
+	return Vect(_v[0], _v[1], _v[2]);
+}
+
+Vect Vect::operator*(float scale) const
+{
+	return Vect(_v[0] * scale, _v[1] * scale, _v[2] * scale);
+}
+
+Vect Vect::operator/(float scale) const
+{
+	return *this * (1.0f / scale);
+}
+
+Vect Vect::operator*(const Matrix& matrix) const
+{
+	Vect result(0.0f, 0.0f, 0.0f, 0.0f);
+	for (int row = 0; row < 4; row++)
+	{
+		const Vect& matrixRow = matrix.get(static_cast<MatrixRowType>(row));
+		for (int column = 0; column < 4; column++)
+		{
+			result._v[column] += _v[row] * matrixRow._v[column];
+		}
+	}
+	return result;
+}
+
+Vect& Vect::operator+=(const Vect& other)
+{
+	return *this = *this + other;
+}
+
+Vect& Vect::operator-=(const Vect& other)
+{
+	return *this = *this - other;
+}
+
+Vect& Vect::operator*=(float scale)
+{
+	return *this = *this * scale;
+}
+
+Vect& Vect::operator/=(float scale)
+{
+	return *this = *this / scale;
+}
+
+Vect& Vect::operator*=(const Matrix& matrix)
+{
+	return *this = *this * matrix;
+}
+
+Vect operator*(float scale, const Vect& vect)
+{
+	return vect * scale;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Products and norms
+//-----------------------------------------------------------------------------------------------------------------------------
+float Vect::dot(const Vect& other) const
+{
+	return _v[0] * other._v[0] + _v[1] * other._v[1] + _v[2] * other._v[2];
+}
+
+Vect Vect::cross(const Vect& other) const
+{
+	return Vect(_v[1] * other._v[2] - _v[2] * other._v[1],
+				_v[2] * other._v[0] - _v[0] * other._v[2],
+				_v[0] * other._v[1] - _v[1] * other._v[0]);
+}
+
+float Vect::mag() const
+{
+	return std::sqrt(magSqr());
+}
+
+float Vect::magSqr() const
+{
+	return dot(*this);
+}
+
+Vect Vect::getNorm() const
+{
+	const float magnitude = mag();
+	return magnitude > 0.0f ? *this / magnitude : Vect(_v[0], _v[1], _v[2]);
+}
+
+Vect& Vect::norm()
+{
+	return *this = getNorm();
+}
+
+bool Vect::isEqual(const Vect& other, float tolerance) const
+{
+	for (int i = 0; i < 4; i++)
+	{
+		if (std::fabs(_v[i] - other._v[i]) > tolerance)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Vect::isZero(float tolerance) const
+{
+	return std::fabs(_v[0]) <= tolerance && std::fabs(_v[1]) <= tolerance && std::fabs(_v[2]) <= tolerance;
+}
@@ -0,0 +1,73 @@
+#ifndef _Vect
+#define _Vect
+
+class Matrix;
+
+// Component selectors, used as vect[x], vect[y], vect[z] and vect[w]
+enum VectComponent
+{
+	x = 0,
+	y = 1,
+	z = 2,
+	w = 3
+};
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the AzulCore Vect: a 4 component row vector.</summary>
+ *
+ * <remarks> Only the part of the Azul interface used by the collision code. As in Azul,
+ *			 arithmetic works on xyz and sets w to 1, while a Vect * Matrix product uses w
+ *			 (w = 1 for points, w = 0 for directions). </remarks>
+ **************************************************************************************************/
+class Vect
+{
+public:
+	Vect();
+	Vect(const Vect&) = default;
+	Vect& operator=(const Vect&) = default;
+	Vect(Vect&&) = default;
+	Vect& operator=(Vect&&) = default;
+	~Vect() = default;
+
+	Vect(float x, float y, float z, float w = 1.0f);
+
+	void set(float x, float y, float z, float w = 1.0f);
+
+	float& operator[](VectComponent component);
+	float operator[](VectComponent component) const;
+
+	Vect operator+(const Vect&) const;
+	Vect operator-(const Vect&) const;
+	Vect operator-() const;
+	Vect operator+() const;
+	Vect operator*(float) const;
+	Vect operator/(float) const;
+	Vect operator*(const Matrix&) const;
+
+	Vect& operator+=(const Vect&);
+	Vect& operator-=(const Vect&);
+	Vect& operator*=(float);
+	Vect& operator/=(float);
+	Vect& operator*=(const Matrix&);
+
+	friend Vect operator*(float, const Vect&);
+
+	float dot(const Vect&) const;
+	Vect cross(const Vect&) const;
+
+	float mag() const;
+	float magSqr() const;
+	Vect getNorm() const;
+	Vect& norm();
+
+	bool isEqual(const Vect&, float tolerance = 0.0001f) const;
+	bool isZero(float tolerance = 0.0001f) const;
+
+private:
+	float _v[4];
+};
+#endif // !_Vect
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Vect Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,26 @@
+#ifndef _Visualizer
+#define _Visualizer
+
+#include "Colors.h"
+
+class CollisionVolume;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the engine Visualizer: every call is a no-op.</summary>
+ *
+ * <remarks> Keeps the debug drawing of the collision code compiling without a renderer. </remarks>
+ **************************************************************************************************/
+class Visualizer
+{
+public:
+	Visualizer() = delete;
+
+	static void ShowCollisionVolume(const CollisionVolume&, const Vect& = Colors::Blue) {}
+	static void ShowPointAt(const Vect&, const Vect& = Colors::Blue) {}
+	static void ShowLineSegment(const Vect&, const Vect&, const Vect& = Colors::Blue) {}
+};
+#endif // !_Visualizer
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Visualizer Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
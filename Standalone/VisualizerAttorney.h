@@ -0,0 +1,28 @@
+#ifndef _VisualizerAttorney
+#define _VisualizerAttorney
+
+#include "Visualizer.h"
+
+class CollisionVolumeBSphere;
+class CollisionVolumeAABB;
+class CollisionVolumeOBB;
+
+/**********************************************************************************************//**
+ * <summary> Headless stand-in for the Visualizer attorney used by the collision volumes.</summary>
+ **************************************************************************************************/
+class VisualizerAttorney
+{
+public:
+	class RenderAccess
+	{
+	public:
+		static void ShowBSphere(const CollisionVolumeBSphere&, const Vect&) {}
+		static void ShowAABB(const CollisionVolumeAABB&, const Vect&) {}
+		static void ShowOBB(const CollisionVolumeOBB&, const Vect&) {}
+	};
+};
+#endif // !_VisualizerAttorney
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// VisualizerAttorney Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,66 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<unsigned long long> allocationCount(0);
+	std::atomic<unsigned long long> allocationBytes(0);
+
+	void* CountedAllocate(std::size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocationBytes.fetch_add(size, std::memory_order_relaxed);
+
+		void* pMemory = std::malloc(size == 0 ? 1 : size);
+		if (pMemory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+		return pMemory;
+	}
+}
+
+unsigned long long AllocationCounter::GetCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+unsigned long long AllocationCounter::GetBytes()
+{
+	return allocationBytes.load(std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Global operator new/delete replacements
+//-----------------------------------------------------------------------------------------------------------------------------
+void* operator new(std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return CountedAllocate(size);
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
+
+void operator delete[](void* pMemory, std::size_t) noexcept
+{
+	std::free(pMemory);
+}
@@ -0,0 +1,22 @@
+#ifndef _AllocationCounter
+#define _AllocationCounter
+
+/**********************************************************************************************//**
+// namespace: AllocationCounter
+//
+// summary:	Counts the heap allocations of the process. AllocationCounter.cpp replaces the global
+//			operator new, so it must be compiled into the tool executable itself.
+ **************************************************************************************************/
+namespace AllocationCounter
+{
+	// Number of calls to operator new (any form) since the start of the process
+	unsigned long long GetCount();
+
+	// Number of bytes requested from operator new since the start of the process
+	unsigned long long GetBytes();
+};
+#endif // !_AllocationCounter
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// AllocationCounter Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
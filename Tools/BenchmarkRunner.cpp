@@ -0,0 +1,93 @@
+#include "BenchmarkRunner.h"
+#include <cmath>
+
+BenchmarkRunner::BenchmarkRunner(double minTimeSeconds, const std::string& filter)
+	: _minTimeSeconds(minTimeSeconds), _filter(filter)
+{}
+
+bool BenchmarkRunner::isSelected(const std::string& name) const
+{
+	return _filter.empty() || name.find(_filter) != std::string::npos;
+}
+
+void BenchmarkRunner::printProgress(const BenchmarkResult& result) const
+{
+	// Progress goes to stderr, the JSON may be on stdout
+	fprintf(stderr, "%-56s %14.1f ns/op %12lld it", result.name.c_str(), result.nsPerOp, result.iterations);
+	if (result.nodesVisitedPerOp >= 0.0)
+	{
+		fprintf(stderr, " %10.1f nodes/op", result.nodesVisitedPerOp);
+	}
+	if (result.allocationsPerOp > 0.0)
+	{
+		fprintf(stderr, " %8.2f allocs/op", result.allocationsPerOp);
+	}
+	fprintf(stderr, "\n");
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// JSON
+//-----------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	void WriteNumber(FILE* pFile, double value)
+	{
+		// JSON has no NaN or infinity
+		if (std::isfinite(value))
+		{
+			fprintf(pFile, "%.9g", value);
+		}
+		else
+		{
+			fprintf(pFile, "null");
+		}
+	}
+
+	void WriteMetrics(FILE* pFile, const BenchmarkResult::MetricCollection& metrics, const char* indent)
+	{
+		for (const auto& metric : metrics)
+		{
+			fprintf(pFile, ",\n%s\"%s\": ", indent, metric.first.c_str());
+			WriteNumber(pFile, metric.second);
+		}
+	}
+}
+
+void BenchmarkRunner::writeJson(FILE* pFile, const std::string& suiteName, const BenchmarkResult::MetricCollection& configuration) const
+{
+	fprintf(pFile, "{\n");
+	fprintf(pFile, "  \"suite\": \"%s\",\n", suiteName.c_str());
+	fprintf(pFile, "  \"configuration\": {\n");
+	fprintf(pFile, "    \"min_time_s\": ");
+	WriteNumber(pFile, _minTimeSeconds);
+	WriteMetrics(pFile, configuration, "    ");
+	fprintf(pFile, "\n  },\n");
+	fprintf(pFile, "  \"results\": [");
+
+	for (size_t i = 0; i < _results.size(); i++)
+	{
+		const BenchmarkResult& result = _results[i];
+		fprintf(pFile, "%s\n    {\n", (i == 0) ? "" : ",");
+		fprintf(pFile, "      \"name\": \"%s\",\n", result.name.c_str());
+		fprintf(pFile, "      \"iterations\": %lld,\n", result.iterations);
+		fprintf(pFile, "      \"ns_per_op\": ");
+		WriteNumber(pFile, result.nsPerOp);
+		fprintf(pFile, ",\n      \"allocations_per_op\": ");
+		WriteNumber(pFile, result.allocationsPerOp);
+
+		BenchmarkResult::MetricCollection optionalMetrics;
+		if (result.nodesVisitedPerOp >= 0.0)
+		{
+			optionalMetrics.push_back(std::make_pair("nodes_visited_per_op", result.nodesVisitedPerOp));
+		}
+		if (result.hitRate >= 0.0)
+		{
+			optionalMetrics.push_back(std::make_pair("hit_rate", result.hitRate));
+		}
+		WriteMetrics(pFile, optionalMetrics, "      ");
+		WriteMetrics(pFile, result.metrics, "      ");
+		fprintf(pFile, "\n    }");
+	}
+
+	fprintf(pFile, "\n  ]\n}\n");
+}
@@ -0,0 +1,164 @@
+#ifndef _BenchmarkRunner
+#define _BenchmarkRunner
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+
+#include "AllocationCounter.h"
+#include "CollisionStats.h"
+
+/**********************************************************************************************//**
+ * <summary> Result of one benchmark.</summary>
+ *
+ * <remarks> Every "per op" value is averaged over the timed iterations. Values that do not
+ *			 apply to a benchmark are negative and left out of the JSON. </remarks>
+ **************************************************************************************************/
+struct BenchmarkResult
+{
+	typedef std::vector<std::pair<std::string, double>> MetricCollection;
+
+	std::string name;
+	long long iterations = 0;
+	double nsPerOp = 0.0;
+	double allocationsPerOp = 0.0;
+	double nodesVisitedPerOp = -1.0;
+	double hitRate = -1.0;
+
+	// Benchmark specific values (e.g. number of valid nodes of a built Octree)
+	MetricCollection metrics;
+};
+
+/**********************************************************************************************//**
+ * <summary> Times operations until a minimum duration is reached and collects the results.</summary>
+ *
+ * <remarks> An operation is called with the iteration index. If it returns bool, the fraction
+ *			 of true results is reported as the hit rate. Octree node and node pair visits are
+ *			 counted by making a CollisionCommandStats active while timing (see CollisionCounters),
+ *			 allocations by AllocationCounter (the executable must compile AllocationCounter.cpp).
+ *			 </remarks>
+ **************************************************************************************************/
+class BenchmarkRunner
+{
+private:
+	typedef std::deque<BenchmarkResult> ResultCollection;
+	typedef std::chrono::steady_clock Clock;
+
+public:
+	BenchmarkRunner() = delete;
+	BenchmarkRunner(const BenchmarkRunner&) = delete;
+	BenchmarkRunner& operator=(const BenchmarkRunner&) = delete;
+	BenchmarkRunner(BenchmarkRunner&&) = delete;
+	BenchmarkRunner& operator=(BenchmarkRunner&&) = delete;
+	~BenchmarkRunner() = default;
+
+	/**********************************************************************************************//**
+	 * <summary> Constructor.</summary>
+	 *
+	 * <param name="minTimeSeconds"> Minimum timed duration of each benchmark.</param>
+	 * <param name="filter"> Only benchmarks whose name contains it are run (empty runs all).</param>
+	 **************************************************************************************************/
+	BenchmarkRunner(double minTimeSeconds, const std::string& filter);
+
+	bool isSelected(const std::string& name) const;
+
+	/**********************************************************************************************//**
+	 * <summary> Runs a benchmark.</summary>
+	 *
+	 * <param name="name"> The name of the benchmark ("Group/Case/Variant").</param>
+	 * <param name="operation"> The operation, called as operation(long long iteration).</param>
+	 *
+	 * <returns> The result to add metrics to (stays valid), nullptr if the benchmark is filtered out.</returns>
+	 **************************************************************************************************/
+	template <typename Operation>
+	BenchmarkResult* run(const std::string& name, Operation operation)
+	{
+		if (!isSelected(name)) return nullptr;
+
+		const bool returnsHit = std::is_same<decltype(operation(0LL)), bool>::value;
+
+		// Warm up caches and one time allocations
+		callOperation(operation, 0, std::integral_constant<bool, returnsHit>());
+
+		long long iterations = 1;
+		long long hits = 0;
+		double elapsedSeconds = 0.0;
+		unsigned long long nodesVisited = 0;
+		unsigned long long allocations = 0;
+
+		CollisionCommandStats stats;
+		CollisionCounters::SetActive(&stats);
+
+		while (true)
+		{
+			stats.reset();
+			const unsigned long long startAllocations = AllocationCounter::GetCount();
+			const Clock::time_point start = Clock::now();
+
+			hits = 0;
+			for (long long i = 0; i < iterations; i++)
+			{
+				hits += callOperation(operation, i, std::integral_constant<bool, returnsHit>()) ? 1 : 0;
+			}
+
+			elapsedSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+			nodesVisited = stats.octreeNodeVisits + stats.octreeNodePairVisits;
+			allocations = AllocationCounter::GetCount() - startAllocations;
+
+			if (elapsedSeconds >= _minTimeSeconds || iterations >= MAX_ITERATIONS) break;
+
+			// Aim a little past the minimum time, growing at most 10x per attempt
+			const double scale = (elapsedSeconds > 0.0) ? 1.4 * _minTimeSeconds / elapsedSeconds : 10.0;
+			iterations = static_cast<long long>(iterations * std::min(10.0, std::max(2.0, scale)));
+		}
+
+		CollisionCounters::SetActive(nullptr);
+
+		BenchmarkResult result;
+		result.name = name;
+		result.iterations = iterations;
+		result.nsPerOp = elapsedSeconds * 1e9 / iterations;
+		result.allocationsPerOp = static_cast<double>(allocations) / iterations;
+		result.nodesVisitedPerOp = (nodesVisited > 0) ? static_cast<double>(nodesVisited) / iterations : -1.0;
+		result.hitRate = returnsHit ? static_cast<double>(hits) / iterations : -1.0;
+
+		_results.push_back(result);
+		printProgress(_results.back());
+		return &_results.back();
+	}
+
+	void writeJson(FILE* pFile, const std::string& suiteName, const BenchmarkResult::MetricCollection& configuration) const;
+
+private:
+	template <typename Operation>
+	static bool callOperation(Operation& operation, long long i, std::true_type)
+	{
+		return operation(i);
+	}
+
+	template <typename Operation>
+	static bool callOperation(Operation& operation, long long i, std::false_type)
+	{
+		operation(i);
+		return false;
+	}
+
+	void printProgress(const BenchmarkResult& result) const;
+
+private:
+	static const long long MAX_ITERATIONS = 1LL << 40;
+
+	double _minTimeSeconds;
+	std::string _filter;
+	ResultCollection _results;
+};
+#endif // !_BenchmarkRunner
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// BenchmarkRunner Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,660 @@
+#include "BenchmarkRunner.h"
+#include "ProceduralMeshes.h"
+
+#include "MathTools.h"
+#include "BatchTools.h"
+#include "TriangleBatch.h"
+#include "CollisionVolumeBSphere.h"
+#include "CollisionVolumeAABB.h"
+#include "CollisionVolumeOBB.h"
+#include "CollisionVolumeOctree.h"
+#include "OctreeBuilder.h"
+#include "OctreeNode.h"
+#include "OctreeNodeArena.h"
+#include "OctreeTools.h"
+#include "OctreeModelManager.h"
+#include "Triangle.h"
+#include "AzulCore.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Micro-benchmarks of the MathTools intersection kernels and of the Octree build and queries.
+// Usage: CollisionBenchmark [--out file.json] [--filter text] [--min-time seconds] [--max-depth depth] [--check]
+//-----------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	// Number of distinct hit (and miss) cases cycled through by each query benchmark
+	const int CASE_COUNT = 1024;
+
+	// Random pairs generated per wanted case before giving up on a distribution
+	const int ATTEMPTS_PER_CASE = 200;
+
+	// Depth of the Octrees used by the query benchmarks
+	const int QUERY_DEPTH = 5;
+
+	const int MIN_BUILD_DEPTH = 2;
+
+	// Boxes of the box-triangle kernel check, each tested against a batch of triangles
+	const int CHECK_BOX_COUNT = 4096;
+	const int CHECK_TRIANGLES_PER_BOX = 64;
+
+	struct Options
+	{
+		std::string outputPath;
+		std::string filter;
+		double minTimeSeconds = 0.2;
+		int maxBuildDepth = 7;
+		bool isCheckOnly = false;
+	};
+
+	void PrintUsage()
+	{
+		fprintf(stderr,
+			"Usage: CollisionBenchmark [options]\n"
+			"  --out <file>         Write the JSON results to a file (default: stdout)\n"
+			"  --filter <text>      Only run the benchmarks whose name contains the text\n"
+			"  --min-time <seconds> Minimum timed duration of each benchmark (default: 0.2)\n"
+			"  --max-depth <depth>  Deepest Octree build to benchmark, %d to %d (default: 7)\n"
+			"  --check              Only run the box-triangle kernel check (also run before the benchmarks)\n",
+			MIN_BUILD_DEPTH, OctreeTools::MAX_DEPTH);
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const bool hasValue = (i + 1 < argc);
+			if (strcmp(argv[i], "--out") == 0 && hasValue)
+			{
+				options.outputPath = argv[++i];
+			}
+			else if (strcmp(argv[i], "--filter") == 0 && hasValue)
+			{
+				options.filter = argv[++i];
+			}
+			else if (strcmp(argv[i], "--min-time") == 0 && hasValue)
+			{
+				options.minTimeSeconds = atof(argv[++i]);
+			}
+			else if (strcmp(argv[i], "--max-depth") == 0 && hasValue)
+			{
+				options.maxBuildDepth = atoi(argv[++i]);
+			}
+			else if (strcmp(argv[i], "--check") == 0)
+			{
+				options.isCheckOnly = true;
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options.minTimeSeconds > 0.0
+			&& options.maxBuildDepth >= MIN_BUILD_DEPTH && options.maxBuildDepth <= OctreeTools::MAX_DEPTH;
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Random volumes
+	//-------------------------------------------------------------------------------------------------------------------------
+	class VolumeGenerator
+	{
+	public:
+		explicit VolumeGenerator(unsigned int seed)
+			: _random(seed)
+		{}
+
+		float uniform(float min, float max)
+		{
+			return std::uniform_real_distribution<float>(min, max)(_random);
+		}
+
+		Vect point(const Vect& min, const Vect& max)
+		{
+			return Vect(uniform(min[x], max[x]), uniform(min[y], max[y]), uniform(min[z], max[z]));
+		}
+
+		Matrix rotation()
+		{
+			const Vect axis(uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f));
+			if (axis.magSqr() < 0.0001f) return Matrix(IDENTITY);
+			return Matrix(ROT_AXIS_ANGLE, axis, uniform(0.0f, 6.2831853f));
+		}
+
+		CollisionVolumeBSphere BSphere(const Vect& min, const Vect& max, float minSize, float maxSize)
+		{
+			CollisionVolumeBSphere BSphere;
+			BSphere.computeData(point(min, max), uniform(minSize, maxSize));
+			return BSphere;
+		}
+
+		CollisionVolumeAABB AABB(const Vect& min, const Vect& max, float minSize, float maxSize)
+		{
+			const Vect center = point(min, max);
+			const Vect halfDiagonal(uniform(minSize, maxSize), uniform(minSize, maxSize), uniform(minSize, maxSize));
+
+			CollisionVolumeAABB AABB;
+			AABB.computeData(center - halfDiagonal, center + halfDiagonal);
+			return AABB;
+		}
+
+		CollisionVolumeOBB OBB(const Vect& min, const Vect& max, float minSize, float maxSize)
+		{
+			const Vect halfDiagonal(uniform(minSize, maxSize), uniform(minSize, maxSize), uniform(minSize, maxSize));
+
+			CollisionVolumeOBB OBB;
+			OBB.computeData(-halfDiagonal, halfDiagonal, rotation() * Matrix(TRANS, point(min, max)));
+			return OBB;
+		}
+
+		Triangle triangle(const Vect& min, const Vect& max, float minSize, float maxSize)
+		{
+			const Vect center = point(min, max);
+			const Vect offsetMin(-maxSize, -maxSize, -maxSize);
+			const Vect offsetMax(maxSize, maxSize, maxSize);
+
+			// Keep the triangle from collapsing into a sliver
+			Vect vertex1 = center + point(offsetMin, offsetMax);
+			Vect vertex2 = center + point(offsetMin, offsetMax);
+			while ((vertex1 - center).cross(vertex2 - center).mag() < minSize * minSize)
+			{
+				vertex1 = center + point(offsetMin, offsetMax);
+				vertex2 = center + point(offsetMin, offsetMax);
+			}
+			return Triangle(center, vertex1, vertex2);
+		}
+
+	private:
+		std::mt19937 _random;
+	};
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Hit and miss distributions
+	//-------------------------------------------------------------------------------------------------------------------------
+	template <typename First, typename Second>
+	struct PairCases
+	{
+		std::vector<First> first;
+		std::vector<Second> second;
+
+		size_t getSize() const
+		{
+			return first.size();
+		}
+	};
+
+	/**********************************************************************************************//**
+	 * <summary> Generates random pairs and sorts them into hits and misses with the test under
+	 *			 benchmark, until there are caseCount of each (or the attempts run out).</summary>
+	 **************************************************************************************************/
+	template <typename First, typename Second, typename GenerateFirst, typename GenerateSecond, typename Test>
+	void MakeCases(GenerateFirst generateFirst, GenerateSecond generateSecond, Test test, int caseCount,
+		PairCases<First, Second>& hits, PairCases<First, Second>& misses)
+	{
+		const int maxAttempts = caseCount * ATTEMPTS_PER_CASE;
+		for (int attempt = 0; attempt < maxAttempts; attempt++)
+		{
+			if (hits.getSize() >= static_cast<size_t>(caseCount) && misses.getSize() >= static_cast<size_t>(caseCount)) break;
+
+			First first = generateFirst();
+			Second second = generateSecond();
+			PairCases<First, Second>& cases = test(first, second) ? hits : misses;
+			if (cases.getSize() < static_cast<size_t>(caseCount))
+			{
+				cases.first.push_back(first);
+				cases.second.push_back(second);
+			}
+		}
+	}
+
+	template <typename First, typename Second, typename Test>
+	void RunCases(BenchmarkRunner& runner, const std::string& name, const PairCases<First, Second>& cases, Test test)
+	{
+		if (cases.getSize() == 0)
+		{
+			fprintf(stderr, "%-56s skipped (no case found)\n", name.c_str());
+			return;
+		}
+
+		const size_t size = cases.getSize();
+		runner.run(name, [&](long long i)
+		{
+			const size_t index = static_cast<size_t>(i) % size;
+			return test(cases.first[index], cases.second[index]);
+		});
+	}
+
+	template <typename First, typename Second, typename GenerateFirst, typename GenerateSecond, typename Test>
+	void RunPairBenchmark(BenchmarkRunner& runner, const std::string& name,
+		GenerateFirst generateFirst, GenerateSecond generateSecond, Test test, int caseCount = CASE_COUNT)
+	{
+		if (!runner.isSelected(name)) return;
+
+		PairCases<First, Second> hits;
+		PairCases<First, Second> misses;
+		MakeCases(generateFirst, generateSecond, test, caseCount, hits, misses);
+
+		RunCases(runner, name + "/hit", hits, test);
+		RunCases(runner, name + "/miss", misses, test);
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Box-triangle kernel check
+	//-------------------------------------------------------------------------------------------------------------------------
+
+	// Moves one vertex of a triangle onto a face plane of the box, so the pair touches or nearly does
+	Triangle SnapToBoxFace(VolumeGenerator& generator, const Triangle& triangle, const Vect& minVertex, const Vect& maxVertex)
+	{
+		Vect vertices[3] = { triangle.getVertex0(), triangle.getVertex1(), triangle.getVertex2() };
+		const int vertexIndex = static_cast<int>(generator.uniform(0.0f, 2.999f));
+		const VectComponent axis = static_cast<VectComponent>(generator.uniform(0.0f, 2.999f));
+		vertices[vertexIndex][axis] = (generator.uniform(0.0f, 1.0f) < 0.5f) ? minVertex[axis] : maxVertex[axis];
+		return Triangle(vertices[0], vertices[1], vertices[2]);
+	}
+
+	/**********************************************************************************************//**
+	 * <summary> Checks that the box-triangle kernels agree, on random and touching pairs.</summary>
+	 *
+	 * <remarks> BatchTools::IntersectTriangles() must return exactly the triangles that
+	 *			 MathTools::IntersectBoxTriangle() hits, and MathTools::IntersectBoxTriangle() must
+	 *			 agree with the OBB separating axis test on the random pairs (the touching pairs
+	 *			 are left out of that comparison, where the kernels round differently). Every
+	 *			 Octree leaf is validated by these kernels. </remarks>
+	 *
+	 * <returns> True if every pair agrees.</returns>
+	 **************************************************************************************************/
+	bool CheckBoxTriangleKernels()
+	{
+		VolumeGenerator generator(4096);
+
+		// Same distribution as the primitive benchmarks
+		const Vect min(-4.0f, -4.0f, -4.0f);
+		const Vect max(4.0f, 4.0f, 4.0f);
+		const float minSize = 0.5f;
+		const float maxSize = 2.0f;
+
+		int pairCount = 0;
+		int batchMismatches = 0;
+		int referenceMismatches = 0;
+		TriangleBatch triangles;
+		BatchTools::IndexCollection batchHits;
+		std::vector<char> scalarHits(CHECK_TRIANGLES_PER_BOX);
+		for (int box = 0; box < CHECK_BOX_COUNT; box++)
+		{
+			const CollisionVolumeAABB AABB = generator.AABB(min, max, minSize, maxSize);
+			const Vect& minVertex = AABB.getMinWorldVertex();
+			const Vect& maxVertex = AABB.getMaxWorldVertex();
+			CollisionVolumeOBB OBB;
+			OBB.computeData(minVertex, maxVertex, Matrix(IDENTITY));
+
+			// Every other box gets touching triangles
+			const bool isTouching = (box % 2) == 1;
+			triangles.clear();
+			for (int i = 0; i < CHECK_TRIANGLES_PER_BOX; i++)
+			{
+				const Triangle triangle = generator.triangle(min, max, minSize, maxSize);
+				triangles.add(isTouching ? SnapToBoxFace(generator, triangle, minVertex, maxVertex) : triangle);
+			}
+
+			for (int i = 0; i < CHECK_TRIANGLES_PER_BOX; i++)
+			{
+				const Triangle triangle = triangles.getTriangleAt(i);
+				scalarHits[i] = MathTools::IntersectBoxTriangle(minVertex, maxVertex, triangle) ? 1 : 0;
+				if (!isTouching && (scalarHits[i] != 0) != MathTools::Intersect(OBB, triangle))
+				{
+					referenceMismatches++;
+				}
+			}
+
+			batchHits.clear();
+			BatchTools::IntersectTriangles(triangles, minVertex, maxVertex, batchHits);
+			int nextBatchHit = 0;
+			for (int i = 0; i < CHECK_TRIANGLES_PER_BOX; i++)
+			{
+				const bool isBatchHit = nextBatchHit < static_cast<int>(batchHits.size()) && batchHits[nextBatchHit] == i;
+				nextBatchHit += isBatchHit ? 1 : 0;
+				batchMismatches += ((scalarHits[i] != 0) != isBatchHit) ? 1 : 0;
+			}
+			pairCount += CHECK_TRIANGLES_PER_BOX;
+		}
+
+		fprintf(stderr, "Box-triangle kernel check: %d pairs, %d batch mismatch(es), %d OBB test mismatch(es)\n",
+			pairCount, batchMismatches, referenceMismatches);
+		return batchMismatches == 0 && referenceMismatches == 0;
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// MathTools::Intersect between primitive volumes
+	//-------------------------------------------------------------------------------------------------------------------------
+	void RunPrimitiveBenchmarks(BenchmarkRunner& runner)
+	{
+		VolumeGenerator generator(1726);
+
+		// Volumes of size 0.5 to 2 in a box of 8, roughly balances hits and misses
+		const Vect min(-4.0f, -4.0f, -4.0f);
+		const Vect max(4.0f, 4.0f, 4.0f);
+		const float minSize = 0.5f;
+		const float maxSize = 2.0f;
+
+		auto BSphere = [&]() { return generator.BSphere(min, max, minSize, maxSize); };
+		auto AABB = [&]() { return generator.AABB(min, max, minSize, maxSize); };
+		auto OBB = [&]() { return generator.OBB(min, max, minSize, maxSize); };
+		auto point = [&]() { return generator.point(min, max); };
+		auto triangle = [&]() { return generator.triangle(min, max, minSize, maxSize); };
+
+		RunPairBenchmark<CollisionVolumeBSphere, CollisionVolumeBSphere>(runner, "MathTools/Intersect/BSphere-BSphere", BSphere, BSphere,
+			[](const CollisionVolumeBSphere& a, const CollisionVolumeBSphere& b) { return MathTools::Intersect(a, b); });
+		RunPairBenchmark<CollisionVolumeBSphere, CollisionVolumeAABB>(runner, "MathTools/Intersect/BSphere-AABB", BSphere, AABB,
+			[](const CollisionVolumeBSphere& a, const CollisionVolumeAABB& b) { return MathTools::Intersect(a, b); });
+		RunPairBenchmark<CollisionVolumeBSphere, CollisionVolumeOBB>(runner, "MathTools/Intersect/BSphere-OBB", BSphere, OBB,
+			[](const CollisionVolumeBSphere& a, const CollisionVolumeOBB& b) { return MathTools::Intersect(a, b); });
+		RunPairBenchmark<CollisionVolumeAABB, CollisionVolumeAABB>(runner, "MathTools/Intersect/AABB-AABB", AABB, AABB,
+			[](const CollisionVolumeAABB& a, const CollisionVolumeAABB& b) { return MathTools::Intersect(a, b); });
+		RunPairBenchmark<CollisionVolumeAABB, CollisionVolumeOBB>(runner, "MathTools/Intersect/AABB-OBB", AABB, OBB,
+			[](const CollisionVolumeAABB& a, const CollisionVolumeOBB& b) { return MathTools::Intersect(a, b); });
+		RunPairBenchmark<CollisionVolumeOBB, CollisionVolumeOBB>(runner, "MathTools/Intersect/OBB-OBB", OBB, OBB,
+			[](const CollisionVolumeOBB& a, const CollisionVolumeOBB& b) { return MathTools::Intersect(a, b); });
+		RunPairBenchmark<CollisionVolumeAABB, Vect>(runner, "MathTools/Intersect/AABB-Point", AABB, point,
+			[](const CollisionVolumeAABB& a, const Vect& b) { return MathTools::Intersect(a, b); });
+		RunPairBenchmark<CollisionVolumeOBB, Vect>(runner, "MathTools/Intersect/OBB-Point", OBB, point,
+			[](const CollisionVolumeOBB& a, const Vect& b) { return MathTools::Intersect(a, b); });
+
+		// Box-triangle separating axis test (used to filter the Octree nodes)
+		RunPairBenchmark<CollisionVolumeOBB, Triangle>(runner, "MathTools/Intersect/OBB-Triangle", OBB, triangle,
+			[](const CollisionVolumeOBB& a, const Triangle& b) { return MathTools::Intersect(a, b); });
+		RunPairBenchmark<CollisionVolumeAABB, Triangle>(runner, "MathTools/IntersectBoxTriangle/AABB-Triangle", AABB, triangle,
+			[](const CollisionVolumeAABB& a, const Triangle& b) { return MathTools::IntersectBoxTriangle(a.getMinWorldVertex(), a.getMaxWorldVertex(), b); });
+
+		// One box against a batch of triangles (the adaptive Octree build's octant test), scalar then batched
+		const std::string scalarBatchName = "MathTools/IntersectBoxTriangle/batch";
+		const std::string batchName = "BatchTools/IntersectTriangles/batch";
+		if (runner.isSelected(scalarBatchName) || runner.isSelected(batchName))
+		{
+			const CollisionVolumeAABB box = AABB();
+			TriangleBatch triangles;
+			for (int i = 0; i < CASE_COUNT; i++)
+			{
+				triangles.add(triangle());
+			}
+
+			BatchTools::IndexCollection hits;
+			BenchmarkResult* pScalarResult = runner.run(scalarBatchName, [&](long long)
+			{
+				hits.clear();
+				for (int i = 0; i < CASE_COUNT; i++)
+				{
+					if (MathTools::IntersectBoxTriangle(box.getMinWorldVertex(), box.getMaxWorldVertex(), triangles.getTriangleAt(i)))
+					{
+						hits.push_back(i);
+					}
+				}
+			});
+			BenchmarkResult* pBatchResult = runner.run(batchName, [&](long long)
+			{
+				hits.clear();
+				BatchTools::IntersectTriangles(triangles, box.getMinWorldVertex(), box.getMaxWorldVertex(), hits);
+			});
+
+			for (BenchmarkResult* pResult : { pScalarResult, pBatchResult })
+			{
+				if (pResult != nullptr)
+				{
+					pResult->metrics.push_back(std::make_pair("triangles", CASE_COUNT));
+					pResult->metrics.push_back(std::make_pair("hits", static_cast<double>(hits.size())));
+				}
+			}
+		}
+
+		// Dispatch on the volume types, over an even mix of BSphere, AABB and OBB
+		if (runner.isSelected("MathTools/Intersect/CollisionVolume-CollisionVolume"))
+		{
+			const int poolSize = 3 * CASE_COUNT;
+			std::vector<CollisionVolumeBSphere> BSpheres; BSpheres.reserve(poolSize);
+			std::vector<CollisionVolumeAABB> AABBs; AABBs.reserve(poolSize);
+			std::vector<CollisionVolumeOBB> OBBs; OBBs.reserve(poolSize);
+
+			// Volumes are copied into stable storage (the generated cases keep pointers)
+			int nextVolume = 0;
+			auto mixedVolume = [&]() -> const CollisionVolume*
+			{
+				const int volumeIndex = nextVolume++;
+				switch (volumeIndex % 3)
+				{
+				case 0:
+					BSpheres.push_back(BSphere());
+					return &BSpheres.back();
+				case 1:
+					AABBs.push_back(AABB());
+					return &AABBs.back();
+				default:
+					OBBs.push_back(OBB());
+					return &OBBs.back();
+				}
+			};
+
+			// Cap the attempts to the reserved storage
+			auto test = [](const CollisionVolume* a, const CollisionVolume* b) { return MathTools::Intersect(*a, *b); };
+			PairCases<const CollisionVolume*, const CollisionVolume*> hits;
+			PairCases<const CollisionVolume*, const CollisionVolume*> misses;
+			while ((hits.getSize() < CASE_COUNT || misses.getSize() < CASE_COUNT) && nextVolume + 2 <= 3 * poolSize)
+			{
+				const CollisionVolume* pFirst = mixedVolume();
+				const CollisionVolume* pSecond = mixedVolume();
+				PairCases<const CollisionVolume*, const CollisionVolume*>& cases = test(pFirst, pSecond) ? hits : misses;
+				if (cases.getSize() < CASE_COUNT)
+				{
+					cases.first.push_back(pFirst);
+					cases.second.push_back(pSecond);
+				}
+			}
+
+			RunCases(runner, "MathTools/Intersect/CollisionVolume-CollisionVolume/hit", hits, test);
+			RunCases(runner, "MathTools/Intersect/CollisionVolume-CollisionVolume/miss", misses, test);
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Octree build
+	//-------------------------------------------------------------------------------------------------------------------------
+	struct NamedModel
+	{
+		std::string name;
+		std::unique_ptr<Model> pModel;
+
+		// Frame its Octrees are built in (a fitted model has its own copy: Octree Models are
+		// cached per model)
+		OctreeTools::FrameMode frameMode;
+	};
+
+	typedef std::vector<NamedModel> NamedModelCollection;
+
+	NamedModelCollection CreateModels()
+	{
+		NamedModelCollection models;
+		const OctreeTools::FrameMode modelFrame = OctreeTools::FrameMode::MODEL;
+		models.push_back({ "sphere", std::unique_ptr<Model>(ProceduralMeshes::CreateSphere(16, 32, 4.0f)), modelFrame });
+		models.push_back({ "torus", std::unique_ptr<Model>(ProceduralMeshes::CreateTorus(32, 12, 4.0f, 1.5f)), modelFrame });
+		models.push_back({ "terrain", std::unique_ptr<Model>(ProceduralMeshes::CreateNoisyTerrain(20, 16.0f, 1.5f, 1726)), modelFrame });
+
+		// The terrain tilted about two axes (its AABB is mostly empty), then built in a fitted frame
+		const Matrix tilt = Matrix(ROT_AXIS_ANGLE, Vect(1.0f, 0.0f, 1.0f), 0.6f);
+		const Model& terrain = *models.back().pModel;
+		models.push_back({ "terrain-tilted", std::unique_ptr<Model>(ProceduralMeshes::CreateTransformed(terrain, tilt)), modelFrame });
+		models.push_back({ "terrain-tilted-fitted", std::unique_ptr<Model>(ProceduralMeshes::CreateTransformed(terrain, tilt)), OctreeTools::FrameMode::FITTED });
+		return models;
+	}
+
+	void RunBuildBenchmarks(BenchmarkRunner& runner, const NamedModelCollection& models, int maxDepth)
+	{
+		for (const NamedModel& namedModel : models)
+		{
+			for (int depth = MIN_BUILD_DEPTH; depth <= maxDepth; depth++)
+			{
+				for (OctreeTools::BuildMode buildMode : { OctreeTools::BuildMode::UNIFORM, OctreeTools::BuildMode::ADAPTIVE })
+				{
+					const bool isAdaptive = (buildMode == OctreeTools::BuildMode::ADAPTIVE);
+					const std::string name = std::string(isAdaptive ? "OctreeBuilder/buildOctreeAdaptive/" : "OctreeBuilder/buildOctree/")
+						+ namedModel.name + "/d" + std::to_string(depth);
+
+					OctreeBuilder builder;
+					builder.setFrameMode(namedModel.frameMode);
+					const OctreeAdaptiveCriteria criteria;
+					int validNodes = 0;
+					int arenaNodes = 0;
+					BenchmarkResult* pResult = runner.run(name, [&](long long)
+					{
+						OctreeNodeArena* pArena = isAdaptive ? builder.buildOctreeAdaptive(namedModel.pModel.get(), depth, criteria)
+							: builder.buildOctree(namedModel.pModel.get(), depth);
+						validNodes = pArena->getRoot()->getSize() + 1;
+						arenaNodes = pArena->getSize();
+						delete pArena;
+					});
+
+					if (pResult != nullptr)
+					{
+						pResult->metrics.push_back(std::make_pair("triangles", namedModel.pModel->getTriNum()));
+						pResult->metrics.push_back(std::make_pair("arena_nodes", arenaNodes));
+						pResult->metrics.push_back(std::make_pair("valid_nodes", validNodes));
+
+						// Volume where a query is reported colliding, measured outside the timed builds
+						OctreeNodeArena* pArena = isAdaptive ? builder.buildOctreeAdaptive(namedModel.pModel.get(), depth, criteria)
+							: builder.buildOctree(namedModel.pModel.get(), depth);
+						pResult->metrics.push_back(std::make_pair("valid_leaf_volume", builder.measureOctree(*pArena, depth).validLeafVolume));
+						delete pArena;
+					}
+				}
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Octree queries
+	//-------------------------------------------------------------------------------------------------------------------------
+	void RunOctreeQueryBenchmarks(BenchmarkRunner& runner, const NamedModelCollection& models)
+	{
+		VolumeGenerator generator(2619);
+
+		const Matrix octreeWorld = Matrix(ROT_AXIS_ANGLE, Vect(1.0f, 1.0f, 0.0f), 0.4f);
+
+		for (const NamedModel& namedModel : models)
+		{
+			for (OctreeTools::BuildMode buildMode : { OctreeTools::BuildMode::UNIFORM, OctreeTools::BuildMode::ADAPTIVE })
+			{
+				const std::string prefix = "MathTools/Intersect/";
+				const std::string suffix = "/" + namedModel.name + "-d" + std::to_string(QUERY_DEPTH)
+					+ ((buildMode == OctreeTools::BuildMode::ADAPTIVE) ? "-adaptive" : "");
+
+				Model* pModel = namedModel.pModel.get();
+				OctreeModelManager::SetFrameMode(namedModel.frameMode);
+				CollisionVolumeOctree octree(pModel, QUERY_DEPTH, buildMode);
+				octree.computeData(pModel, octreeWorld);
+
+				// Query volumes are spread around the world bounds of the model
+				const Vect margin(1.0f, 1.0f, 1.0f);
+				CollisionVolumeAABB worldBounds;
+				worldBounds.computeData(pModel->getMinAABB(), pModel->getMaxAABB(), octreeWorld);
+				const Vect min = worldBounds.getMinWorldVertex() - margin;
+				const Vect max = worldBounds.getMaxWorldVertex() + margin;
+				const float minSize = 0.3f;
+				const float maxSize = 1.2f;
+
+				const CollisionVolumeOctree* pOctree = &octree;
+				auto theOctree = [pOctree]() { return pOctree; };
+				auto BSphere = [&]() { return generator.BSphere(min, max, minSize, maxSize); };
+				auto AABB = [&]() { return generator.AABB(min, max, minSize, maxSize); };
+				auto OBB = [&]() { return generator.OBB(min, max, minSize, maxSize); };
+
+				RunPairBenchmark<const CollisionVolumeOctree*, CollisionVolumeBSphere>(runner, prefix + "BSphere-Octree" + suffix, theOctree, BSphere,
+					[](const CollisionVolumeOctree* pOctree, const CollisionVolumeBSphere& volume) { return MathTools::Intersect(volume, *pOctree); });
+				RunPairBenchmark<const CollisionVolumeOctree*, CollisionVolumeAABB>(runner, prefix + "AABB-Octree" + suffix, theOctree, AABB,
+					[](const CollisionVolumeOctree* pOctree, const CollisionVolumeAABB& volume) { return MathTools::Intersect(volume, *pOctree); });
+				RunPairBenchmark<const CollisionVolumeOctree*, CollisionVolumeOBB>(runner, prefix + "OBB-Octree" + suffix, theOctree, OBB,
+					[](const CollisionVolumeOctree* pOctree, const CollisionVolumeOBB& volume) { return MathTools::Intersect(volume, *pOctree); });
+
+				// Dispatch on the volume type (the path taken by the narrow phase)
+				RunPairBenchmark<const CollisionVolumeOctree*, CollisionVolumeOBB>(runner, prefix + "CollisionVolume-Octree" + suffix, theOctree, OBB,
+					[](const CollisionVolumeOctree* pOctree, const CollisionVolumeOBB& volume) { return MathTools::Intersect(static_cast<const CollisionVolume&>(volume), *pOctree); });
+
+				// Octree-Octree: copies of the same Octree model placed around this one
+				const std::string octreeName = prefix + "Octree-Octree" + suffix;
+				if (runner.isSelected(octreeName))
+				{
+					const int instanceCount = 256;
+					std::vector<std::unique_ptr<CollisionVolumeOctree>> instances;
+					for (int i = 0; i < instanceCount; i++)
+					{
+						const float spread = 1.5f * pModel->getRadius();
+						const Vect offset = generator.point(Vect(-spread, -spread, -spread), Vect(spread, spread, spread));
+
+						instances.emplace_back(new CollisionVolumeOctree(pModel, QUERY_DEPTH, buildMode));
+						instances.back()->computeData(pModel, generator.rotation() * Matrix(TRANS, offset));
+					}
+
+					int nextInstance = 0;
+					auto instance = [&]() { return instances[nextInstance++ % instanceCount].get(); };
+					RunPairBenchmark<const CollisionVolumeOctree*, const CollisionVolumeOctree*>(runner, octreeName, theOctree, instance,
+						[](const CollisionVolumeOctree* pOctree_1, const CollisionVolumeOctree* pOctree_2) { return MathTools::Intersect(*pOctree_1, *pOctree_2); },
+						instanceCount);
+				}
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	// The Octree builder traces every build
+	Trace::SetEnabled(false);
+
+	// Timings of kernels that disagree are meaningless
+	if (!CheckBoxTriangleKernels()) return EXIT_FAILURE;
+	if (options.isCheckOnly) return EXIT_SUCCESS;
+
+	BenchmarkRunner runner(options.minTimeSeconds, options.filter);
+	{
+		const NamedModelCollection models = CreateModels();
+
+		RunPrimitiveBenchmarks(runner);
+		RunOctreeQueryBenchmarks(runner, models);
+		RunBuildBenchmarks(runner, models, options.maxBuildDepth);
+	}
+	OctreeModelManager::Delete();
+
+	BenchmarkResult::MetricCollection configuration;
+	configuration.push_back(std::make_pair("case_count", CASE_COUNT));
+	configuration.push_back(std::make_pair("query_depth", QUERY_DEPTH));
+	configuration.push_back(std::make_pair("max_build_depth", options.maxBuildDepth));
+#if defined(__AVX__)
+	configuration.push_back(std::make_pair("avx", 1));
+#else
+	configuration.push_back(std::make_pair("avx", 0));
+#endif
+
+	FILE* pFile = options.outputPath.empty() ? stdout : fopen(options.outputPath.c_str(), "w");
+	if (pFile == nullptr)
+	{
+		fprintf(stderr, "Cannot open %s\n", options.outputPath.c_str());
+		return EXIT_FAILURE;
+	}
+	runner.writeJson(pFile, "CollisionBenchmark", configuration);
+	if (pFile != stdout)
+	{
+		fclose(pFile);
+	}
+
+	return EXIT_SUCCESS;
+}
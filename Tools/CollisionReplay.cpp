@@ -0,0 +1,720 @@
+#include "ToolCollidables.h"
+
+#include "CollisionManager.h"
+#include "CollisionRecorder.h"
+#include "CollisionStats.h"
+#include "CollisionTimeline.h"
+#include "OctreeModelManager.h"
+#include "Scene.h"
+#include "SceneManager.h"
+#include "AzulCore.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Replays a CollisionRecorder log through a CollisionManager at full speed. Reports the time of
+// every frame and checks its collision pairs against the recorded checksum.
+// Usage: CollisionReplay <log> [--repeat count] [--spikes count] [--json file] [--trace file]
+//-----------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+	typedef CollisionRecorder::RecordID RecordID;
+	typedef CollisionRecorder::RecordType RecordType;
+
+	const int STAGE_COUNT = static_cast<int>(CollisionFrameStats::Stage::COUNT);
+
+	struct Options
+	{
+		std::string logPath;
+		int repeat = 1;
+		int spikes = 10;
+		std::string jsonPath;
+		std::string tracePath;
+	};
+
+	void PrintUsage()
+	{
+		fprintf(stderr,
+			"Usage: CollisionReplay <log> [options]\n"
+			"  --repeat <count>  Replays the log several times, keeps the fastest time of each frame (default: 1)\n"
+			"  --spikes <count>  Number of slowest frames listed (default: 10)\n"
+			"  --json <file>     Also write the time and checksum of every frame as JSON\n"
+			"  --trace <file>    Write the collision timeline of the last pass as Chrome trace JSON\n");
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const bool hasValue = (i + 1 < argc);
+			if (strcmp(argv[i], "--repeat") == 0 && hasValue)
+			{
+				options.repeat = atoi(argv[++i]);
+			}
+			else if (strcmp(argv[i], "--spikes") == 0 && hasValue)
+			{
+				options.spikes = atoi(argv[++i]);
+			}
+			else if (strcmp(argv[i], "--json") == 0 && hasValue)
+			{
+				options.jsonPath = argv[++i];
+			}
+			else if (strcmp(argv[i], "--trace") == 0 && hasValue)
+			{
+				options.tracePath = argv[++i];
+			}
+			else if (argv[i][0] != '-' && options.logPath.empty())
+			{
+				options.logPath = argv[i];
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return !options.logPath.empty() && options.repeat >= 1 && options.spikes >= 0;
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Log reading
+	//-------------------------------------------------------------------------------------------------------------------------
+	class LogReader
+	{
+	public:
+		explicit LogReader(std::vector<unsigned char>&& bytes)
+			: _bytes(std::move(bytes)), _offset(0), _isValid(true)
+		{}
+
+		template <typename Value>
+		Value read()
+		{
+			Value value = Value();
+			if (_offset + sizeof(Value) > _bytes.size())
+			{
+				_isValid = false;
+				return value;
+			}
+			memcpy(&value, _bytes.data() + _offset, sizeof(Value));
+			_offset += sizeof(Value);
+			return value;
+		}
+
+		Matrix readMatrix()
+		{
+			Vect rows[4];
+			for (int row = 0; row < 4; row++)
+			{
+				const float rowX = read<float>();
+				const float rowY = read<float>();
+				const float rowZ = read<float>();
+				rows[row] = Vect(rowX, rowY, rowZ, row == 3 ? 1.0f : 0.0f);
+			}
+			return Matrix(rows[0], rows[1], rows[2], rows[3]);
+		}
+
+		bool isAtEnd() const
+		{
+			return _offset >= _bytes.size();
+		}
+
+		bool isValid() const
+		{
+			return _isValid;
+		}
+
+		void rewind(size_t offset)
+		{
+			_offset = offset;
+		}
+
+		size_t getOffset() const
+		{
+			return _offset;
+		}
+
+	private:
+		std::vector<unsigned char> _bytes;
+		size_t _offset;
+		bool _isValid;
+	};
+
+	bool LoadLog(const char* path, std::vector<unsigned char>& bytes)
+	{
+		FILE* pFile = fopen(path, "rb");
+		if (pFile == nullptr) return false;
+
+		unsigned char chunk[1 << 16];
+		size_t size;
+		while ((size = fread(chunk, 1, sizeof(chunk), pFile)) > 0)
+		{
+			bytes.insert(bytes.end(), chunk, chunk + size);
+		}
+		fclose(pFile);
+		return true;
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Replay
+	//-------------------------------------------------------------------------------------------------------------------------
+	/**********************************************************************************************//**
+	 * <summary> A recorded frame and its replay.</summary>
+	 **************************************************************************************************/
+	struct FrameResult
+	{
+		unsigned int frame = 0;
+
+		float recordedStageSeconds[STAGE_COUNT] = {};
+		unsigned int recordedNarrowPhaseTests = 0;
+		CollisionPairChecksum recordedChecksum;
+
+		// Fastest replay of the frame
+		double updateSeconds = 0.0;
+		double stageSeconds[STAGE_COUNT] = {};
+		double totalSeconds = 0.0;
+		unsigned int narrowPhaseTests = 0;
+		CollisionPairChecksum checksum;
+
+		bool isMatching() const
+		{
+			return checksum.count == recordedChecksum.count && checksum.sum == recordedChecksum.sum;
+		}
+
+		double getRecordedTotalSeconds() const
+		{
+			double totalSeconds = 0.0;
+			for (float seconds : recordedStageSeconds)
+			{
+				totalSeconds += seconds;
+			}
+			return totalSeconds;
+		}
+	};
+
+	/**********************************************************************************************//**
+	 * <summary> Feeds one pass of a log through a new Scene.</summary>
+	 *
+	 * <remarks> Recorded collision types are mapped to GroupCollidable types in the order they
+	 *			 appear. Terrain commands are not replayed. </remarks>
+	 **************************************************************************************************/
+	class LogReplay
+	{
+	private:
+		typedef std::unordered_map<RecordID, Model*> ModelMap;
+		typedef std::unordered_map<RecordID, ToolCollidable*> CollidableMap;
+		typedef std::unordered_map<int, int> GroupMap;
+
+	public:
+		LogReplay()
+			: _pScene(new Scene()), _skippedTerrainCommands(0)
+		{
+			SceneManager::SetCurrentScene(_pScene);
+		}
+
+		LogReplay(const LogReplay&) = delete;
+		LogReplay& operator=(const LogReplay&) = delete;
+		LogReplay(LogReplay&&) = delete;
+		LogReplay& operator=(LogReplay&&) = delete;
+
+		~LogReplay()
+		{
+			CollisionManager& collisionManager = _pScene->getCollisionManager();
+
+			std::vector<Collidable*> collidables;
+			for (const CollidableMap::value_type& entry : _collidables)
+			{
+				collidables.push_back(entry.second);
+			}
+			collisionManager.submitDeregistrations(collidables.data(), collidables.size());
+			collisionManager.processCollisions();
+
+			for (Collidable* pCollidable : collidables)
+			{
+				delete pCollidable;
+			}
+			SceneManager::SetCurrentScene(nullptr);
+			delete _pScene;
+
+			for (const ModelMap::value_type& entry : _models)
+			{
+				delete entry.second;
+			}
+		}
+
+		// Replays every frame, keeping the fastest time of each in results (filled on the first pass)
+		bool run(LogReader& reader, std::vector<FrameResult>& results, bool isFirstPass)
+		{
+			size_t frameIndex = 0;
+			while (!reader.isAtEnd())
+			{
+				FrameResult frameResult;
+				if (!replayFrame(reader, frameResult)) return false;
+
+				if (isFirstPass)
+				{
+					results.push_back(frameResult);
+				}
+				else if (frameIndex < results.size())
+				{
+					keepFastest(results[frameIndex], frameResult);
+				}
+				frameIndex++;
+			}
+			return true;
+		}
+
+		unsigned int getSkippedTerrainCommands() const
+		{
+			return _skippedTerrainCommands;
+		}
+
+	private:
+		bool replayFrame(LogReader& reader, FrameResult& frameResult)
+		{
+			CollisionManager& collisionManager = _pScene->getCollisionManager();
+
+			_registrations.clear();
+			_deregistrations.clear();
+			_moved.clear();
+			_worlds.clear();
+
+			// Records up to (and including) the FRAME record
+			for (;;)
+			{
+				const RecordType recordType = reader.read<RecordType>();
+				if (!reader.isValid()) return false;
+
+				if (recordType == RecordType::FRAME)
+				{
+					frameResult.frame = reader.read<unsigned int>();
+					for (float& seconds : frameResult.recordedStageSeconds)
+					{
+						seconds = reader.read<float>();
+					}
+					frameResult.recordedNarrowPhaseTests = reader.read<unsigned int>();
+					frameResult.recordedChecksum.count = reader.read<unsigned int>();
+					frameResult.recordedChecksum.sum = reader.read<unsigned long long>();
+					break;
+				}
+
+				if (!readRecord(reader, recordType)) return false;
+			}
+			if (!reader.isValid()) return false;
+
+			collisionManager.submitDeregistrations(_deregistrations.data(), _deregistrations.size());
+			collisionManager.submitRegistrations(_registrations.data(), _registrations.size());
+			_checksum.reset();
+
+			// Same work as the recording: the moves, then processCollisions()
+			const Clock::time_point updateStart = Clock::now();
+			collisionManager.updateCollisionData(_moved.data(), _worlds.data(), _moved.size());
+			const double updateSeconds = std::chrono::duration<double>(Clock::now() - updateStart).count();
+
+			collisionManager.processCollisions();
+
+			const CollisionFrameStats& frameStats = collisionManager.getLastFrameStats();
+			frameResult.updateSeconds = updateSeconds;
+			for (int stage = 0; stage < STAGE_COUNT; stage++)
+			{
+				frameResult.stageSeconds[stage] = frameStats.stageSeconds[stage];
+			}
+			frameResult.totalSeconds = updateSeconds + frameStats.getTotalSeconds();
+			frameResult.narrowPhaseTests = frameStats.narrowPhaseTests;
+			frameResult.checksum = _checksum;
+
+			for (Collidable* pCollidable : _deregistrations)
+			{
+				delete pCollidable;
+			}
+
+			return true;
+		}
+
+		bool readRecord(LogReader& reader, RecordType recordType)
+		{
+			switch (recordType)
+			{
+			case RecordType::MODEL:
+				return readModel(reader);
+			case RecordType::COMMAND:
+				return readCommand(reader);
+			case RecordType::REGISTRATION:
+				return readRegistration(reader);
+			case RecordType::DEREGISTRATION:
+			{
+				const RecordID collidableID = reader.read<RecordID>();
+				const CollidableMap::iterator it = _collidables.find(collidableID);
+				if (it != _collidables.end())
+				{
+					_deregistrations.push_back(it->second);
+					_collidables.erase(it);
+				}
+				return reader.isValid();
+			}
+			case RecordType::MOVE:
+			{
+				const RecordID collidableID = reader.read<RecordID>();
+				const Matrix world = reader.readMatrix();
+				// Collidables not registered yet get their world with their registration
+				const CollidableMap::iterator it = _collidables.find(collidableID);
+				if (it != _collidables.end())
+				{
+					_moved.push_back(it->second);
+					_worlds.push_back(world);
+				}
+				return reader.isValid();
+			}
+			default:
+				fprintf(stderr, "Unknown record type %d\n", static_cast<int>(recordType));
+				return false;
+			}
+		}
+
+		bool readModel(LogReader& reader)
+		{
+			const RecordID modelID = reader.read<RecordID>();
+
+			const unsigned int vectCount = reader.read<unsigned int>();
+			std::vector<Vect> vects(vectCount);
+			for (Vect& vect : vects)
+			{
+				const float vectX = reader.read<float>();
+				const float vectY = reader.read<float>();
+				const float vectZ = reader.read<float>();
+				vect = Vect(vectX, vectY, vectZ);
+			}
+
+			const unsigned int triangleCount = reader.read<unsigned int>();
+			std::vector<TriangleIndex> triangles(triangleCount);
+			for (TriangleIndex& triangle : triangles)
+			{
+				triangle.v0 = reader.read<unsigned int>();
+				triangle.v1 = reader.read<unsigned int>();
+				triangle.v2 = reader.read<unsigned int>();
+			}
+			if (!reader.isValid()) return false;
+
+			_models[modelID] = new Model(vects.data(), static_cast<int>(vectCount), triangles.data(), static_cast<int>(triangleCount));
+			return true;
+		}
+
+		bool readCommand(LogReader& reader)
+		{
+			const CollisionRecorder::CommandType commandType = reader.read<CollisionRecorder::CommandType>();
+			const int collisionTypeID_1 = reader.read<int>();
+			const int collisionTypeID_2 = reader.read<int>();
+			if (!reader.isValid()) return false;
+
+			CollisionManager& collisionManager = _pScene->getCollisionManager();
+			switch (commandType)
+			{
+			case CollisionRecorder::CommandType::SELF:
+			{
+				const int groupIndex = getGroupIndex(collisionTypeID_1);
+				if (groupIndex < 0) return false;
+				ToolCollidables::SetCollisionSelf(collisionManager, groupIndex);
+				return true;
+			}
+			case CollisionRecorder::CommandType::PAIR:
+			{
+				const int groupIndex_1 = getGroupIndex(collisionTypeID_1);
+				const int groupIndex_2 = getGroupIndex(collisionTypeID_2);
+				if (groupIndex_1 < 0 || groupIndex_2 < 0) return false;
+				ToolCollidables::SetCollisionPair(collisionManager, groupIndex_1, groupIndex_2);
+				return true;
+			}
+			default:
+				_skippedTerrainCommands++;
+				return true;
+			}
+		}
+
+		bool readRegistration(LogReader& reader)
+		{
+			const RecordID collidableID = reader.read<RecordID>();
+			const int collisionTypeID = reader.read<int>();
+			const CollisionVolume::Type volumeType = reader.read<CollisionVolume::Type>();
+			const int octreeDepth = reader.read<unsigned char>();
+			const OctreeTools::BuildMode octreeBuildMode = reader.read<OctreeTools::BuildMode>();
+			const bool isStatic = reader.read<unsigned char>() != 0;
+			const RecordID modelID = reader.read<RecordID>();
+			const bool hasWorld = reader.read<unsigned char>() != 0;
+			const Matrix world = hasWorld ? reader.readMatrix() : Matrix(IDENTITY);
+			if (!reader.isValid()) return false;
+
+			const ModelMap::const_iterator model = _models.find(modelID);
+			const int groupIndex = getGroupIndex(collisionTypeID);
+			if (model == _models.end() || groupIndex < 0 || volumeType >= CollisionVolume::Type::COUNT
+				|| (volumeType == CollisionVolume::Type::OCTREE && (octreeDepth < 1 || octreeDepth > OctreeTools::MAX_DEPTH || octreeBuildMode > OctreeTools::BuildMode::ADAPTIVE))) return false;
+
+			ToolCollidable* pCollidable = ToolCollidables::Create(groupIndex, model->second, volumeType, octreeDepth, octreeBuildMode, isStatic);
+			pCollidable->setRecordID(collidableID, &_checksum);
+			_collidables[collidableID] = pCollidable;
+			_registrations.push_back(pCollidable);
+
+			if (hasWorld)
+			{
+				_moved.push_back(pCollidable);
+				_worlds.push_back(world);
+			}
+			return true;
+		}
+
+		int getGroupIndex(int collisionTypeID)
+		{
+			const GroupMap::const_iterator it = _groups.find(collisionTypeID);
+			if (it != _groups.end()) return it->second;
+
+			const int groupIndex = static_cast<int>(_groups.size());
+			if (groupIndex >= ToolCollidables::MAX_GROUPS)
+			{
+				fprintf(stderr, "The log uses more than %d collision types\n", ToolCollidables::MAX_GROUPS);
+				return -1;
+			}
+			_groups[collisionTypeID] = groupIndex;
+			return groupIndex;
+		}
+
+		static void keepFastest(FrameResult& fastest, const FrameResult& replayed)
+		{
+			// Mismatches of any pass are kept
+			if (!replayed.isMatching())
+			{
+				fastest.checksum = replayed.checksum;
+			}
+
+			if (replayed.totalSeconds >= fastest.totalSeconds) return;
+
+			fastest.updateSeconds = replayed.updateSeconds;
+			for (int stage = 0; stage < STAGE_COUNT; stage++)
+			{
+				fastest.stageSeconds[stage] = replayed.stageSeconds[stage];
+			}
+			fastest.totalSeconds = replayed.totalSeconds;
+		}
+
+	private:
+		Scene* _pScene;
+
+		ModelMap _models;
+		CollidableMap _collidables;
+		GroupMap _groups;
+
+		// Current frame
+		std::vector<Collidable*> _registrations;
+		std::vector<Collidable*> _deregistrations;
+		std::vector<Collidable*> _moved;
+		std::vector<Matrix> _worlds;
+		CollisionPairChecksum _checksum;
+
+		unsigned int _skippedTerrainCommands;
+	};
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Report
+	//-------------------------------------------------------------------------------------------------------------------------
+	const char* const STAGE_NAMES[] = { "registration", "group_update", "broad_phase", "narrow_phase" };
+	static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<size_t>(STAGE_COUNT), "One name per stage");
+
+	double GetPercentile(std::vector<double> values, double percentile)
+	{
+		if (values.empty()) return 0.0;
+		std::sort(values.begin(), values.end());
+		const size_t index = static_cast<size_t>(percentile * (values.size() - 1) + 0.5);
+		return values[index];
+	}
+
+	void PrintSummary(const std::vector<FrameResult>& results, int spikes)
+	{
+		std::vector<double> replayed;
+		std::vector<double> recorded;
+		unsigned int mismatches = 0;
+		for (const FrameResult& result : results)
+		{
+			replayed.push_back(1000.0 * result.totalSeconds);
+			recorded.push_back(1000.0 * result.getRecordedTotalSeconds());
+			if (!result.isMatching()) mismatches++;
+		}
+
+		printf("%u frame(s), %u checksum mismatch(es)\n", static_cast<unsigned int>(results.size()), mismatches);
+		printf("%-10s %10s %10s %10s %10s %10s\n", "ms/frame", "mean", "p50", "p95", "p99", "max");
+		const std::vector<double>* series[] = { &replayed, &recorded };
+		const char* names[] = { "replayed", "recorded" };
+		for (int i = 0; i < 2; i++)
+		{
+			double sum = 0.0;
+			for (double value : *series[i])
+			{
+				sum += value;
+			}
+			printf("%-10s %10.3f %10.3f %10.3f %10.3f %10.3f\n", names[i],
+				series[i]->empty() ? 0.0 : sum / series[i]->size(),
+				GetPercentile(*series[i], 0.50), GetPercentile(*series[i], 0.95),
+				GetPercentile(*series[i], 0.99), GetPercentile(*series[i], 1.0));
+		}
+
+		// Slowest replayed frames, with the stage that took the time
+		std::vector<size_t> order(results.size());
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+		const size_t spikeCount = std::min(order.size(), static_cast<size_t>(spikes));
+		std::partial_sort(order.begin(), order.begin() + spikeCount, order.end(),
+			[&results](size_t a, size_t b) { return results[a].totalSeconds > results[b].totalSeconds; });
+
+		if (spikeCount > 0)
+		{
+			printf("\nSlowest frames (ms)\n%8s %9s %9s %9s %9s %9s %9s %9s %10s %10s %6s\n",
+				"frame", "replayed", "recorded", "update", "registr.", "groups", "broad", "narrow", "narrow pr", "pairs", "match");
+		}
+		for (size_t i = 0; i < spikeCount; i++)
+		{
+			const FrameResult& result = results[order[i]];
+			printf("%8u %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f %10u %10u %6s\n",
+				result.frame, 1000.0 * result.totalSeconds, 1000.0 * result.getRecordedTotalSeconds(), 1000.0 * result.updateSeconds,
+				1000.0 * result.stageSeconds[0], 1000.0 * result.stageSeconds[1], 1000.0 * result.stageSeconds[2], 1000.0 * result.stageSeconds[3],
+				result.narrowPhaseTests, result.checksum.count, result.isMatching() ? "yes" : "NO");
+		}
+
+		if (mismatches > 0)
+		{
+			printf("\nMismatching frames (recorded pairs / replayed pairs)\n");
+			unsigned int printed = 0;
+			for (const FrameResult& result : results)
+			{
+				if (result.isMatching()) continue;
+				printf("%8u %10u %10u\n", result.frame, result.recordedChecksum.count, result.checksum.count);
+				if (++printed == 20) break;
+			}
+		}
+	}
+
+	void WriteJson(FILE* pFile, const Options& options, const std::vector<FrameResult>& results)
+	{
+		fprintf(pFile, "{\n  \"suite\": \"CollisionReplay\",\n  \"log\": \"%s\",\n  \"repeat\": %d,\n  \"frames\": [",
+			options.logPath.c_str(), options.repeat);
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const FrameResult& result = results[i];
+			fprintf(pFile, "%s\n    {\"frame\": %u, \"replayed_ms\": %.9g, \"recorded_ms\": %.9g, \"update_ms\": %.9g",
+				i == 0 ? "" : ",", result.frame, 1000.0 * result.totalSeconds, 1000.0 * result.getRecordedTotalSeconds(),
+				1000.0 * result.updateSeconds);
+			for (int stage = 0; stage < STAGE_COUNT; stage++)
+			{
+				fprintf(pFile, ", \"%s_ms\": %.9g", STAGE_NAMES[stage], 1000.0 * result.stageSeconds[stage]);
+			}
+			fprintf(pFile, ", \"narrow_phase_tests\": %u, \"recorded_narrow_phase_tests\": %u, \"pairs\": %u, \"recorded_pairs\": %u, "
+				"\"checksum\": \"%016llx\", \"recorded_checksum\": \"%016llx\", \"match\": %s}",
+				result.narrowPhaseTests, result.recordedNarrowPhaseTests, result.checksum.count, result.recordedChecksum.count,
+				result.checksum.sum, result.recordedChecksum.sum, result.isMatching() ? "true" : "false");
+		}
+		fprintf(pFile, "\n  ]\n}\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	std::vector<unsigned char> bytes;
+	if (!LoadLog(options.logPath.c_str(), bytes))
+	{
+		fprintf(stderr, "Cannot open %s\n", options.logPath.c_str());
+		return EXIT_FAILURE;
+	}
+
+	LogReader reader(std::move(bytes));
+	if (reader.read<unsigned int>() != CollisionRecorder::FILE_MAGIC || reader.read<unsigned int>() != CollisionRecorder::FORMAT_VERSION)
+	{
+		fprintf(stderr, "%s is not a collision log of version %u\n", options.logPath.c_str(), CollisionRecorder::FORMAT_VERSION);
+		return EXIT_FAILURE;
+	}
+	const OctreeTools::FrameMode octreeFrameMode = reader.read<OctreeTools::FrameMode>();
+	if (!reader.isValid() || octreeFrameMode > OctreeTools::FrameMode::FITTED)
+	{
+		fprintf(stderr, "%s is truncated or corrupt (header)\n", options.logPath.c_str());
+		return EXIT_FAILURE;
+	}
+	const size_t firstRecord = reader.getOffset();
+
+	// The Octree builder traces every build
+	Trace::SetEnabled(false);
+
+	if (!options.tracePath.empty())
+	{
+		CollisionTimeline::SetThreadName("replay");
+		CollisionTimeline::SetEnabled(true);
+	}
+
+	std::vector<FrameResult> results;
+	for (int pass = 0; pass < options.repeat; pass++)
+	{
+		reader.rewind(firstRecord);
+		CollisionTimeline::Clear();
+
+		// Octrees are built in the frame they were recorded with
+		OctreeModelManager::SetFrameMode(octreeFrameMode);
+
+		bool isValid;
+		{
+			LogReplay replay;
+			isValid = replay.run(reader, results, pass == 0);
+			if (pass == 0 && replay.getSkippedTerrainCommands() > 0)
+			{
+				printf("Skipped %u terrain command(s)\n", replay.getSkippedTerrainCommands());
+			}
+		}
+
+		// Octree models are cached by address, the next pass creates new models
+		OctreeModelManager::Delete();
+
+		if (!isValid)
+		{
+			fprintf(stderr, "%s is truncated or corrupt (after %u frame(s))\n", options.logPath.c_str(), static_cast<unsigned int>(results.size()));
+			return EXIT_FAILURE;
+		}
+	}
+
+	PrintSummary(results, options.spikes);
+
+	if (!options.tracePath.empty())
+	{
+		CollisionTimeline::SetEnabled(false);
+		if (!CollisionTimeline::WriteChromeTrace(options.tracePath.c_str()))
+		{
+			fprintf(stderr, "Cannot write %s\n", options.tracePath.c_str());
+			return EXIT_FAILURE;
+		}
+		CollisionTimeline::Delete();
+	}
+
+	if (!options.jsonPath.empty())
+	{
+		FILE* pFile = fopen(options.jsonPath.c_str(), "w");
+		if (pFile == nullptr)
+		{
+			fprintf(stderr, "Cannot open %s\n", options.jsonPath.c_str());
+			return EXIT_FAILURE;
+		}
+		WriteJson(pFile, options, results);
+		fclose(pFile);
+	}
+
+	const bool isMatching = std::all_of(results.begin(), results.end(), [](const FrameResult& result) { return result.isMatching(); });
+	return isMatching ? EXIT_SUCCESS : EXIT_FAILURE;
+}
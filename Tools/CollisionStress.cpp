@@ -0,0 +1,912 @@
+#include "ToolCollidables.h"
+#include "AllocationCounter.h"
+#include "ProceduralMeshes.h"
+
+#include "CollisionManager.h"
+#include "CollisionRecorder.h"
+#include "CollisionStats.h"
+#include "CollisionTimeline.h"
+#include "HardwareCounters.h"
+#include "OctreeModelManager.h"
+#include "OctreeTools.h"
+#include "Scene.h"
+#include "SceneManager.h"
+#include "AzulCore.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Headless scene stress: builds synthetic scenes of N collidables, drives
+// CollisionManager::processCollisions() for a fixed number of frames and reports the time of each
+// stage and the candidate pairs left at each broad phase tier, as N sweeps.
+// Usage: CollisionStress [options] (see PrintUsage)
+//-----------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	typedef std::chrono::steady_clock Clock;
+
+	const float TWO_PI = 6.2831853f;
+
+
+	// Clusters of the CLUSTERED motion
+	const int CLUSTER_COUNT = 8;
+
+	enum class Motion
+	{
+		STATIC,
+		DRIFTING,
+		CLUSTERED,
+		SWARMING
+	};
+
+	enum class Tests
+	{
+		SELF,
+		PAIR,
+		BOTH
+	};
+
+	struct Options
+	{
+		std::vector<int> sweep = { 100, 300, 1000, 3000, 10000, 30000, 100000 };
+		int frames = 60;
+		int warmupFrames = 2;
+		float mixWeights[static_cast<int>(CollisionVolume::Type::COUNT)] = { 2.0f, 1.0f, 1.0f, 0.0f };
+		int groups = 2;
+		Tests tests = Tests::BOTH;
+		float density = 0.05f;
+		Motion motion = Motion::DRIFTING;
+		unsigned int seed = 1;
+		double maxFrameMilliseconds = 2000.0;
+		std::string jsonPath;
+		std::string recordPath;
+		int octreeDepth = 3;
+		OctreeTools::BuildMode octreeBuildMode = OctreeTools::BuildMode::UNIFORM;
+		OctreeTools::FrameMode octreeFrameMode = OctreeTools::FrameMode::MODEL;
+		bool counters = false;
+		bool hardwareCounters = false;
+		std::string tracePath;
+	};
+
+	void PrintUsage()
+	{
+		fprintf(stderr,
+			"Usage: CollisionStress [options]\n"
+			"  --sweep <n,n,...>     Collidable counts (default: 100,300,1000,3000,10000,30000,100000)\n"
+			"  --frames <count>      Timed frames per scene (default: 60)\n"
+			"  --warmup <count>      Untimed frames per scene, registration included (default: 2)\n"
+			"  --mix <type:weight,...> Volume type weights, types bsphere, aabb, obb, octree\n"
+			"                        (default: bsphere:2,aabb:1,obb:1)\n"
+			"  --groups <count>      Collision groups, 1 to %d (default: 2)\n"
+			"  --tests <self|pair|both> Self tests in each group, pair tests between neighbouring\n"
+			"                        groups, or both (default: both)\n"
+			"  --density <value>     Collidables per cubic unit, each about one unit wide (default: 0.05)\n"
+			"  --motion <static|drifting|clustered|swarming> (default: drifting)\n"
+			"  --seed <value>        Random seed (default: 1)\n"
+			"  --max-frame-ms <ms>   Stop the sweep after a scene averaging more per frame (default: 2000)\n"
+			"  --json <file>         Also write the report as JSON\n"
+			"  --record <file>       Record the scene for CollisionReplay (single N sweep only)\n"
+			"  --octree-depth <depth|auto> Depth of the Octree volumes, 1 to %d, or picked per model (default: 3)\n"
+			"  --octree-adaptive     Build the Octree volumes adaptively, the depth being the deepest leaf\n"
+			"  --octree-fitted-frame Build the Octree volumes along the principal axes of each model\n"
+			"  --counters            Enable the detailed collision counters and report them\n"
+			"  --hw-counters         Report the CPU events of each stage (Linux perf_event_open)\n"
+			"  --trace <file>        Write the collision timeline of the last frames as Chrome trace JSON\n",
+			ToolCollidables::MAX_GROUPS, OctreeTools::MAX_DEPTH);
+	}
+
+	bool ParseSweep(const char* text, std::vector<int>& sweep)
+	{
+		sweep.clear();
+		for (const char* p = text; *p != '\0';)
+		{
+			char* pEnd;
+			const long count = strtol(p, &pEnd, 10);
+			if (pEnd == p || count <= 0) return false;
+			sweep.push_back(static_cast<int>(count));
+			p = (*pEnd == ',') ? pEnd + 1 : pEnd;
+			if (*pEnd != ',' && *pEnd != '\0') return false;
+		}
+		return !sweep.empty();
+	}
+
+	bool ParseMix(const char* text, float* mixWeights)
+	{
+		for (int i = 0; i < static_cast<int>(CollisionVolume::Type::COUNT); i++)
+		{
+			mixWeights[i] = 0.0f;
+		}
+
+		std::string entries(text);
+		size_t start = 0;
+		while (start < entries.size())
+		{
+			size_t end = entries.find(',', start);
+			if (end == std::string::npos) end = entries.size();
+
+			const std::string entry = entries.substr(start, end - start);
+			const size_t colon = entry.find(':');
+			const std::string name = entry.substr(0, colon);
+			const CollisionVolume::Type volumeType = ToolCollidables::ParseVolumeType(name.c_str());
+			if (volumeType == CollisionVolume::Type::COUNT) return false;
+
+			const float weight = (colon == std::string::npos) ? 1.0f : static_cast<float>(atof(entry.c_str() + colon + 1));
+			if (weight < 0.0f) return false;
+			mixWeights[static_cast<int>(volumeType)] = weight;
+
+			start = end + 1;
+		}
+
+		float totalWeight = 0.0f;
+		for (int i = 0; i < static_cast<int>(CollisionVolume::Type::COUNT); i++)
+		{
+			totalWeight += mixWeights[i];
+		}
+		return totalWeight > 0.0f;
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			const bool hasValue = (i + 1 < argc);
+			if (strcmp(argv[i], "--sweep") == 0 && hasValue)
+			{
+				if (!ParseSweep(argv[++i], options.sweep)) return false;
+			}
+			else if (strcmp(argv[i], "--frames") == 0 && hasValue)
+			{
+				options.frames = atoi(argv[++i]);
+			}
+			else if (strcmp(argv[i], "--warmup") == 0 && hasValue)
+			{
+				options.warmupFrames = atoi(argv[++i]);
+			}
+			else if (strcmp(argv[i], "--mix") == 0 && hasValue)
+			{
+				if (!ParseMix(argv[++i], options.mixWeights)) return false;
+			}
+			else if (strcmp(argv[i], "--groups") == 0 && hasValue)
+			{
+				options.groups = atoi(argv[++i]);
+			}
+			else if (strcmp(argv[i], "--tests") == 0 && hasValue)
+			{
+				const char* tests = argv[++i];
+				if (strcmp(tests, "self") == 0) options.tests = Tests::SELF;
+				else if (strcmp(tests, "pair") == 0) options.tests = Tests::PAIR;
+				else if (strcmp(tests, "both") == 0) options.tests = Tests::BOTH;
+				else return false;
+			}
+			else if (strcmp(argv[i], "--density") == 0 && hasValue)
+			{
+				options.density = static_cast<float>(atof(argv[++i]));
+			}
+			else if (strcmp(argv[i], "--motion") == 0 && hasValue)
+			{
+				const char* motion = argv[++i];
+				if (strcmp(motion, "static") == 0) options.motion = Motion::STATIC;
+				else if (strcmp(motion, "drifting") == 0) options.motion = Motion::DRIFTING;
+				else if (strcmp(motion, "clustered") == 0) options.motion = Motion::CLUSTERED;
+				else if (strcmp(motion, "swarming") == 0) options.motion = Motion::SWARMING;
+				else return false;
+			}
+			else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+			{
+				options.seed = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+			}
+			else if (strcmp(argv[i], "--max-frame-ms") == 0 && hasValue)
+			{
+				options.maxFrameMilliseconds = atof(argv[++i]);
+			}
+			else if (strcmp(argv[i], "--json") == 0 && hasValue)
+			{
+				options.jsonPath = argv[++i];
+			}
+			else if (strcmp(argv[i], "--record") == 0 && hasValue)
+			{
+				options.recordPath = argv[++i];
+			}
+			else if (strcmp(argv[i], "--octree-depth") == 0 && hasValue)
+			{
+				const char* depth = argv[++i];
+				options.octreeDepth = (strcmp(depth, "auto") == 0) ? OctreeTools::AUTO_DEPTH : atoi(depth);
+				if (options.octreeDepth != OctreeTools::AUTO_DEPTH && (options.octreeDepth < 1 || options.octreeDepth > OctreeTools::MAX_DEPTH)) return false;
+			}
+			else if (strcmp(argv[i], "--octree-adaptive") == 0)
+			{
+				options.octreeBuildMode = OctreeTools::BuildMode::ADAPTIVE;
+			}
+			else if (strcmp(argv[i], "--octree-fitted-frame") == 0)
+			{
+				options.octreeFrameMode = OctreeTools::FrameMode::FITTED;
+			}
+			else if (strcmp(argv[i], "--counters") == 0)
+			{
+				options.counters = true;
+			}
+			else if (strcmp(argv[i], "--hw-counters") == 0)
+			{
+				options.hardwareCounters = true;
+			}
+			else if (strcmp(argv[i], "--trace") == 0 && hasValue)
+			{
+				options.tracePath = argv[++i];
+			}
+			else
+			{
+				return false;
+			}
+		}
+
+		return options.frames > 0 && options.warmupFrames >= 1
+			&& options.groups >= 1 && options.groups <= ToolCollidables::MAX_GROUPS
+			&& options.density > 0.0f && options.maxFrameMilliseconds > 0.0
+			&& (options.recordPath.empty() || options.sweep.size() == 1);
+	}
+
+	const char* GetMotionName(Motion motion)
+	{
+		switch (motion)
+		{
+		case Motion::STATIC:
+			return "static";
+		case Motion::DRIFTING:
+			return "drifting";
+		case Motion::CLUSTERED:
+			return "clustered";
+		default:
+			return "swarming";
+		}
+	}
+
+	const char* GetTestsName(Tests tests)
+	{
+		switch (tests)
+		{
+		case Tests::SELF:
+			return "self";
+		case Tests::PAIR:
+			return "pair";
+		default:
+			return "both";
+		}
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Motion
+	//-------------------------------------------------------------------------------------------------------------------------
+	/**********************************************************************************************//**
+	 * <summary> Per collidable motion parameters, drawn once per scene.</summary>
+	 **************************************************************************************************/
+	struct MotionState
+	{
+		Vect position;
+		Vect velocity;
+		Vect rotationAxis;
+		float angle;
+		float angularSpeed;
+		float scale;
+
+		// CLUSTERED: cluster index. SWARMING: orbit radius and phase.
+		int cluster;
+		float orbitRadius;
+		float orbitPhase;
+	};
+
+	class SceneMotion
+	{
+	public:
+		SceneMotion(Motion motion, int count, float worldSize, std::mt19937& random)
+			: _motion(motion), _halfSize(0.5f * worldSize), _states(count), _clusterCenters(CLUSTER_COUNT)
+		{
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			std::uniform_real_distribution<float> scale(0.5f, 1.5f);
+			std::normal_distribution<float> normal(0.0f, 1.0f);
+
+			// Cluster and swarm spreads keep the local density about 8 times the average
+			const float clusterSpread = 0.5f * _halfSize / cbrtf(8.0f * CLUSTER_COUNT);
+			const float swarmSpread = _halfSize / 2.0f;
+
+			for (Vect& center : _clusterCenters)
+			{
+				center = Vect(unit(random), unit(random), unit(random)) * (0.6f * _halfSize);
+			}
+
+			for (int i = 0; i < count; i++)
+			{
+				MotionState& state = _states[i];
+				state.position = Vect(unit(random), unit(random), unit(random)) * _halfSize;
+				state.velocity = Vect(unit(random), unit(random), unit(random)) * 0.05f;
+				state.rotationAxis = Vect(unit(random), unit(random), unit(random) + 2.0f).getNorm();
+				state.angle = TWO_PI * 0.5f * (unit(random) + 1.0f);
+				state.angularSpeed = 0.05f * unit(random);
+				state.scale = scale(random);
+				state.cluster = i % CLUSTER_COUNT;
+				state.orbitRadius = swarmSpread * fabsf(normal(random)) + 1.0f;
+				state.orbitPhase = TWO_PI * 0.5f * (unit(random) + 1.0f);
+
+				if (_motion == Motion::CLUSTERED)
+				{
+					state.position = Vect(normal(random), normal(random), normal(random)) * clusterSpread;
+				}
+			}
+		}
+
+		bool isStatic() const
+		{
+			return _motion == Motion::STATIC;
+		}
+
+		// Computes the world matrices of the frame
+		void computeWorlds(int frame, std::vector<Matrix>& worlds)
+		{
+			const float time = static_cast<float>(frame);
+			for (size_t i = 0; i < _states.size(); i++)
+			{
+				MotionState& state = _states[i];
+				Vect position;
+
+				switch (_motion)
+				{
+				case Motion::STATIC:
+					position = state.position;
+					break;
+				case Motion::DRIFTING:
+					state.position = wrap(state.position + state.velocity);
+					position = state.position;
+					break;
+				case Motion::CLUSTERED:
+				{
+					// Cluster centers circle around the world center, members jitter around them
+					const Vect& center = _clusterCenters[state.cluster];
+					const float angle = 0.002f * time * (1.0f + 0.1f * state.cluster);
+					const Vect orbit(center[x] * cosf(angle) - center[z] * sinf(angle), center[y], center[x] * sinf(angle) + center[z] * cosf(angle));
+					position = orbit + state.position + state.velocity * (2.0f * sinf(0.05f * time + state.orbitPhase));
+					break;
+				}
+				default:
+				{
+					// Everyone orbits a wandering attractor
+					const Vect attractor(0.5f * _halfSize * sinf(0.003f * time), 0.25f * _halfSize * sinf(0.005f * time), 0.5f * _halfSize * cosf(0.004f * time));
+					const float phase = state.orbitPhase + time * state.angularSpeed / state.orbitRadius * 10.0f;
+					position = attractor + Vect(state.orbitRadius * cosf(phase), state.orbitRadius * state.rotationAxis[y] * 0.5f, state.orbitRadius * sinf(phase));
+					break;
+				}
+				}
+
+				if (!isStatic())
+				{
+					state.angle += state.angularSpeed;
+				}
+
+				worlds[i] = Matrix(SCALE, state.scale, state.scale, state.scale)
+					* Matrix(ROT_AXIS_ANGLE, state.rotationAxis, state.angle)
+					* Matrix(TRANS, position);
+			}
+		}
+
+	private:
+		Vect wrap(const Vect& position) const
+		{
+			Vect wrapped(position);
+			for (int component = x; component <= z; component++)
+			{
+				float& value = wrapped[static_cast<VectComponent>(component)];
+				if (value > _halfSize) value -= 2.0f * _halfSize;
+				else if (value < -_halfSize) value += 2.0f * _halfSize;
+			}
+			return wrapped;
+		}
+
+		Motion _motion;
+		float _halfSize;
+		std::vector<MotionState> _states;
+		std::vector<Vect> _clusterCenters;
+	};
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Scene run
+	//-------------------------------------------------------------------------------------------------------------------------
+	struct StressModels
+	{
+		Model* pBox;
+		Model* pSphere;
+	};
+
+	/**********************************************************************************************//**
+	 * <summary> Per frame averages of one scene run.</summary>
+	 **************************************************************************************************/
+	struct StressResult
+	{
+		int count = 0;
+		int frames = 0;
+
+		// Collidable update (updateCollisionData) then the CollisionFrameStats stages
+		double updateMilliseconds = 0.0;
+		double stageMilliseconds[static_cast<int>(CollisionFrameStats::Stage::COUNT)] = {};
+		double totalMilliseconds = 0.0;
+
+		double groupAABBTests = 0.0;
+		double groupAABBPasses = 0.0;
+		double BSphereCullTests = 0.0;
+		double BSphereCullPasses = 0.0;
+		double BSpherePairTests = 0.0;
+		double BSpherePairPasses = 0.0;
+		double narrowPhaseTests = 0.0;
+		double collisions = 0.0;
+		double allocations = 0.0;
+
+		// Sum of the timed frames (detailed counters filled in with --counters only)
+		CollisionCommandStats counters;
+
+		// Octree Models while the scene's collidables were registered
+		OctreeModelManager::ReportCollection octreeModels;
+		size_t octreeBytes = 0;
+
+		// Sum of the timed frames, with --hw-counters only
+		bool hasHardwareCounters = false;
+		HardwareCounterValues stageHardwareCounters[static_cast<int>(CollisionFrameStats::Stage::COUNT)];
+
+		int volumeCounts[static_cast<int>(CollisionVolume::Type::COUNT)] = {};
+	};
+
+	CollisionVolume::Type PickVolumeType(const Options& options, std::mt19937& random)
+	{
+		float totalWeight = 0.0f;
+		for (float weight : options.mixWeights)
+		{
+			totalWeight += weight;
+		}
+
+		float pick = std::uniform_real_distribution<float>(0.0f, totalWeight)(random);
+		for (int i = 0; i < static_cast<int>(CollisionVolume::Type::COUNT); i++)
+		{
+			if (options.mixWeights[i] > 0.0f && pick < options.mixWeights[i])
+			{
+				return static_cast<CollisionVolume::Type>(i);
+			}
+			pick -= options.mixWeights[i];
+		}
+		return CollisionVolume::Type::BSPHERE;
+	}
+
+	void SetTestCommands(CollisionManager& collisionManager, const Options& options)
+	{
+		if (options.tests != Tests::PAIR || options.groups == 1)
+		{
+			for (int group = 0; group < options.groups; group++)
+			{
+				ToolCollidables::SetCollisionSelf(collisionManager, group);
+			}
+		}
+
+		if (options.tests != Tests::SELF)
+		{
+			for (int group = 0; group + 1 < options.groups; group++)
+			{
+				ToolCollidables::SetCollisionPair(collisionManager, group, group + 1);
+			}
+		}
+	}
+
+	StressResult RunScene(const Options& options, const StressModels& models, int count)
+	{
+		std::mt19937 random(options.seed + static_cast<unsigned int>(count));
+		const float worldSize = cbrtf(count / options.density);
+
+		Scene* pScene = new Scene();
+		SceneManager::SetCurrentScene(pScene);
+		CollisionManager& collisionManager = pScene->getCollisionManager();
+
+		CollisionRecorder* pRecorder = nullptr;
+		if (!options.recordPath.empty())
+		{
+			pRecorder = new CollisionRecorder(options.recordPath.c_str());
+			if (!pRecorder->isOpen())
+			{
+				fprintf(stderr, "Cannot open %s\n", options.recordPath.c_str());
+			}
+			collisionManager.setRecorder(pRecorder);
+		}
+
+		SetTestCommands(collisionManager, options);
+
+		StressResult result;
+		result.count = count;
+		result.frames = options.frames;
+
+		SceneMotion motion(options.motion, count, worldSize, random);
+
+		std::vector<Collidable*> collidables(count);
+		for (int i = 0; i < count; i++)
+		{
+			const CollisionVolume::Type volumeType = PickVolumeType(options, random);
+			Model* pModel = (volumeType == CollisionVolume::Type::OCTREE) ? models.pSphere : models.pBox;
+			collidables[i] = ToolCollidables::Create(i % options.groups, pModel, volumeType, options.octreeDepth, options.octreeBuildMode, motion.isStatic());
+			result.volumeCounts[static_cast<int>(volumeType)]++;
+		}
+		collisionManager.submitRegistrations(collidables.data(), collidables.size());
+
+		std::vector<Matrix> worlds(count);
+		for (int frame = 0; frame < options.warmupFrames + options.frames; frame++)
+		{
+			motion.computeWorlds(frame, worlds);
+
+			const unsigned long long allocationsStart = AllocationCounter::GetCount();
+			const Clock::time_point updateStart = Clock::now();
+			collisionManager.updateCollisionData(collidables.data(), worlds.data(), collidables.size());
+			const double updateSeconds = std::chrono::duration<double>(Clock::now() - updateStart).count();
+
+			collisionManager.processCollisions();
+			const unsigned long long allocations = AllocationCounter::GetCount() - allocationsStart;
+
+			if (frame < options.warmupFrames) continue;
+
+			const CollisionFrameStats& frameStats = collisionManager.getLastFrameStats();
+			result.updateMilliseconds += 1000.0 * updateSeconds;
+			for (int stage = 0; stage < static_cast<int>(CollisionFrameStats::Stage::COUNT); stage++)
+			{
+				result.stageMilliseconds[stage] += 1000.0 * frameStats.stageSeconds[stage];
+			}
+			result.totalMilliseconds += 1000.0 * (updateSeconds + frameStats.getTotalSeconds());
+
+			result.groupAABBTests += frameStats.totals.groupAABBTests;
+			result.groupAABBPasses += frameStats.totals.groupAABBPasses;
+			result.BSphereCullTests += frameStats.totals.BSphereCullTests;
+			result.BSphereCullPasses += frameStats.totals.BSphereCullPasses;
+			result.BSpherePairTests += frameStats.totals.BSpherePairTests;
+			result.BSpherePairPasses += frameStats.totals.BSpherePairPasses;
+			result.narrowPhaseTests += frameStats.narrowPhaseTests;
+			result.collisions += frameStats.collisions;
+			result.allocations += static_cast<double>(allocations);
+			result.counters += frameStats.totals;
+
+			result.hasHardwareCounters = frameStats.hasHardwareCounters;
+			for (int stage = 0; stage < static_cast<int>(CollisionFrameStats::Stage::COUNT); stage++)
+			{
+				result.stageHardwareCounters[stage] += frameStats.stageHardwareCounters[stage];
+			}
+		}
+
+		collisionManager.setRecorder(nullptr);
+		delete pRecorder;
+
+		result.octreeBytes = OctreeModelManager::GetReports(result.octreeModels);
+
+		collisionManager.submitDeregistrations(collidables.data(), collidables.size());
+		collisionManager.processCollisions();
+		for (Collidable* pCollidable : collidables)
+		{
+			delete pCollidable;
+		}
+		SceneManager::SetCurrentScene(nullptr);
+		delete pScene;
+
+		// Per frame averages
+		const double frames = options.frames;
+		result.updateMilliseconds /= frames;
+		for (double& milliseconds : result.stageMilliseconds)
+		{
+			milliseconds /= frames;
+		}
+		result.totalMilliseconds /= frames;
+		result.groupAABBTests /= frames;
+		result.groupAABBPasses /= frames;
+		result.BSphereCullTests /= frames;
+		result.BSphereCullPasses /= frames;
+		result.BSpherePairTests /= frames;
+		result.BSpherePairPasses /= frames;
+		result.narrowPhaseTests /= frames;
+		result.collisions /= frames;
+		result.allocations /= frames;
+
+		return result;
+	}
+
+	//-------------------------------------------------------------------------------------------------------------------------
+	// Report
+	//-------------------------------------------------------------------------------------------------------------------------
+	const char* const STAGE_NAMES[] = { "registration", "group_update", "broad_phase", "narrow_phase" };
+	static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<size_t>(CollisionFrameStats::Stage::COUNT), "One name per stage");
+
+	// Exponent k of total time ~ N^k between two consecutive counts of the sweep
+	double GetScalingExponent(const StressResult& previous, const StressResult& current)
+	{
+		if (previous.totalMilliseconds <= 0.0 || current.totalMilliseconds <= 0.0) return 0.0;
+		return log(current.totalMilliseconds / previous.totalMilliseconds) / log(static_cast<double>(current.count) / previous.count);
+	}
+
+	void PrintHeader()
+	{
+		printf("%8s %9s %9s %9s %9s %9s %9s %8s %6s | %11s %11s %11s %11s %11s %11s %10s %10s %8s\n",
+			"N", "update", "registr.", "groups", "broad", "narrow", "total ms", "us/obj", "k",
+			"grpAABB", "grpAABB ok", "cull", "cull ok", "sphere pair", "pair ok", "narrow", "hits", "allocs");
+	}
+
+	void PrintResult(const StressResult& result, double scalingExponent)
+	{
+		printf("%8d %9.3f %9.3f %9.3f %9.3f %9.3f %9.3f %8.3f %6.2f | %11.0f %11.0f %11.0f %11.0f %11.0f %11.0f %10.0f %10.0f %8.1f\n",
+			result.count, result.updateMilliseconds,
+			result.stageMilliseconds[0], result.stageMilliseconds[1], result.stageMilliseconds[2], result.stageMilliseconds[3],
+			result.totalMilliseconds, 1000.0 * result.totalMilliseconds / result.count, scalingExponent,
+			result.groupAABBTests, result.groupAABBPasses, result.BSphereCullTests, result.BSphereCullPasses,
+			result.BSpherePairTests, result.BSpherePairPasses, result.narrowPhaseTests, result.collisions, result.allocations);
+		fflush(stdout);
+	}
+
+	const char* GetBuildModeSuffix(OctreeTools::BuildMode buildMode)
+	{
+		return (buildMode == OctreeTools::BuildMode::ADAPTIVE) ? " adaptive" : "";
+	}
+
+	const char* GetBuildModeName(OctreeTools::BuildMode buildMode)
+	{
+		return (buildMode == OctreeTools::BuildMode::ADAPTIVE) ? "adaptive" : "uniform";
+	}
+
+	const char* GetFrameModeName(OctreeTools::FrameMode frameMode)
+	{
+		return (frameMode == OctreeTools::FrameMode::FITTED) ? "fitted" : "model";
+	}
+
+	void PrintOctreeModels(const StressResult& result, const StressModels& models)
+	{
+		for (const OctreeModelReport& report : result.octreeModels)
+		{
+			printf("%8s octree %s d%d%s%s%s: %d tris, %d nodes (%d valid), leaf occupancy %.0f%%, fit error %.2f, query cost %.1f, built in %.2f ms, shared %.1f KiB + %d x %.1f KiB\n", "",
+				(report.pModel == models.pSphere) ? "sphere" : "box", report.depth, report.isAutoDepth ? " (auto)" : "", GetBuildModeSuffix(report.buildMode),
+				report.isFrameFitted ? " fitted" : "", report.triangleCount, report.nodeCount, report.validNodeCount, 100.0 * report.getLeafOccupancy(), report.fitError, report.estimatedQueryCost, 1000.0 * report.buildSeconds, report.sharedBytes / 1024.0,
+				report.instanceCount, report.instanceBytes / 1024.0);
+		}
+		printf("%8s octree memory: %.1f KiB\n", "", result.octreeBytes / 1024.0);
+		fflush(stdout);
+	}
+
+	void PrintCounters(const StressResult& result)
+	{
+		const double frames = result.frames;
+		const CollisionCommandStats& counters = result.counters;
+
+		printf("%8s narrow tests/hits per frame:", "");
+		for (int type_1 = 0; type_1 < CollisionCommandStats::NUMBER_OF_TYPES; type_1++)
+		{
+			for (int type_2 = type_1; type_2 < CollisionCommandStats::NUMBER_OF_TYPES; type_2++)
+			{
+				if (counters.narrowPhaseTests[type_1][type_2] == 0) continue;
+
+				printf(" %s-%s %.0f/%.0f", ToolCollidables::GetVolumeTypeName(static_cast<CollisionVolume::Type>(type_1)),
+					ToolCollidables::GetVolumeTypeName(static_cast<CollisionVolume::Type>(type_2)),
+					counters.narrowPhaseTests[type_1][type_2] / frames, counters.narrowPhaseHits[type_1][type_2] / frames);
+			}
+		}
+		printf("\n%8s octree nodes %.0f, node pairs %.0f, SAT axes %.0f, callbacks %.0f per frame\n", "",
+			counters.octreeNodeVisits / frames, counters.octreeNodePairVisits / frames, counters.SATAxes / frames, counters.callbacks / frames);
+		fflush(stdout);
+	}
+
+	void PrintHardwareCounters(const StressResult& result)
+	{
+		const double frames = result.frames;
+
+		printf("%8s cpu per frame:", "");
+		for (int stage = 0; stage < static_cast<int>(CollisionFrameStats::Stage::COUNT); stage++)
+		{
+			const HardwareCounterValues& values = result.stageHardwareCounters[stage];
+			printf("%s %s IPC %.2f L1D %.0f LLC %.0f br %.0f", stage == 0 ? "" : " |", STAGE_NAMES[stage],
+				values.getInstructionsPerCycle(), values.L1DMisses / frames, values.LLCMisses / frames, values.branchMisses / frames);
+		}
+		printf("\n");
+		fflush(stdout);
+	}
+
+	void WriteJsonHardwareCounters(FILE* pFile, const StressResult& result)
+	{
+		const double frames = result.frames;
+
+		fprintf(pFile, ",\n      \"hardware_counters_per_frame\": {");
+		for (int stage = 0; stage < static_cast<int>(CollisionFrameStats::Stage::COUNT); stage++)
+		{
+			const HardwareCounterValues& values = result.stageHardwareCounters[stage];
+			fprintf(pFile, "%s\"%s\": {\"cycles\": %.9g, \"instructions\": %.9g, \"ipc\": %.9g, \"l1d_misses\": %.9g, \"llc_misses\": %.9g, \"branch_misses\": %.9g}",
+				stage == 0 ? "" : ", ", STAGE_NAMES[stage], values.cycles / frames, values.instructions / frames, values.getInstructionsPerCycle(),
+				values.L1DMisses / frames, values.LLCMisses / frames, values.branchMisses / frames);
+		}
+		fprintf(pFile, "}");
+	}
+
+	void WriteJsonOctreeModels(FILE* pFile, const StressResult& result, const StressModels& models)
+	{
+		fprintf(pFile, ",\n      \"octree_bytes\": %zu,\n      \"octree_models\": [", result.octreeBytes);
+		for (size_t i = 0; i < result.octreeModels.size(); i++)
+		{
+			const OctreeModelReport& report = result.octreeModels[i];
+			fprintf(pFile, "%s{\"model\": \"%s\", \"depth\": %d, \"build_mode\": \"%s\", \"frame_mode\": \"%s\", \"triangles\": %d, \"nodes\": %d, \"valid_nodes\": %d, "
+				"\"leaf_nodes\": %d, \"valid_leaf_nodes\": %d, \"fit_error\": %.9g, \"estimated_query_cost\": %.9g, \"auto_depth\": %s, \"fitted_frame\": %s, \"build_ms\": %.9g, \"shared_bytes\": %zu, \"instance_bytes\": %zu, \"instances\": %d}",
+				i == 0 ? "" : ", ", (report.pModel == models.pSphere) ? "sphere" : "box", report.depth, GetBuildModeName(report.buildMode), GetFrameModeName(report.frameMode), report.triangleCount, report.nodeCount,
+				report.validNodeCount, report.leafNodeCount, report.validLeafNodeCount, report.fitError, report.estimatedQueryCost,
+				report.isAutoDepth ? "true" : "false", report.isFrameFitted ? "true" : "false", 1000.0 * report.buildSeconds, report.sharedBytes,
+				report.instanceBytes, report.instanceCount);
+		}
+		fprintf(pFile, "]");
+	}
+
+	void WriteJsonCounters(FILE* pFile, const StressResult& result)
+	{
+		const double frames = result.frames;
+		const CollisionCommandStats& counters = result.counters;
+
+		fprintf(pFile, ",\n      \"counters_per_frame\": {\"narrow_phase\": {");
+		bool isFirst = true;
+		for (int type_1 = 0; type_1 < CollisionCommandStats::NUMBER_OF_TYPES; type_1++)
+		{
+			for (int type_2 = type_1; type_2 < CollisionCommandStats::NUMBER_OF_TYPES; type_2++)
+			{
+				fprintf(pFile, "%s\"%s_%s\": {\"tests\": %.9g, \"hits\": %.9g}", isFirst ? "" : ", ",
+					ToolCollidables::GetVolumeTypeName(static_cast<CollisionVolume::Type>(type_1)),
+					ToolCollidables::GetVolumeTypeName(static_cast<CollisionVolume::Type>(type_2)),
+					counters.narrowPhaseTests[type_1][type_2] / frames, counters.narrowPhaseHits[type_1][type_2] / frames);
+				isFirst = false;
+			}
+		}
+		fprintf(pFile, "}, \"octree_node_visits\": %.9g, \"octree_node_pair_visits\": %.9g, \"sat_axes\": %.9g, \"callbacks\": %.9g}",
+			counters.octreeNodeVisits / frames, counters.octreeNodePairVisits / frames, counters.SATAxes / frames, counters.callbacks / frames);
+	}
+
+	void WriteJson(FILE* pFile, const Options& options, const StressModels& models, const std::vector<StressResult>& results)
+	{
+		fprintf(pFile, "{\n  \"suite\": \"CollisionStress\",\n  \"configuration\": {\n");
+		fprintf(pFile, "    \"frames\": %d,\n    \"warmup_frames\": %d,\n    \"groups\": %d,\n", options.frames, options.warmupFrames, options.groups);
+		fprintf(pFile, "    \"tests\": \"%s\",\n    \"motion\": \"%s\",\n", GetTestsName(options.tests), GetMotionName(options.motion));
+		fprintf(pFile, "    \"counters\": %s,\n", options.counters ? "true" : "false");
+		fprintf(pFile, "    \"density\": %.9g,\n    \"seed\": %u,\n", options.density, options.seed);
+		if (options.octreeDepth == OctreeTools::AUTO_DEPTH)
+		{
+			fprintf(pFile, "    \"octree_depth\": \"auto\",\n");
+		}
+		else
+		{
+			fprintf(pFile, "    \"octree_depth\": %d,\n", options.octreeDepth);
+		}
+		fprintf(pFile, "    \"octree_build_mode\": \"%s\",\n", GetBuildModeName(options.octreeBuildMode));
+		fprintf(pFile, "    \"octree_frame\": \"%s\",\n", GetFrameModeName(options.octreeFrameMode));
+		fprintf(pFile, "    \"mix\": {");
+		for (int i = 0; i < static_cast<int>(CollisionVolume::Type::COUNT); i++)
+		{
+			fprintf(pFile, "%s\"%s\": %.9g", i == 0 ? "" : ", ", ToolCollidables::GetVolumeTypeName(static_cast<CollisionVolume::Type>(i)), options.mixWeights[i]);
+		}
+		fprintf(pFile, "}\n  },\n  \"results\": [");
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const StressResult& result = results[i];
+			fprintf(pFile, "%s\n    {\n      \"n\": %d,\n", i == 0 ? "" : ",", result.count);
+			fprintf(pFile, "      \"volumes\": {");
+			for (int type = 0; type < static_cast<int>(CollisionVolume::Type::COUNT); type++)
+			{
+				fprintf(pFile, "%s\"%s\": %d", type == 0 ? "" : ", ", ToolCollidables::GetVolumeTypeName(static_cast<CollisionVolume::Type>(type)), result.volumeCounts[type]);
+			}
+			fprintf(pFile, "},\n      \"ms_per_frame\": {\"update\": %.9g", result.updateMilliseconds);
+			for (int stage = 0; stage < static_cast<int>(CollisionFrameStats::Stage::COUNT); stage++)
+			{
+				fprintf(pFile, ", \"%s\": %.9g", STAGE_NAMES[stage], result.stageMilliseconds[stage]);
+			}
+			fprintf(pFile, ", \"total\": %.9g},\n", result.totalMilliseconds);
+			fprintf(pFile, "      \"us_per_object\": %.9g,\n", 1000.0 * result.totalMilliseconds / result.count);
+			fprintf(pFile, "      \"scaling_exponent\": %.9g,\n", i == 0 ? 0.0 : GetScalingExponent(results[i - 1], result));
+			fprintf(pFile, "      \"pairs_per_frame\": {\"group_aabb_tests\": %.9g, \"group_aabb_passes\": %.9g, "
+				"\"bsphere_cull_tests\": %.9g, \"bsphere_cull_passes\": %.9g, \"bsphere_pair_tests\": %.9g, "
+				"\"bsphere_pair_passes\": %.9g, \"narrow_phase_tests\": %.9g, \"collisions\": %.9g},\n      \"allocations_per_frame\": %.9g",
+				result.groupAABBTests, result.groupAABBPasses, result.BSphereCullTests, result.BSphereCullPasses,
+				result.BSpherePairTests, result.BSpherePairPasses, result.narrowPhaseTests, result.collisions, result.allocations);
+			WriteJsonOctreeModels(pFile, result, models);
+			if (options.counters)
+			{
+				WriteJsonCounters(pFile, result);
+			}
+			if (result.hasHardwareCounters)
+			{
+				WriteJsonHardwareCounters(pFile, result);
+			}
+			fprintf(pFile, "\n    }");
+		}
+		fprintf(pFile, "\n  ]\n}\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		PrintUsage();
+		return EXIT_FAILURE;
+	}
+
+	// The Octree builder traces every build
+	Trace::SetEnabled(false);
+	CollisionCounters::SetEnabled(options.counters);
+
+	if (options.hardwareCounters && !HardwareCounters::Open())
+	{
+		printf("Hardware counters unavailable: %s\n", HardwareCounters::GetError());
+	}
+
+	if (!options.tracePath.empty())
+	{
+		CollisionTimeline::SetThreadName("stress");
+		CollisionTimeline::SetEnabled(true);
+	}
+
+	StressModels models;
+	models.pBox = ProceduralMeshes::CreateBox(0.5f, 0.5f, 0.5f);
+	models.pSphere = ProceduralMeshes::CreateSphere(8, 12, 0.5f);
+	OctreeModelManager::SetFrameMode(options.octreeFrameMode);
+
+	printf("CollisionStress: motion %s, tests %s, %d group(s), density %g, %d frame(s)\n",
+		GetMotionName(options.motion), GetTestsName(options.tests), options.groups, options.density, options.frames);
+	PrintHeader();
+
+	std::vector<StressResult> results;
+	for (int count : options.sweep)
+	{
+		results.push_back(RunScene(options, models, count));
+		const StressResult& result = results.back();
+		PrintResult(result, results.size() > 1 ? GetScalingExponent(results[results.size() - 2], result) : 0.0);
+		if (!result.octreeModels.empty())
+		{
+			PrintOctreeModels(result, models);
+		}
+		if (options.counters)
+		{
+			PrintCounters(result);
+		}
+		if (result.hasHardwareCounters)
+		{
+			PrintHardwareCounters(result);
+		}
+
+		if (result.totalMilliseconds > options.maxFrameMilliseconds)
+		{
+			printf("Stopping the sweep: %.1f ms per frame exceeds --max-frame-ms\n", result.totalMilliseconds);
+			break;
+		}
+	}
+
+	HardwareCounters::Close();
+	OctreeModelManager::Delete();
+	delete models.pBox;
+	delete models.pSphere;
+
+	if (!options.tracePath.empty())
+	{
+		CollisionTimeline::SetEnabled(false);
+		if (!CollisionTimeline::WriteChromeTrace(options.tracePath.c_str()))
+		{
+			fprintf(stderr, "Cannot write %s\n", options.tracePath.c_str());
+			return EXIT_FAILURE;
+		}
+		CollisionTimeline::Delete();
+	}
+
+	if (!options.jsonPath.empty())
+	{
+		FILE* pFile = fopen(options.jsonPath.c_str(), "w");
+		if (pFile == nullptr)
+		{
+			fprintf(stderr, "Cannot open %s\n", options.jsonPath.c_str());
+			return EXIT_FAILURE;
+		}
+		WriteJson(pFile, options, models, results);
+		fclose(pFile);
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+#include "ProceduralMeshes.h"
+#include "Model.h"
+#include "Vect.h"
+#include "Matrix.h"
+#include "GpuVertTypes.h"
+#include <vector>
+#include <random>
+#include <cmath>
+#include <cassert>
+#include <algorithm>
+
+namespace
+{
+	const float PI = 3.14159265358979f;
+
+	typedef std::vector<Vect> VectCollection;
+	typedef std::vector<TriangleIndex> TriangleIndexCollection;
+
+	// Two triangles for the quad (a, b, c, d), counter-clockwise
+	void AddQuad(TriangleIndexCollection& triangles, unsigned int a, unsigned int b, unsigned int c, unsigned int d)
+	{
+		triangles.push_back({ a, b, c });
+		triangles.push_back({ a, c, d });
+	}
+
+	Model* CreateModel(const VectCollection& vects, const TriangleIndexCollection& triangles)
+	{
+		return new Model(vects.data(), static_cast<int>(vects.size()), triangles.data(), static_cast<int>(triangles.size()));
+	}
+}
+
+Model* ProceduralMeshes::CreateSphere(int rings, int segments, float radius)
+{
+	assert(rings >= 2 && segments >= 3);
+
+	VectCollection vects;
+	TriangleIndexCollection triangles;
+
+	// Poles are shared, every inner ring has its own vertices
+	const unsigned int topPole = 0;
+	vects.push_back(Vect(0.0f, radius, 0.0f));
+	for (int ring = 1; ring < rings; ring++)
+	{
+		const float phi = PI * ring / rings;
+		for (int segment = 0; segment < segments; segment++)
+		{
+			const float theta = 2.0f * PI * segment / segments;
+			vects.push_back(Vect(radius * std::sin(phi) * std::cos(theta), radius * std::cos(phi), radius * std::sin(phi) * std::sin(theta)));
+		}
+	}
+	const unsigned int bottomPole = static_cast<unsigned int>(vects.size());
+	vects.push_back(Vect(0.0f, -radius, 0.0f));
+
+	auto ringVertex = [segments](int ring, int segment)
+	{
+		return static_cast<unsigned int>(1 + (ring - 1) * segments + (segment % segments));
+	};
+
+	for (int segment = 0; segment < segments; segment++)
+	{
+		triangles.push_back({ topPole, ringVertex(1, segment + 1), ringVertex(1, segment) });
+		triangles.push_back({ bottomPole, ringVertex(rings - 1, segment), ringVertex(rings - 1, segment + 1) });
+	}
+	for (int ring = 1; ring < rings - 1; ring++)
+	{
+		for (int segment = 0; segment < segments; segment++)
+		{
+			AddQuad(triangles, ringVertex(ring, segment), ringVertex(ring, segment + 1), ringVertex(ring + 1, segment + 1), ringVertex(ring + 1, segment));
+		}
+	}
+
+	return CreateModel(vects, triangles);
+}
+
+Model* ProceduralMeshes::CreateTorus(int rings, int segments, float majorRadius, float minorRadius)
+{
+	assert(rings >= 3 && segments >= 3);
+
+	VectCollection vects;
+	TriangleIndexCollection triangles;
+
+	for (int ring = 0; ring < rings; ring++)
+	{
+		const float theta = 2.0f * PI * ring / rings;
+		for (int segment = 0; segment < segments; segment++)
+		{
+			const float phi = 2.0f * PI * segment / segments;
+			const float distance = majorRadius + minorRadius * std::cos(phi);
+			vects.push_back(Vect(distance * std::cos(theta), minorRadius * std::sin(phi), distance * std::sin(theta)));
+		}
+	}
+
+	auto vertex = [rings, segments](int ring, int segment)
+	{
+		return static_cast<unsigned int>((ring % rings) * segments + (segment % segments));
+	};
+
+	for (int ring = 0; ring < rings; ring++)
+	{
+		for (int segment = 0; segment < segments; segment++)
+		{
+			AddQuad(triangles, vertex(ring, segment), vertex(ring, segment + 1), vertex(ring + 1, segment + 1), vertex(ring + 1, segment));
+		}
+	}
+
+	return CreateModel(vects, triangles);
+}
+
+Model* ProceduralMeshes::CreateNoisyTerrain(int cells, float size, float amplitude, unsigned int seed)
+{
+	assert(cells >= 1);
+
+	VectCollection vects;
+	TriangleIndexCollection triangles;
+
+	// Value noise: random heights on a coarse lattice, smoothly interpolated, plus a little detail
+	const int latticeCells = cells / 4 + 1;
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+	std::vector<float> lattice((latticeCells + 1) * (latticeCells + 1));
+	for (float& height : lattice)
+	{
+		height = unit(random);
+	}
+
+	auto smooth = [](float t) { return t * t * (3.0f - 2.0f * t); };
+	auto latticeHeight = [&](float u, float v)
+	{
+		const float fu = u * latticeCells;
+		const float fv = v * latticeCells;
+		const int iu = std::min(static_cast<int>(fu), latticeCells - 1);
+		const int iv = std::min(static_cast<int>(fv), latticeCells - 1);
+		const float tu = smooth(fu - iu);
+		const float tv = smooth(fv - iv);
+		const int stride = latticeCells + 1;
+		const float h00 = lattice[iv * stride + iu];
+		const float h10 = lattice[iv * stride + iu + 1];
+		const float h01 = lattice[(iv + 1) * stride + iu];
+		const float h11 = lattice[(iv + 1) * stride + iu + 1];
+		return (h00 * (1.0f - tu) + h10 * tu) * (1.0f - tv) + (h01 * (1.0f - tu) + h11 * tu) * tv;
+	};
+
+	for (int row = 0; row <= cells; row++)
+	{
+		for (int column = 0; column <= cells; column++)
+		{
+			const float u = static_cast<float>(column) / cells;
+			const float v = static_cast<float>(row) / cells;
+			const float height = amplitude * (0.8f * latticeHeight(u, v) + 0.2f * unit(random));
+			vects.push_back(Vect((u - 0.5f) * size, height, (v - 0.5f) * size));
+		}
+	}
+
+	const unsigned int stride = static_cast<unsigned int>(cells + 1);
+	for (unsigned int row = 0; row < static_cast<unsigned int>(cells); row++)
+	{
+		for (unsigned int column = 0; column < static_cast<unsigned int>(cells); column++)
+		{
+			const unsigned int corner = row * stride + column;
+			AddQuad(triangles, corner, corner + stride, corner + stride + 1, corner + 1);
+		}
+	}
+
+	return CreateModel(vects, triangles);
+}
+
+Model* ProceduralMeshes::CreateBox(float halfX, float halfY, float halfZ)
+{
+	VectCollection vects;
+	for (int i = 0; i < 8; i++)
+	{
+		vects.push_back(Vect((i & 1) ? halfX : -halfX, (i & 2) ? halfY : -halfY, (i & 4) ? halfZ : -halfZ));
+	}
+
+	TriangleIndexCollection triangles;
+	AddQuad(triangles, 0, 2, 3, 1); // -Z
+	AddQuad(triangles, 4, 5, 7, 6); // +Z
+	AddQuad(triangles, 0, 1, 5, 4); // -Y
+	AddQuad(triangles, 2, 6, 7, 3); // +Y
+	AddQuad(triangles, 0, 4, 6, 2); // -X
+	AddQuad(triangles, 1, 3, 7, 5); // +X
+
+	return CreateModel(vects, triangles);
+}
+
+Model* ProceduralMeshes::CreateTransformed(const Model& model, const Matrix& transform)
+{
+	VectCollection vects(model.getVectList(), model.getVectList() + model.getVectNum());
+	for (Vect& vect : vects)
+	{
+		vect *= transform;
+	}
+
+	const TriangleIndexCollection triangles(model.getTriangleList(), model.getTriangleList() + model.getTriNum());
+	return CreateModel(vects, triangles);
+}
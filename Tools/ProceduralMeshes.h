@@ -0,0 +1,78 @@
+#ifndef _ProceduralMeshes
+#define _ProceduralMeshes
+
+class Model;
+class Matrix;
+
+/**********************************************************************************************//**
+// namespace: ProceduralMeshes
+//
+// summary:	Procedural collider models for the headless tools. Every mesh is deterministic
+//			(same arguments, same model) so results can be compared between runs. The caller
+//			owns the returned model.
+ **************************************************************************************************/
+namespace ProceduralMeshes
+{
+	/**********************************************************************************************//**
+	 * <summary> Creates a UV sphere centered on the origin.</summary>
+	 *
+	 * <param name="rings"> Number of rings from pole to pole (at least 2).</param>
+	 * <param name="segments"> Number of segments around the Y axis (at least 3).</param>
+	 * <param name="radius"> The radius.</param>
+	 *
+	 * <returns> The model (2 * segments * (rings - 1) triangles).</returns>
+	 **************************************************************************************************/
+	Model* CreateSphere(int rings, int segments, float radius);
+
+	/**********************************************************************************************//**
+	 * <summary> Creates a torus around the Y axis, centered on the origin.</summary>
+	 *
+	 * <param name="rings"> Number of segments around the Y axis (at least 3).</param>
+	 * <param name="segments"> Number of segments around the tube (at least 3).</param>
+	 * <param name="majorRadius"> Distance from the center to the center of the tube.</param>
+	 * <param name="minorRadius"> The radius of the tube.</param>
+	 *
+	 * <returns> The model (2 * rings * segments triangles).</returns>
+	 **************************************************************************************************/
+	Model* CreateTorus(int rings, int segments, float majorRadius, float minorRadius);
+
+	/**********************************************************************************************//**
+	 * <summary> Creates a square height field in the XZ plane, centered on the origin, with
+	 *			 value noise heights.</summary>
+	 *
+	 * <param name="cells"> Number of cells along each side (at least 1).</param>
+	 * <param name="size"> Length of each side.</param>
+	 * <param name="amplitude"> Maximum height above or below the plane.</param>
+	 * <param name="seed"> The seed of the noise.</param>
+	 *
+	 * <returns> The model (2 * cells * cells triangles).</returns>
+	 **************************************************************************************************/
+	Model* CreateNoisyTerrain(int cells, float size, float amplitude, unsigned int seed);
+
+	/**********************************************************************************************//**
+	 * <summary> Creates a box centered on the origin.</summary>
+	 *
+	 * <param name="halfX"> Half of the size along X.</param>
+	 * <param name="halfY"> Half of the size along Y.</param>
+	 * <param name="halfZ"> Half of the size along Z.</param>
+	 *
+	 * <returns> The model (12 triangles).</returns>
+	 **************************************************************************************************/
+	Model* CreateBox(float halfX, float halfY, float halfZ);
+
+	/**********************************************************************************************//**
+	 * <summary> Creates a copy of a model with its vertices transformed (e.g. a mesh modeled at
+	 *			 an angle).</summary>
+	 *
+	 * <param name="model"> The model to copy.</param>
+	 * <param name="transform"> The transform of the vertices.</param>
+	 *
+	 * <returns> The model (same triangles).</returns>
+	 **************************************************************************************************/
+	Model* CreateTransformed(const Model& model, const Matrix& transform);
+};
+#endif // !_ProceduralMeshes
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// ProceduralMeshes Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
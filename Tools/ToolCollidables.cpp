@@ -0,0 +1,175 @@
+#include "ToolCollidables.h"
+#include "CollisionManager.h"
+#include <cassert>
+#include <cstring>
+
+ToolCollidable::ToolCollidable(int groupIndex, Model* pModel, CollisionVolume::Type volumeType, int octreeDepth, OctreeTools::BuildMode octreeBuildMode, bool isStatic)
+	: _groupIndex(groupIndex), _volumeType(volumeType), _collisionCount(0), _recordID(0), _pChecksum(nullptr)
+{
+	switch (volumeType)
+	{
+	case CollisionVolume::Type::BSPHERE:
+		setColliderModel(pModel, VolumeType::BSPHERE);
+		break;
+	case CollisionVolume::Type::AABB:
+		setColliderModel(pModel, VolumeType::AABB);
+		break;
+	case CollisionVolume::Type::OBB:
+		setColliderModel(pModel, VolumeType::OBB);
+		break;
+	case CollisionVolume::Type::OCTREE:
+		setColliderModel(pModel, (octreeBuildMode == OctreeTools::BuildMode::ADAPTIVE) ? VolumeHierarchyType::ADAPTIVE_OCTREE : VolumeHierarchyType::OCTREE, octreeDepth);
+		break;
+	default:
+		assert(false);
+		break;
+	}
+
+	setIsStatic(isStatic);
+}
+
+int ToolCollidable::getGroupIndex() const
+{
+	return _groupIndex;
+}
+
+CollisionVolume::Type ToolCollidable::getVolumeType() const
+{
+	return _volumeType;
+}
+
+unsigned long long ToolCollidable::getCollisionCount() const
+{
+	return _collisionCount;
+}
+
+void ToolCollidable::addCollision(const ToolCollidable& other)
+{
+	_collisionCount++;
+
+	// Both collidables get the callback, the pair is added once
+	if (_pChecksum != nullptr && _recordID < other._recordID)
+	{
+		_pChecksum->add(_recordID, other._recordID);
+	}
+}
+
+void ToolCollidable::setRecordID(CollisionRecorder::RecordID recordID, CollisionPairChecksum* pChecksum)
+{
+	_recordID = recordID;
+	_pChecksum = pChecksum;
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Run time group index to GroupCollidable type
+//-----------------------------------------------------------------------------------------------------------------------------
+namespace
+{
+	template <int GroupIndex>
+	ToolCollidable* CreateInGroup(int groupIndex, Model* pModel, CollisionVolume::Type volumeType, int octreeDepth, OctreeTools::BuildMode octreeBuildMode, bool isStatic)
+	{
+		if constexpr (GroupIndex < ToolCollidables::MAX_GROUPS)
+		{
+			if (groupIndex == GroupIndex)
+			{
+				return new GroupCollidable<GroupIndex>(pModel, volumeType, octreeDepth, octreeBuildMode, isStatic);
+			}
+			return CreateInGroup<GroupIndex + 1>(groupIndex, pModel, volumeType, octreeDepth, octreeBuildMode, isStatic);
+		}
+		else
+		{
+			assert(false);
+			return nullptr;
+		}
+	}
+
+	template <int GroupIndex>
+	void SetSelf(CollisionManager& collisionManager, int groupIndex)
+	{
+		if constexpr (GroupIndex < ToolCollidables::MAX_GROUPS)
+		{
+			if (groupIndex == GroupIndex)
+			{
+				collisionManager.setCollisionSelf<GroupCollidable<GroupIndex>>();
+				return;
+			}
+			SetSelf<GroupIndex + 1>(collisionManager, groupIndex);
+		}
+		else
+		{
+			assert(false);
+		}
+	}
+
+	template <int GroupIndex_1, int GroupIndex_2>
+	void SetPair(CollisionManager& collisionManager, int groupIndex_1, int groupIndex_2)
+	{
+		if constexpr (GroupIndex_1 < ToolCollidables::MAX_GROUPS && GroupIndex_2 < ToolCollidables::MAX_GROUPS)
+		{
+			if (groupIndex_1 != GroupIndex_1)
+			{
+				SetPair<GroupIndex_1 + 1, 0>(collisionManager, groupIndex_1, groupIndex_2);
+			}
+			else if (groupIndex_2 != GroupIndex_2)
+			{
+				SetPair<GroupIndex_1, GroupIndex_2 + 1>(collisionManager, groupIndex_1, groupIndex_2);
+			}
+			else
+			{
+				collisionManager.setCollisionPair<GroupCollidable<GroupIndex_1>, GroupCollidable<GroupIndex_2>>();
+			}
+		}
+		else
+		{
+			assert(false);
+		}
+	}
+}
+
+ToolCollidable* ToolCollidables::Create(int groupIndex, Model* pModel, CollisionVolume::Type volumeType, int octreeDepth, OctreeTools::BuildMode octreeBuildMode, bool isStatic)
+{
+	return CreateInGroup<0>(groupIndex, pModel, volumeType, octreeDepth, octreeBuildMode, isStatic);
+}
+
+void ToolCollidables::SetCollisionSelf(CollisionManager& collisionManager, int groupIndex)
+{
+	SetSelf<0>(collisionManager, groupIndex);
+}
+
+void ToolCollidables::SetCollisionPair(CollisionManager& collisionManager, int groupIndex_1, int groupIndex_2)
+{
+	SetPair<0, 0>(collisionManager, groupIndex_1, groupIndex_2);
+}
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// Volume type names
+//-----------------------------------------------------------------------------------------------------------------------------
+CollisionVolume::Type ToolCollidables::ParseVolumeType(const char* name)
+{
+	for (int i = 0; i < static_cast<int>(CollisionVolume::Type::COUNT); i++)
+	{
+		const CollisionVolume::Type volumeType = static_cast<CollisionVolume::Type>(i);
+		if (strcmp(name, GetVolumeTypeName(volumeType)) == 0)
+		{
+			return volumeType;
+		}
+	}
+	return CollisionVolume::Type::COUNT;
+}
+
+const char* ToolCollidables::GetVolumeTypeName(CollisionVolume::Type volumeType)
+{
+	switch (volumeType)
+	{
+	case CollisionVolume::Type::BSPHERE:
+		return "bsphere";
+	case CollisionVolume::Type::AABB:
+		return "aabb";
+	case CollisionVolume::Type::OBB:
+		return "obb";
+	case CollisionVolume::Type::OCTREE:
+		return "octree";
+	default:
+		return "unknown";
+	}
+}
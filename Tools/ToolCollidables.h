@@ -0,0 +1,106 @@
+#ifndef _ToolCollidables
+#define _ToolCollidables
+
+#include "Collidable.h"
+#include "CollisionVolume.h"
+#include "CollisionRecorder.h"
+#include "OctreeTools.h"
+
+class CollisionManager;
+class Model;
+
+/**********************************************************************************************//**
+ * <summary> Collidable used by the headless tools: a collider model, a volume type and a count of
+ *			 the collisions reported to it.</summary>
+ *
+ * <remarks> The collision group comes from the derived GroupCollidable. The current Scene must be
+ *			 set before construction (the volumes are created in its CollisionManager). When
+ *			 replaying a log, collisions are also added to a checksum under the record IDs. </remarks>
+ **************************************************************************************************/
+class ToolCollidable : public Collidable
+{
+public:
+	ToolCollidable() = delete;
+	ToolCollidable(const ToolCollidable&) = delete;
+	ToolCollidable& operator=(const ToolCollidable&) = delete;
+	ToolCollidable(ToolCollidable&&) = delete;
+	ToolCollidable& operator=(ToolCollidable&&) = delete;
+	virtual ~ToolCollidable() = default;
+
+	/**********************************************************************************************//**
+	 * <summary> Constructor.</summary>
+	 *
+	 * <param name="groupIndex"> Index of the GroupCollidable.</param>
+	 * <param name="pModel"> The collider model.</param>
+	 * <param name="volumeType"> The type of collision volume.</param>
+	 * <param name="octreeDepth"> The depth of the Octree (if volumeType is OCTREE).</param>
+	 * <param name="octreeBuildMode"> How the Octree is subdivided (if volumeType is OCTREE).</param>
+	 * <param name="isStatic"> True if the collidable never moves.</param>
+	 **************************************************************************************************/
+	ToolCollidable(int groupIndex, Model* pModel, CollisionVolume::Type volumeType, int octreeDepth, OctreeTools::BuildMode octreeBuildMode, bool isStatic);
+
+	int getGroupIndex() const;
+	CollisionVolume::Type getVolumeType() const;
+
+	unsigned long long getCollisionCount() const;
+	void addCollision(const ToolCollidable& other);
+
+	// Identifies the collidable in the checksum of its collision pairs (nullptr for no checksum)
+	void setRecordID(CollisionRecorder::RecordID recordID, CollisionPairChecksum* pChecksum);
+
+private:
+	int _groupIndex;
+	CollisionVolume::Type _volumeType;
+	unsigned long long _collisionCount;
+
+	CollisionRecorder::RecordID _recordID;
+	CollisionPairChecksum* _pChecksum;
+};
+
+/**********************************************************************************************//**
+ * <summary> A ToolCollidable in the collision group of index GroupIndex.</summary>
+ *
+ * <typeparam name="GroupIndex"> Index of the group (below ToolCollidables::MAX_GROUPS).</typeparam>
+ **************************************************************************************************/
+template <int GroupIndex>
+class GroupCollidable : public ToolCollidable
+{
+public:
+	GroupCollidable(Model* pModel, CollisionVolume::Type volumeType, int octreeDepth, OctreeTools::BuildMode octreeBuildMode, bool isStatic)
+		: ToolCollidable(GroupIndex, pModel, volumeType, octreeDepth, octreeBuildMode, isStatic)
+	{
+		setCollidableGroup<GroupCollidable<GroupIndex>>();
+	}
+
+	// Called by CollisionDispatch
+	template <class OtherCollidable>
+	void collision(OtherCollidable* pOther)
+	{
+		addCollision(*pOther);
+	}
+};
+
+/**********************************************************************************************//**
+// namespace: ToolCollidables
+//
+// summary:	Creation of the tool collidables and of their test commands from run time group
+//			indices.
+ **************************************************************************************************/
+namespace ToolCollidables
+{
+	const int MAX_GROUPS = 8;
+
+	ToolCollidable* Create(int groupIndex, Model* pModel, CollisionVolume::Type volumeType, int octreeDepth, OctreeTools::BuildMode octreeBuildMode, bool isStatic);
+
+	void SetCollisionSelf(CollisionManager& collisionManager, int groupIndex);
+	void SetCollisionPair(CollisionManager& collisionManager, int groupIndex_1, int groupIndex_2);
+
+	// "bsphere", "aabb", "obb" or "octree" (COUNT if unknown)
+	CollisionVolume::Type ParseVolumeType(const char* name);
+	const char* GetVolumeTypeName(CollisionVolume::Type volumeType);
+};
+#endif // !_ToolCollidables
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// ToolCollidables Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------
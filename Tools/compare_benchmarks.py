@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Compares two CollisionBenchmark JSON outputs (e.g. from two commits).
+
+Usage: compare_benchmarks.py baseline.json candidate.json [--threshold 0.10]
+
+Prints ns/op, nodes visited and allocations side by side. Exits with 1 when a
+benchmark got slower than the threshold (relative), or visits more nodes or
+allocates more per op than the baseline.
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as file:
+        return {result["name"]: result for result in json.load(file)["results"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative ns/op increase reported as a regression (default: 0.10)")
+    arguments = parser.parse_args()
+
+    baseline = load(arguments.baseline)
+    candidate = load(arguments.candidate)
+
+    regressions = []
+    print("%-60s %12s %12s %8s %10s %10s" % ("benchmark", "base ns/op", "new ns/op", "change", "nodes/op", "allocs/op"))
+    for name in sorted(set(baseline) & set(candidate)):
+        base = baseline[name]
+        new = candidate[name]
+        change = new["ns_per_op"] / base["ns_per_op"] - 1.0 if base["ns_per_op"] else 0.0
+
+        nodes = "%.1f" % new["nodes_visited_per_op"] if "nodes_visited_per_op" in new else "-"
+        print("%-60s %12.1f %12.1f %+7.1f%% %10s %10.2f" % (
+            name, base["ns_per_op"], new["ns_per_op"], 100.0 * change, nodes, new["allocations_per_op"]))
+
+        if change > arguments.threshold:
+            regressions.append("%s: %+.1f%% ns/op" % (name, 100.0 * change))
+        if new.get("nodes_visited_per_op", 0.0) > base.get("nodes_visited_per_op", 0.0) * 1.001:
+            regressions.append("%s: more nodes visited per op" % name)
+        if new["allocations_per_op"] > base["allocations_per_op"] + 0.001:
+            regressions.append("%s: more allocations per op" % name)
+
+    for name in sorted(set(baseline) ^ set(candidate)):
+        print("%-60s only in %s" % (name, "baseline" if name in baseline else "candidate"))
+
+    if regressions:
+        print("\nRegressions:")
+        for regression in regressions:
+            print("  " + regression)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,57 @@
+#include "TriangleBatch.h"
+#include "Triangle.h"
+#include "Vect.h"
+#include <cassert>
+
+void TriangleBatch::clear()
+{
+	for (FloatCollection& coordinates : _coordinates)
+	{
+		coordinates.clear();
+	}
+}
+
+void TriangleBatch::reserve(size_t size)
+{
+	for (FloatCollection& coordinates : _coordinates)
+	{
+		coordinates.reserve(size);
+	}
+}
+
+int TriangleBatch::add(const Triangle& triangle)
+{
+	const Vect vertices[] = { triangle.getVertex0(), triangle.getVertex1(), triangle.getVertex2() };
+	for (int vertex = 0; vertex < 3; vertex++)
+	{
+		_coordinates[vertex * 3 + 0].push_back(vertices[vertex][x]);
+		_coordinates[vertex * 3 + 1].push_back(vertices[vertex][y]);
+		_coordinates[vertex * 3 + 2].push_back(vertices[vertex][z]);
+	}
+
+	return static_cast<int>(getSize()) - 1;
+}
+
+size_t TriangleBatch::getSize() const
+{
+	return _coordinates[0].size();
+}
+
+bool TriangleBatch::isEmpty() const
+{
+	return _coordinates[0].empty();
+}
+
+const float* TriangleBatch::getCoordinates(int coordinate) const
+{
+	assert(coordinate >= 0 && coordinate < NUMBER_OF_COORDINATES);
+	return _coordinates[coordinate].data();
+}
+
+Triangle TriangleBatch::getTriangleAt(int index) const
+{
+	assert(index >= 0 && static_cast<size_t>(index) < getSize());
+	return Triangle(Vect(_coordinates[0][index], _coordinates[1][index], _coordinates[2][index]),
+		Vect(_coordinates[3][index], _coordinates[4][index], _coordinates[5][index]),
+		Vect(_coordinates[6][index], _coordinates[7][index], _coordinates[8][index]));
+}
@@ -0,0 +1,58 @@
+#ifndef _TriangleBatch
+#define _TriangleBatch
+
+#include <vector>
+#include <cstddef>
+
+class Triangle;
+
+/**********************************************************************************************//**
+ * <summary> Structure-of-arrays copy of triangles, to be tested against a box in batches by
+ *			 BatchTools::IntersectTriangles(). </summary>
+ *
+ * <remarks> Coordinates are stored one array per vertex and axis (vertex * 3 + axis, axes in
+ *			 x, y, z order) so a kernel can load the same coordinate of several triangles at once. </remarks>
+ **************************************************************************************************/
+class TriangleBatch
+{
+	typedef std::vector<float> FloatCollection;
+
+public:
+	static const int NUMBER_OF_COORDINATES = 9;
+
+public:
+	TriangleBatch() = default;
+	TriangleBatch(const TriangleBatch&) = default;
+	TriangleBatch& operator=(const TriangleBatch&) = default;
+	TriangleBatch(TriangleBatch&&) = default;
+	TriangleBatch& operator=(TriangleBatch&&) = default;
+	~TriangleBatch() = default;
+
+	void clear();
+	void reserve(size_t size);
+
+	/**********************************************************************************************//**
+	 * <summary> Appends a copy of a triangle.</summary>
+	 *
+	 * <remarks> </remarks>
+	 *
+	 * <param name="triangle"> The triangle to copy.</param>
+	 *
+	 * <returns> The index of the triangle.</returns>
+	 **************************************************************************************************/
+	int add(const Triangle& triangle);
+
+	size_t getSize() const;
+	bool isEmpty() const;
+
+	const float* getCoordinates(int coordinate) const;
+	Triangle getTriangleAt(int index) const;
+
+private:
+	FloatCollection _coordinates[NUMBER_OF_COORDINATES];
+};
+#endif // !_TriangleBatch
+
+//-----------------------------------------------------------------------------------------------------------------------------
+// TriangleBatch Comment Template
+//-----------------------------------------------------------------------------------------------------------------------------